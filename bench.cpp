@@ -0,0 +1,959 @@
+//
+// Copyright 2020 Roman Skabin
+//
+
+// @NOTE(Roman): Standalone benchmark, build it together with string.cpp from this directory.
+//               Sources include "string/string.h", so the parent directory goes on the include path:
+//                   cl /O2 /std:c++17 /I.. bench.cpp string.cpp
+//                   clang++ -O2 -std=c++17 -I.. bench.cpp string.cpp -lpthread
+//
+//               Usage: bench [max_payload_bytes] [output.csv]
+//               Payloads go from 8 bytes up to max_payload_bytes (16 MB by default, 1 GB at most).
+//               Results are CSV, one row per implementation/operation/payload/pattern.
+//               Kernels are picked by CPUID, run with STRING_ISA=scalar|sse|avx2|avx512
+//               to measure the other paths, the isa column tells which one was used.
+//               test.cpp builds the same way and cross-checks the results these operations produce.
+
+#include "string/string.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <string_view>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// @NOTE(Roman): std::string allocates through operator new, String doesn't, so this counts only the baseline.
+//               String allocations are detected by benchmarks themselves via Capacity().
+static u64 gNewCount;
+
+void *operator new(size_t bytes)
+{
+    ++gNewCount;
+    if (void *memory = malloc(bytes ? bytes : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+static volatile u64  gSink;
+static FILE         *gOutput;
+static const char   *gTempFile = "string_bench.tmp";
+
+static bool Allocated(const String& string)
+{
+    return string.Capacity() > String::SmallCapacity;
+}
+
+// @NOTE(Roman): Runs op in doubling batches until a batch took at least 50 ms,
+//               op returns number of allocations it made that gNewCount can't see.
+template<typename Op>
+static void Run(const char *impl, const char *op_name, u64 payload, const char *pattern, Op op)
+{
+    u64    iterations  = 0;
+    u64    allocations = 0;
+    u64    new_count   = 0;
+    double seconds     = 0;
+
+    for (u64 batch = 1; seconds < 0.05; batch *= 2)
+    {
+        iterations  = batch;
+        allocations = 0;
+        new_count   = gNewCount;
+
+        Clock::time_point start = Clock::now();
+
+        for (u64 i = 0; i < batch; ++i)
+        {
+            allocations += op();
+        }
+
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    allocations += gNewCount - new_count;
+
+    double ns_per_op = seconds * 1e9 / iterations;
+    double mb_per_s  = payload * iterations / seconds / (1024.0 * 1024.0);
+
+    fprintf(gOutput, "%s,%s,%s,%llu,%s,%llu,%.2f,%.2f,%.3f\n",
+            impl, op_name, String::KernelISA(), payload, pattern,
+            iterations, ns_per_op, mb_per_s, static_cast<double>(allocations) / iterations);
+    fflush(gOutput);
+}
+
+static String MakePayload(u64 length)
+{
+    String payload('\0', length);
+    char  *data = payload;
+
+    // @NOTE(Roman): Lowercase text without 'n', so needles starting with it are found only where planted.
+    for (u64 i = 0; i < length; ++i)
+    {
+        char symbol = static_cast<char>('a' + (i * 7 + i / 13) % 26);
+        data[i]     = symbol == 'n' ? ' ' : symbol;
+    }
+
+    return payload;
+}
+
+static void BenchConstruct(const String& payload)
+{
+    u64              length = payload.Length();
+    const char      *data   = payload;
+    std::string_view std_view(data, length);
+
+    Run("String", "Construct", length, "copy", [&]() -> u64
+    {
+        String copy(data, length);
+        gSink += copy.Length();
+        return Allocated(copy);
+    });
+
+    Run("std::string", "Construct", length, "copy", [&]() -> u64
+    {
+        std::string copy(std_view);
+        gSink += copy.length();
+        return 0;
+    });
+}
+
+static void BenchConcat(const String& payload)
+{
+    u64         length = payload.Length();
+    std::string std_payload(payload.Data(), length);
+
+    Run("String", "Concat", length, "string+string", [&]() -> u64
+    {
+        String result = String::Concat(payload, payload);
+        gSink += result.Length();
+        return Allocated(result);
+    });
+
+    Run("std::string", "Concat", length, "string+string", [&]() -> u64
+    {
+        std::string result = std_payload + std_payload;
+        gSink += result.length();
+        return 0;
+    });
+
+    Run("String", "Concat", length, "string+cstring", [&]() -> u64
+    {
+        String result = String::Concat(payload, "key=value");
+        gSink += result.Length();
+        return Allocated(result);
+    });
+
+    Run("std::string", "Concat", length, "string+cstring", [&]() -> u64
+    {
+        std::string result = std_payload + "key=value";
+        gSink += result.length();
+        return 0;
+    });
+
+    Run("String", "Concat", length, "a+b+c+d", [&]() -> u64
+    {
+        String result = payload + '/' + payload + "?key=value";
+        gSink += result.Length();
+        return Allocated(result);
+    });
+
+    Run("std::string", "Concat", length, "a+b+c+d", [&]() -> u64
+    {
+        std::string result = std_payload + '/' + std_payload + "?key=value";
+        gSink += result.length();
+        return 0;
+    });
+}
+
+static void BenchInsertErase(const String& payload)
+{
+    static const char chunk[]      = "0123456789ABCDEF";
+    static const u64  chunk_length = sizeof(chunk) - 1;
+
+    u64         length = payload.Length();
+    String      string(payload);
+    std::string std_string(payload.Data(), length);
+
+    const char *patterns[] = { "front", "middle", "back" };
+    u64         wheres[]   = { 0, length / 2, length };
+
+    for (u64 i = 0; i < 3; ++i)
+    {
+        u64 where = wheres[i];
+
+        Run("String", "Insert+Erase", length, patterns[i], [&]() -> u64
+        {
+            u64 capacity = string.Capacity();
+            string.Insert(where, chunk, chunk_length);
+            string.Erase(where, where + chunk_length);
+            gSink += string.Length();
+            return string.Capacity() != capacity;
+        });
+
+        Run("std::string", "Insert+Erase", length, patterns[i], [&]() -> u64
+        {
+            std_string.insert(where, chunk, chunk_length);
+            std_string.erase(where, chunk_length);
+            gSink += std_string.length();
+            return 0;
+        });
+    }
+}
+
+static void BenchPushBack(u64 length)
+{
+    Run("String", "PushBack", length, "char", [&]() -> u64
+    {
+        String string;
+        u64    capacity    = string.Capacity();
+        u64    allocations = 0;
+
+        for (u64 i = 0; i < length; ++i)
+        {
+            string.PushBack(static_cast<char>('a' + i % 26));
+
+            if (string.Capacity() != capacity)
+            {
+                capacity = string.Capacity();
+                ++allocations;
+            }
+        }
+
+        gSink += string.Length();
+        return allocations;
+    });
+
+    Run("std::string", "PushBack", length, "char", [&]() -> u64
+    {
+        std::string string;
+
+        for (u64 i = 0; i < length; ++i)
+        {
+            string.push_back(static_cast<char>('a' + i % 26));
+        }
+
+        gSink += string.length();
+        return 0;
+    });
+}
+
+// @NOTE(Roman): One number per 8 payload bytes, the way an exporter fills its buffer.
+static void BenchAppendNumber(u64 length)
+{
+    u64 count = length / 8 ? length / 8 : 1;
+
+    Run("String", "AppendInt", length, "int", [&]() -> u64
+    {
+        String string;
+        for (u64 i = 0; i < count; ++i) string.AppendInt(static_cast<s64>(i * 0x9E3779B97F4A7C15ull) >> 24).PushBack(',');
+        gSink += string.Length();
+        return Allocated(string);
+    });
+
+    Run("String", "AppendInt", length, "int (snprintf+PushBack)", [&]() -> u64
+    {
+        String string;
+        char   buffer[32];
+        for (u64 i = 0; i < count; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "%lld", static_cast<s64>(i * 0x9E3779B97F4A7C15ull) >> 24);
+            string.PushBack(buffer).PushBack(',');
+        }
+        gSink += string.Length();
+        return Allocated(string);
+    });
+
+    Run("String", "AppendDouble", length, "double", [&]() -> u64
+    {
+        String string;
+        for (u64 i = 0; i < count; ++i) string.AppendDouble(static_cast<double>(i) / 7.0 + 0.001).PushBack(',');
+        gSink += string.Length();
+        return Allocated(string);
+    });
+
+    Run("String", "AppendDouble", length, "double (snprintf+PushBack)", [&]() -> u64
+    {
+        String string;
+        char   buffer[32];
+        for (u64 i = 0; i < count; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "%.17g", static_cast<double>(i) / 7.0 + 0.001);
+            string.PushBack(buffer).PushBack(',');
+        }
+        gSink += string.Length();
+        return Allocated(string);
+    });
+}
+
+// @NOTE(Roman): Same numbers AppendNumber writes, parsed back field by field.
+static void BenchParseNumber(u64 length)
+{
+    u64    count = length / 8 ? length / 8 : 1;
+    String ints;
+    String doubles;
+
+    for (u64 i = 0; i < count; ++i)
+    {
+        ints.AppendInt(static_cast<s64>(i * 0x9E3779B97F4A7C15ull) >> 24).PushBack(',');
+        doubles.AppendDouble(static_cast<double>(i) / 7.0 + 0.001).PushBack(',');
+    }
+
+    Run("String", "ParseInt", ints.Length(), "int", [&]() -> u64
+    {
+        StringView rest = ints;
+        s64        value;
+        for (u64 used; (used = rest.ParseInt(&value)) != 0; rest = rest.SubString(used + 1, rest.Length())) gSink += value;
+        return 0;
+    });
+
+    Run("strtoll", "ParseInt", ints.Length(), "int", [&]() -> u64
+    {
+        const char *at = ints;
+        for (char *end; at < ints.Data() + ints.Length(); at = end + 1) gSink += strtoll(at, &end, 10);
+        return 0;
+    });
+
+    Run("String", "ParseDouble", doubles.Length(), "double", [&]() -> u64
+    {
+        StringView rest = doubles;
+        double     value;
+        for (u64 used; (used = rest.ParseDouble(&value)) != 0; rest = rest.SubString(used + 1, rest.Length())) gSink += static_cast<u64>(value);
+        return 0;
+    });
+
+    Run("strtod", "ParseDouble", doubles.Length(), "double", [&]() -> u64
+    {
+        const char *at = doubles;
+        for (char *end; at < doubles.Data() + doubles.Length(); at = end + 1) gSink += static_cast<u64>(strtod(at, &end));
+        return 0;
+    });
+}
+
+static void BenchFormat(const String& payload)
+{
+    u64         length = payload.Length();
+    std::string std_payload(payload.Data(), length);
+
+    Run("String", "Format", length, "log line", [&]() -> u64
+    {
+        String line = String::Format(STRING_FORMAT("GET {} took {} ms, status {}, cached {}"), payload, 12.75, 200, true);
+        gSink += line.Length();
+        return Allocated(line);
+    });
+
+    Run("String", "Format", length, "log line (Append chain)", [&]() -> u64
+    {
+        String line("GET ");
+        line.PushBack(payload).PushBack(" took ").AppendDouble(12.75).PushBack(" ms, status ").AppendInt(200).PushBack(", cached true");
+        gSink += line.Length();
+        return Allocated(line);
+    });
+
+    Run("std::string", "Format", length, "log line", [&]() -> u64
+    {
+        std::string line = "GET " + std_payload + " took " + std::to_string(12.75) + " ms, status " + std::to_string(200) + ", cached true";
+        gSink += line.length();
+        return 0;
+    });
+
+    Run("snprintf", "Format", length, "log line", [&]() -> u64
+    {
+        int    needed = snprintf(0, 0, "GET %.*s took %g ms, status %d, cached %s", static_cast<int>(length), payload.Data(), 12.75, 200, "true");
+        String line('\0', static_cast<u64>(needed));
+        snprintf(line, needed + 1, "GET %.*s took %g ms, status %d, cached %s", static_cast<int>(length), payload.Data(), 12.75, 200, "true");
+        gSink += line.Length();
+        return Allocated(line);
+    });
+}
+
+static void BenchFind(const String& payload)
+{
+    static const char needle[]      = "needle";
+    static const u64  needle_length = sizeof(needle) - 1;
+
+    u64 length = payload.Length();
+    if (length < needle_length) return;
+
+    const char *patterns[] = { "start", "middle", "end", "absent" };
+    u64         wheres[]   = { 0, (length - needle_length) / 2, length - needle_length, String::NotFound };
+    CharSet     breaks("\r\nn");
+
+    for (u64 i = 0; i < 4; ++i)
+    {
+        String haystack(payload);
+        if (wheres[i] != String::NotFound)
+        {
+            memcpy(static_cast<char *>(haystack) + wheres[i], needle, needle_length);
+        }
+
+        std::string_view std_view(haystack.Data(), length);
+
+        Run("String", "FindIndex", length, patterns[i], [&]() -> u64
+        {
+            gSink += haystack.FindIndex(StringView(needle, needle_length));
+            return 0;
+        });
+
+        Run("std::string_view", "FindIndex", length, patterns[i], [&]() -> u64
+        {
+            gSink += std_view.find(needle, 0, needle_length);
+            return 0;
+        });
+
+        Run("String", "FindIndex(char)", length, patterns[i], [&]() -> u64
+        {
+            gSink += haystack.FindIndex('n');
+            return 0;
+        });
+
+        Run("std::string_view", "FindIndex(char)", length, patterns[i], [&]() -> u64
+        {
+            gSink += std_view.find('n');
+            return 0;
+        });
+
+        Run("String", "FindIndex(set)", length, patterns[i], [&]() -> u64
+        {
+            gSink += haystack.FindIndex(breaks);
+            return 0;
+        });
+
+        Run("std::string_view", "FindIndex(set)", length, patterns[i], [&]() -> u64
+        {
+            gSink += std_view.find_first_of("\r\nn");
+            return 0;
+        });
+
+        Run("String", "Find", length, patterns[i], [&]() -> u64
+        {
+            String found = haystack.Find(needle, needle_length);
+            gSink += found.Length();
+            return Allocated(found);
+        });
+    }
+}
+
+static void BenchFindLast(const String& payload)
+{
+    static const char needle[]      = "needle";
+    static const u64  needle_length = sizeof(needle) - 1;
+
+    u64 length = payload.Length();
+    if (length < needle_length) return;
+
+    const char *patterns[] = { "start", "end", "absent" };
+    u64         wheres[]   = { 0, length - needle_length, String::NotFound };
+
+    for (u64 i = 0; i < 3; ++i)
+    {
+        String haystack(payload);
+        if (wheres[i] != String::NotFound)
+        {
+            memcpy(static_cast<char *>(haystack) + wheres[i], needle, needle_length);
+        }
+
+        std::string_view std_view(haystack.Data(), length);
+
+        Run("String", "FindLastIndex", length, patterns[i], [&]() -> u64
+        {
+            gSink += haystack.FindLastIndex(StringView(needle, needle_length));
+            return 0;
+        });
+
+        Run("std::string_view", "FindLastIndex", length, patterns[i], [&]() -> u64
+        {
+            gSink += std_view.rfind(needle, std::string_view::npos, needle_length);
+            return 0;
+        });
+
+        Run("String", "FindLastIndex(char)", length, patterns[i], [&]() -> u64
+        {
+            gSink += haystack.FindLastIndex('n');
+            return 0;
+        });
+
+        Run("std::string_view", "FindLastIndex(char)", length, patterns[i], [&]() -> u64
+        {
+            gSink += std_view.rfind('n');
+            return 0;
+        });
+    }
+}
+
+static void BenchCompare(const String& payload)
+{
+    u64 length = payload.Length();
+
+    const char *patterns[] = { "equal", "differ-first", "differ-last" };
+    u64         wheres[]   = { String::NotFound, 0, length - 1 };
+
+    for (u64 i = 0; i < 3; ++i)
+    {
+        String other(payload);
+        if (wheres[i] != String::NotFound)
+        {
+            static_cast<char *>(other)[wheres[i]] = 'Z';
+        }
+
+        std::string_view std_left(payload.Data(), length);
+        std::string_view std_right(other.Data(), length);
+
+        Run("String", "Compare", length, patterns[i], [&]() -> u64
+        {
+            gSink += payload.Compare(other);
+            return 0;
+        });
+
+        Run("std::string_view", "Compare", length, patterns[i], [&]() -> u64
+        {
+            gSink += std_left.compare(std_right);
+            return 0;
+        });
+
+        Run("String", "Compare(Lexicographic)", length, patterns[i], [&]() -> u64
+        {
+            gSink += payload.Compare(other, CompareMode::Lexicographic);
+            return 0;
+        });
+    }
+}
+
+static void BenchHash(const String& payload)
+{
+    u64              length = payload.Length();
+    std::string_view std_view(payload.Data(), length);
+
+    Run("String", "Hash", length, "bytes", [&]() -> u64
+    {
+        gSink += payload.View().Hash();
+        return 0;
+    });
+
+    Run("std::string_view", "Hash", length, "bytes", [&]() -> u64
+    {
+        gSink += std::hash<std::string_view>()(std_view);
+        return 0;
+    });
+}
+
+static void BenchSplit(const String& payload)
+{
+    u64              length = payload.Length();
+    std::string_view std_view(payload.Data(), length);
+    CharSet          blanks(" \t");
+
+    Run("String", "Split", length, "byte", [&]() -> u64
+    {
+        for (StringView piece : payload.Split(' ')) gSink += piece.Length();
+        return 0;
+    });
+
+    Run("String", "Split", length, "set", [&]() -> u64
+    {
+        for (StringView piece : payload.Split(blanks)) gSink += piece.Length();
+        return 0;
+    });
+
+    Run("std::string_view", "Split", length, "byte", [&]() -> u64
+    {
+        for (u64 start = 0;;)
+        {
+            u64 end = std_view.find(' ', start);
+            gSink += (end == std::string_view::npos ? length : end) - start;
+            if (end == std::string_view::npos) break;
+            start = end + 1;
+        }
+        return 0;
+    });
+}
+
+static void BenchFindAny(const String& payload)
+{
+    u64 length = payload.Length();
+
+    // @NOTE(Roman): Keywords end with 'n', which the payload doesn't have, so they are never found,
+    //               but their first bytes are, which is the usual case for content filters.
+    u64    seed = 1;
+    String keywords[256];
+
+    for (u64 i = 0; i < 256; ++i)
+    {
+        u64 keyword_length = 4 + i % 8;
+        for (u64 j = 0; j + 1 < keyword_length; ++j)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            char symbol = static_cast<char>('a' + (seed >> 33) % 26);
+            keywords[i].PushBack(symbol == 'n' ? 'm' : symbol);
+        }
+        keywords[i].PushBack('n');
+    }
+
+    u32         counts[] = { 16, 256 };
+    const char *names[]  = { "16 keywords", "256 keywords" };
+
+    for (u64 i = 0; i < 2; ++i)
+    {
+        PatternSet teddy;
+        PatternSet automaton;
+
+        for (u32 k = 0; k < counts[i]; ++k)
+        {
+            teddy.Add(keywords[k]);
+            automaton.Add(keywords[k]);
+        }
+
+        automaton.Compile(PatternSet::Engine::AhoCorasick);
+
+        if (counts[i] <= PatternSet::TeddyMaxPatterns)
+        {
+            teddy.Compile(PatternSet::Engine::Teddy);
+
+            Run("PatternSet", "FindAny", length, names[i], [&]() -> u64
+            {
+                gSink += teddy.FindAny(payload);
+                return 0;
+            });
+        }
+
+        Run("PatternSet(AhoCorasick)", "FindAny", length, names[i], [&]() -> u64
+        {
+            gSink += automaton.FindAny(payload);
+            return 0;
+        });
+
+        Run("String", "FindAny", length, names[i], [&]() -> u64
+        {
+            for (u32 k = 0; k < counts[i]; ++k) gSink += payload.FindIndex(keywords[k]);
+            return 0;
+        });
+    }
+}
+
+static void BenchCount(const String& payload)
+{
+    u64              length = payload.Length();
+    std::string_view std_view(payload.Data(), length);
+
+    Run("String", "Count", length, "byte", [&]() -> u64
+    {
+        gSink += payload.Count(" ");
+        return 0;
+    });
+
+    Run("String", "Count", length, "char", [&]() -> u64
+    {
+        gSink += payload.Count(' ');
+        return 0;
+    });
+
+    Run("std::string_view", "Count", length, "char", [&]() -> u64
+    {
+        gSink += std::count(std_view.begin(), std_view.end(), ' ');
+        return 0;
+    });
+
+    Run("String", "Count", length, "bytes", [&]() -> u64
+    {
+        gSink += payload.Count("bi");
+        return 0;
+    });
+
+    Run("std::string_view", "Count", length, "bytes", [&]() -> u64
+    {
+        u64 count = 0;
+        for (u64 index = std_view.find("bi"); index != std::string_view::npos; index = std_view.find("bi", index + 1)) ++count;
+        gSink += count;
+        return 0;
+    });
+}
+
+static void BenchUtf8(const String& payload)
+{
+    u64         length = payload.Length();
+    const char *text   = "ab\xC3\xB1\xE6\x97\xA5" "cd\xF0\x9F\x98\x80 xyz";
+    u64         size   = strlen(text);
+    String      mixed;
+
+    // @NOTE(Roman): Same length as the payload, but with 2, 3 and 4 byte sequences among the ASCII.
+    while (mixed.Length() + size <= length) mixed.PushBack(text, size);
+    while (mixed.Length() < length) mixed.PushBack('a');
+
+    Run("String", "IsValidUtf8", length, "ascii", [&]() -> u64
+    {
+        gSink += payload.IsValidUtf8();
+        return 0;
+    });
+
+    Run("String", "IsValidUtf8", length, "mixed", [&]() -> u64
+    {
+        gSink += mixed.IsValidUtf8();
+        return 0;
+    });
+
+    Run("String", "CountCodePoints", length, "mixed", [&]() -> u64
+    {
+        gSink += mixed.CountCodePoints();
+        return 0;
+    });
+
+    Run("String", "CodePointOffset", length, "mixed", [&]() -> u64
+    {
+        gSink += mixed.CodePointOffset(length / 2);
+        return 0;
+    });
+}
+
+static void BenchTranscode(const String& payload)
+{
+    u64    length = payload.Length();
+    String latin1 = payload;
+    char  *data   = latin1;
+
+    // @NOTE(Roman): Western European text, every 8th letter is accented.
+    for (u64 i = 7; i < length; i += 8) data[i] = static_cast<char>(0xE0 + i % 29);
+
+    String utf8;
+    utf8.AppendLatin1(latin1.Data(), latin1.Length());
+
+    u16 *utf16        = static_cast<u16 *>(malloc((length + 1) * sizeof(u16)));
+    u64  utf16_length = utf8.ToUtf16(utf16);
+
+    Run("String", "AppendLatin1", length, "latin1", [&]() -> u64
+    {
+        String out;
+        out.AppendLatin1(latin1.Data(), length);
+        gSink += out.Length();
+        return Allocated(out);
+    });
+
+    Run("String(PushBack)", "AppendLatin1", length, "latin1", [&]() -> u64
+    {
+        String out;
+        for (u64 i = 0; i < length; ++i)
+        {
+            u8 byte = static_cast<u8>(latin1[i]);
+            if (byte < 0x80)
+            {
+                out.PushBack(static_cast<char>(byte));
+            }
+            else
+            {
+                out.PushBack(static_cast<char>(0xC0 | byte >> 6));
+                out.PushBack(static_cast<char>(0x80 | (byte & 0x3F)));
+            }
+        }
+        gSink += out.Length();
+        return Allocated(out);
+    });
+
+    Run("String", "ToLatin1", utf8.Length(), "latin1", [&]() -> u64
+    {
+        gSink += utf8.ToLatin1(data);
+        return 0;
+    });
+
+    Run("String", "ToUtf16", utf8.Length(), "latin1", [&]() -> u64
+    {
+        gSink += utf8.ToUtf16(utf16);
+        return 0;
+    });
+
+    Run("String", "AppendUtf16", utf16_length * sizeof(u16), "latin1", [&]() -> u64
+    {
+        String out;
+        out.AppendUtf16(utf16, utf16_length);
+        gSink += out.Length();
+        return Allocated(out);
+    });
+
+    Run("String", "ToUtf16", length, "ascii", [&]() -> u64
+    {
+        gSink += payload.ToUtf16(utf16);
+        return 0;
+    });
+
+    free(utf16);
+}
+
+static void BenchReplace(const String& payload)
+{
+    u64         length = payload.Length();
+    std::string std_string(payload.Data(), length);
+
+    Run("String", "ReplaceAll", length, "same length", [&]() -> u64
+    {
+        String copy(payload);
+        copy.ReplaceAll(" ", "_");
+        gSink += copy.Length();
+        return Allocated(copy);
+    });
+
+    Run("String", "ReplaceAll", length, "longer", [&]() -> u64
+    {
+        String      copy(payload);
+        u64         allocations = Allocated(copy);
+        const char *before      = copy.Data();
+
+        copy.ReplaceAll(" ", "&nbsp;");
+        gSink += copy.Length();
+        return allocations + (copy.Data() != before && Allocated(copy));
+    });
+
+    // @NOTE(Roman): Moves the tail on every match, so it's quadratic and run on small payloads only.
+    if (length > 256 * 1024) return;
+
+    Run("String", "ReplaceAll", length, "longer (Find+Erase+Insert)", [&]() -> u64
+    {
+        String copy(payload);
+        for (u64 index = copy.FindIndex(' '); index != String::NotFound; index = copy.FindIndex(' ', index + 6))
+        {
+            copy.Erase(index, index + 1);
+            copy.Insert(index, "&nbsp;", 6);
+        }
+        gSink += copy.Length();
+        return 0;
+    });
+
+    Run("std::string", "ReplaceAll", length, "longer", [&]() -> u64
+    {
+        std::string copy(std_string);
+        for (u64 index = copy.find(' '); index != std::string::npos; index = copy.find(' ', index + 6))
+        {
+            copy.replace(index, 1, "&nbsp;", 6);
+        }
+        gSink += copy.length();
+        return 0;
+    });
+}
+
+static void BenchSubString(const String& payload)
+{
+    u64              length = payload.Length();
+    u64              from   = length / 4;
+    u64              to     = length - length / 4;
+    std::string      std_string(payload.Data(), length);
+    std::string_view std_view(std_string);
+
+    Run("String", "SubString", length, "copy", [&]() -> u64
+    {
+        String sub = payload.SubString(from, to);
+        gSink += sub.Length();
+        return Allocated(sub);
+    });
+
+    Run("std::string", "SubString", length, "copy", [&]() -> u64
+    {
+        std::string sub = std_string.substr(from, to - from);
+        gSink += sub.length();
+        return 0;
+    });
+
+    Run("String", "SubString", length, "view", [&]() -> u64
+    {
+        gSink += payload.View(from, to).Length();
+        return 0;
+    });
+
+    Run("std::string_view", "SubString", length, "view", [&]() -> u64
+    {
+        gSink += std_view.substr(from, to - from).length();
+        return 0;
+    });
+}
+
+static void BenchFiles(const String& payload)
+{
+    u64         length = payload.Length();
+    std::string std_string(payload.Data(), length);
+
+    Run("String", "WriteToFile", length, "binary", [&]() -> u64
+    {
+        payload.WriteToFile(gTempFile, true);
+        return 0;
+    });
+
+    Run("String", "ReadFromFile", length, "binary", [&]() -> u64
+    {
+        String string;
+        string.ReadFromFile(gTempFile, 0, true);
+        gSink += string.Length();
+        return Allocated(string);
+    });
+
+    Run("std::string", "WriteToFile", length, "binary", [&]() -> u64
+    {
+        FILE *file = fopen(gTempFile, "wb");
+        fwrite(&length, sizeof(u64), 1, file);
+        fwrite(std_string.data(), length, 1, file);
+        fclose(file);
+        return 0;
+    });
+
+    Run("std::string", "ReadFromFile", length, "binary", [&]() -> u64
+    {
+        u64   file_length = 0;
+        FILE *file        = fopen(gTempFile, "rb");
+        fread(&file_length, sizeof(u64), 1, file);
+        std::string string(file_length, '\0');
+        fread(&string[0], file_length, 1, file);
+        fclose(file);
+        gSink += string.length();
+        return 0;
+    });
+
+    remove(gTempFile);
+}
+
+int main(int argc, char **argv)
+{
+    u64 max_payload = 16ull << 20;
+
+    if (argc > 1)
+    {
+        max_payload = strtoull(argv[1], 0, 10);
+        if (max_payload > (1ull << 30)) max_payload = 1ull << 30;
+    }
+
+    gOutput = argc > 2 ? fopen(argv[2], "w") : stdout;
+    if (!gOutput) return 1;
+
+    fprintf(gOutput, "impl,op,isa,payload_bytes,pattern,iterations,ns_per_op,mb_per_s,allocs_per_op\n");
+
+    for (u64 length = 8; length <= max_payload; length *= 8)
+    {
+        String payload = MakePayload(length);
+
+        BenchConstruct(payload);
+        BenchConcat(payload);
+        BenchFormat(payload);
+        BenchInsertErase(payload);
+        BenchPushBack(length);
+        BenchAppendNumber(length);
+        BenchParseNumber(length);
+        BenchFind(payload);
+        BenchFindLast(payload);
+        BenchCompare(payload);
+        BenchHash(payload);
+        BenchSplit(payload);
+        BenchFindAny(payload);
+        BenchReplace(payload);
+        BenchCount(payload);
+        BenchUtf8(payload);
+        BenchTranscode(payload);
+        BenchSubString(payload);
+        BenchFiles(payload);
+    }
+
+    if (gOutput != stdout) fclose(gOutput);
+
+    return 0;
+}
@@ -5,38 +5,92 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "string/string.h"
-#include <intrin.h>
-#include <io.h>
+#include <locale.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #ifdef _WIN32
     #define WIN32_LEAN_AND_MEAN 1
     #define VC_EXTRALEAN        1
     #include <Windows.h>
+    #include <intrin.h>
+    #include <io.h>
+#else
+    #include <x86intrin.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #ifdef __APPLE__
+        #include <xlocale.h>
+    #endif
+
+    // @NOTE(Roman): The CRT's low-level file functions have the POSIX names here.
+    #define _write write
+    #define _read  read
 #endif
 
-#define MMX    0
+// @NOTE(Roman): Instruction sets the bulk kernels are compiled for. The one to run on is selected at run time.
+#define SCALAR 0
 #define SSE    1
-#define AVX    2
-#define AVX2   3
-#define AVX512 4
-
-#if __AVX512BW__ || __AVX512CD__ || __AVX512DQ__ || __AVX512F__ || __AVX512VL__
-    #define ISA AVX512
-#elif __AVX2__
-    #define ISA AVX2
-#elif __AVX__
-    #define ISA AVX
-#elif _M_X64 || _WIN64 || _M_IX86_FP > 0
-    #define ISA SSE
-#elif _M_IX86 || _WIN32 || _M_IX86_FP == 0
-    #define ISA MMX
+#define AVX2   2
+#define AVX512 3
+
+// @NOTE(Roman): AVX2 kernels hand their tails to the SSE ones, which are compiled without VEX encoding.
+//               They call _mm256_zeroupper first, otherwise every SSE instruction after a wide one
+//               merges the dirty upper halves, which makes short calls several times slower.
+//               GCC doesn't always insert it before a tail call, so it has to be explicit.
+#ifdef _MSC_VER
+    #define TARGET_SSE
+    #define TARGET_AVX2
+    #define TARGET_AVX512
+#else
+    #define TARGET_SSE    __attribute__((target("sse2")))
+    #define TARGET_AVX2   __attribute__((target("avx2")))
+    #define TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+// @NOTE(Roman): Growth policy for appends and inserts. When a string runs out of room
+//               its capacity is multiplied by STRING_GROWTH_NUMERATOR / STRING_GROWTH_DENOMINATOR,
+//               but grows by no more than STRING_GROWTH_MAX_STEP bytes at once (0 - unlimited).
+#ifndef STRING_GROWTH_NUMERATOR
+    #define STRING_GROWTH_NUMERATOR 3
+#endif
+
+#ifndef STRING_GROWTH_DENOMINATOR
+    #define STRING_GROWTH_DENOMINATOR 2
+#endif
+
+#ifndef STRING_GROWTH_MAX_STEP
+    #define STRING_GROWTH_MAX_STEP 0
+#endif
+
+// @NOTE(Roman): FindAll and Count split haystacks of at least STRING_PARALLEL_THRESHOLD bytes
+//               between the calling thread and STRING_WORKERS worker threads,
+//               0 threshold disables it, 0 workers means one per other hardware thread.
+#ifndef STRING_PARALLEL_THRESHOLD
+    #define STRING_PARALLEL_THRESHOLD (16ull << 20)
+#endif
+
+#ifndef STRING_WORKERS
+    #define STRING_WORKERS 0
+#endif
+
+static_assert(STRING_GROWTH_NUMERATOR > STRING_GROWTH_DENOMINATOR, "String has to grow");
+
+#ifdef _MSC_VER
+    #define NOINLINE __declspec(noinline)
 #else
-    #error Undefined ISA
+    #define NOINLINE __attribute__((noinline, cold))
 #endif
 
 typedef signed short     s16;
-typedef signed long      s32;
-typedef signed long long s64;
+typedef signed int       s32;
 
 #define _TO_CSTR(x) #x
 #define TO_CSTR(x) _TO_CSTR(x)
@@ -45,9 +99,12 @@ typedef signed long long s64;
 #define CSTRCAT(a, b) _CSTRCAT(a, b)
 
 #ifdef _DEBUG
-    #define ErrorMessage(expr) CSTRCAT(CSTRCAT(CSTRCAT("Check failed [", TO_CSTR(__FILE__)), \
-                                               CSTRCAT("(", TO_CSTR(__LINE__))),             \
-                                       CSTRCAT(")]: ", TO_CSTR(expr)))
+    // @NOTE(Roman): Adjacent literals are joined by every compiler, pasting two literals with ## only by MSVC.
+    #define ErrorMessage(expr) "Check failed [" __FILE__ "(" TO_CSTR(__LINE__) ")]: " TO_CSTR(expr)
+
+    #ifndef _MSC_VER
+        #define __debugbreak() __builtin_trap()
+    #endif
 
     #define Check(expr)       if (!(expr)) { puts(ErrorMessage(expr)); __debugbreak(); }
     #define DebugResult(expr) Check(expr)
@@ -56,54 +113,44 @@ typedef signed long long s64;
     #define DebugResult(expr) expr
 #endif
 
-static constexpr u64 Align(u64 x)
-{
-#if ISA >= AVX512
-    return ((x + (sizeof(__m512i) - 1)) & ~(sizeof(__m512i) - 1));
-#elif ISA >= AVX
-    return ((x + (sizeof(__m256i) - 1)) & ~(sizeof(__m256i) - 1));
-#elif ISA >= SSE
-    return ((x + (sizeof(__m128i) - 1)) & ~(sizeof(__m128i) - 1));
+#ifdef _MSC_VER
+    static u32 CountTrailingZeros(u32 mask)   { unsigned long index; _BitScanForward(&index, mask);   return index; }
+    static u32 CountTrailingZeros64(u64 mask) { unsigned long index; _BitScanForward64(&index, mask); return index; }
+    static u32 HighestBit(u32 mask)           { unsigned long index; _BitScanReverse(&index, mask);   return index; }
+    static u32 HighestBit64(u64 mask)         { unsigned long index; _BitScanReverse64(&index, mask); return index; }
 #else
-    return ((x + (sizeof(void *) - 1)) & ~(sizeof(void *) - 1));
+    static u32 CountTrailingZeros(u32 mask)   { return __builtin_ctz(mask);        }
+    static u32 CountTrailingZeros64(u64 mask) { return __builtin_ctzll(mask);      }
+    static u32 HighestBit(u32 mask)           { return 31 - __builtin_clz(mask);   }
+    static u32 HighestBit64(u64 mask)         { return 63 - __builtin_clzll(mask); }
 #endif
-}
 
-static constexpr void vmemset(void *dest, char val, u64 bytes)
+// @NOTE(Roman): Without the popcnt instruction, which not every x64 CPU has.
+static u32 PopCount64(u64 mask)
 {
-#if ISA >= AVX512
-    if (bytes >= sizeof(__m512i))
-    {
-        __m512i *mm512_dest = static_cast<__m512i *>(dest);
-        __m512i  mm512_val  = _mm512_set1_epi8(val);
+    mask = mask - ((mask >> 1) & 0x5555555555555555ull);
+    mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<u32>((mask * 0x0101010101010101ull) >> 56);
+}
 
-        while (bytes >= sizeof(__m512i))
-        {
-            *mm512_dest++ = mm512_val;
-            bytes -= sizeof(__m512i);
-        }
+//
+// vmemset
+//
 
-        dest = mm512_dest;
-    }
-#endif
+static void vmemset_scalar(void *dest, char val, u64 bytes)
+{
+    s8 *s8_dest = static_cast<s8 *>(dest);
 
-#if ISA >= AVX
-    if (bytes >= sizeof(__m256i))
+    while (bytes)
     {
-        __m256i *mm256_dest = static_cast<__m256i *>(dest);
-        __m256i  mm256_val  = _mm256_set1_epi8(val);
-
-        while (bytes >= sizeof(__m256i))
-        {
-            *mm256_dest++ = mm256_val;
-            bytes -= sizeof(__m256i);
-        }
-
-        dest = mm256_dest;
+        *s8_dest++ = val;
+        --bytes;
     }
-#endif
+}
 
-#if ISA >= SSE
+TARGET_SSE static void vmemset_sse(void *dest, char val, u64 bytes)
+{
     if (bytes >= sizeof(__m128i))
     {
         __m128i *mm128_dest = static_cast<__m128i *>(dest);
@@ -111,1597 +158,7905 @@ static constexpr void vmemset(void *dest, char val, u64 bytes)
 
         while (bytes >= sizeof(__m128i))
         {
-            *mm128_dest++ = mm128_val;
+            _mm_storeu_si128(mm128_dest++, mm128_val);
             bytes -= sizeof(__m128i);
         }
 
         dest = mm128_dest;
     }
-#elif ISA >= MMX
-    if (bytes >= sizeof(__m64))
-    {
-        __m64 *m64_dest = static_cast<__m64 *>(dest);
-        __m64  m64_val  = _mm_set1_pi8(val);
-
-        while (bytes >= sizeof(__m64))
-        {
-            *m64_dest++ = m64_val;
-            bytes -= sizeof(__m64);
-        }
 
-        dest = m64_dest;
-    }
-#endif
+    vmemset_scalar(dest, val, bytes);
+}
 
-    if (bytes)
+TARGET_AVX2 static void vmemset_avx2(void *dest, char val, u64 bytes)
+{
+    if (bytes >= sizeof(__m256i))
     {
-        s8 *s8_dest = static_cast<s8 *>(dest);
+        __m256i *mm256_dest = static_cast<__m256i *>(dest);
+        __m256i  mm256_val  = _mm256_set1_epi8(val);
 
-        while (bytes)
+        while (bytes >= sizeof(__m256i))
         {
-            *s8_dest++ = val;
-            --bytes;
+            _mm256_storeu_si256(mm256_dest++, mm256_val);
+            bytes -= sizeof(__m256i);
         }
+
+        dest = mm256_dest;
     }
+
+    _mm256_zeroupper();
+    vmemset_sse(dest, val, bytes);
 }
 
-static constexpr void vmemcpy(void *dest, void *src, u64 bytes)
+TARGET_AVX512 static void vmemset_avx512(void *dest, char val, u64 bytes)
 {
-#if ISA >= AVX512
     if (bytes >= sizeof(__m512i))
     {
         __m512i *mm512_dest = static_cast<__m512i *>(dest);
-        __m512i *mm512_src  = static_cast<__m512i *>(src);
+        __m512i  mm512_val  = _mm512_set1_epi8(val);
 
         while (bytes >= sizeof(__m512i))
         {
-            *mm512_dest++ = *mm512_src++;
+            _mm512_storeu_si512(mm512_dest++, mm512_val);
             bytes -= sizeof(__m512i);
         }
 
         dest = mm512_dest;
-        src  = mm512_src;
     }
-#endif
 
-#if ISA >= AVX
-    if (bytes >= sizeof(__m256i))
+    vmemset_avx2(dest, val, bytes);
+}
+
+//
+// vmemcpy
+//
+
+// @NOTE(Roman): Fixed-size memcpy calls compile to single moves, dereferencing misaligned s64 pointers is UB.
+static void vmemcpy_scalar(void *dest, const void *src, u64 bytes)
+{
+    char       *char_dest = static_cast<char *>(dest);
+    const char *char_src  = static_cast<const char *>(src);
+
+    while (bytes >= sizeof(s64))
     {
-        __m256i *mm256_dest = static_cast<__m256i *>(dest);
-        __m256i *mm256_src  = static_cast<__m256i *>(src);
+        memcpy(char_dest, char_src, sizeof(s64));
+        char_dest += sizeof(s64);
+        char_src  += sizeof(s64);
+        bytes     -= sizeof(s64);
+    }
 
-        while (bytes >= sizeof(__m256i))
-        {
-            *mm256_dest++ = *mm256_src++;
-            bytes -= sizeof(__m256i);
-        }
+    if (bytes >= 4)
+    {
+        memcpy(char_dest, char_src, 4);
+        char_dest += 4;
+        char_src  += 4;
+        bytes     -= 4;
+    }
 
-        dest = mm256_dest;
-        src  = mm256_src;
+    if (bytes >= sizeof(s16))
+    {
+        memcpy(char_dest, char_src, sizeof(s16));
+        char_dest += sizeof(s16);
+        char_src  += sizeof(s16);
+        bytes     -= sizeof(s16);
     }
-#endif
 
-#if ISA >= SSE
+    if (bytes)
+    {
+        *char_dest = *char_src;
+    }
+}
+
+TARGET_SSE static void vmemcpy_sse(void *dest, const void *src, u64 bytes)
+{
     if (bytes >= sizeof(__m128i))
     {
-        __m128i *mm128_dest = static_cast<__m128i *>(dest);
-        __m128i *mm128_src  = static_cast<__m128i *>(src);
+        __m128i       *mm128_dest = static_cast<__m128i *>(dest);
+        const __m128i *mm128_src  = static_cast<const __m128i *>(src);
 
         while (bytes >= sizeof(__m128i))
         {
-            *mm128_dest++ = *mm128_src++;
+            _mm_storeu_si128(mm128_dest++, _mm_loadu_si128(mm128_src++));
             bytes -= sizeof(__m128i);
         }
 
         dest = mm128_dest;
         src  = mm128_src;
     }
-#endif
 
-#if _M_X64 || _WIN64
-    if (bytes >= sizeof(s64))
+    vmemcpy_scalar(dest, src, bytes);
+}
+
+TARGET_AVX2 static void vmemcpy_avx2(void *dest, const void *src, u64 bytes)
+{
+    if (bytes >= sizeof(__m256i))
     {
-        s64 *s64_dest = static_cast<s64 *>(dest);
-        s64 *s64_src  = static_cast<s64 *>(src);
+        __m256i       *mm256_dest = static_cast<__m256i *>(dest);
+        const __m256i *mm256_src  = static_cast<const __m256i *>(src);
 
-        while (bytes >= sizeof(s64))
+        while (bytes >= sizeof(__m256i))
         {
-            *s64_dest++ = *s64_src++;
-            bytes -= sizeof(s64);
+            _mm256_storeu_si256(mm256_dest++, _mm256_loadu_si256(mm256_src++));
+            bytes -= sizeof(__m256i);
         }
 
-        dest = s64_dest;
-        src  = s64_src;
+        dest = mm256_dest;
+        src  = mm256_src;
     }
-#elif ISA >= MMX
-    if (bytes >= sizeof(__m64))
+
+    _mm256_zeroupper();
+    vmemcpy_sse(dest, src, bytes);
+}
+
+TARGET_AVX512 static void vmemcpy_avx512(void *dest, const void *src, u64 bytes)
+{
+    if (bytes >= sizeof(__m512i))
     {
-        __m64 *m64_dest = static_cast<__m64 *>(dest);
-        __m64 *m64_src  = static_cast<__m64 *>(src);
+        __m512i       *mm512_dest = static_cast<__m512i *>(dest);
+        const __m512i *mm512_src  = static_cast<const __m512i *>(src);
 
-        while (bytes >= sizeof(__m64))
+        while (bytes >= sizeof(__m512i))
         {
-            *m64_dest++ = *m64_src++;
-            bytes -= sizeof(__m64);
+            _mm512_storeu_si512(mm512_dest++, _mm512_loadu_si512(mm512_src++));
+            bytes -= sizeof(__m512i);
         }
 
-        dest = m64_dest;
-        src  = m64_src;
+        dest = mm512_dest;
+        src  = mm512_src;
     }
-#endif
 
-    if (bytes >= sizeof(s32))
-    {
-        s32 *s32_dest = static_cast<s32 *>(dest);
-        s32 *s32_src  = static_cast<s32 *>(src);
+    vmemcpy_avx2(dest, src, bytes);
+}
 
-        while (bytes >= sizeof(s32))
-        {
-            *s32_dest++ = *s32_src++;
-            bytes -= sizeof(s32);
-        }
+//
+// FindByte
+//
 
-        dest = s32_dest;
-        src  = s32_src;
+static u64 FindByteScalar(const char *in, u64 in_length, char symbol)
+{
+    for (u64 i = 0; i < in_length; ++i)
+    {
+        if (in[i] == symbol) return i;
     }
+    return String::NotFound;
+}
 
-    if (bytes >= sizeof(s16))
-    {
-        s16 *s16_dest = static_cast<s16 *>(dest);
-        s16 *s16_src  = static_cast<s16 *>(src);
+TARGET_SSE static u64 FindByteSSE(const char *in, u64 in_length, char symbol)
+{
+    __m128i mm128_symbol = _mm_set1_epi8(symbol);
+    u64     i            = 0;
 
-        while (bytes >= sizeof(s16))
-        {
-            *s16_dest++ = *s16_src++;
-            bytes -= sizeof(s16);
-        }
+    for (; i + sizeof(__m128i) <= in_length; i += sizeof(__m128i))
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        u32     mask  = _mm_movemask_epi8(_mm_cmpeq_epi8(block, mm128_symbol));
 
-        dest = s16_dest;
-        src  = s16_src;
+        if (mask) return i + CountTrailingZeros(mask);
     }
 
-    if (bytes)
+    u64 index = FindByteScalar(in + i, in_length - i, symbol);
+    return index != String::NotFound ? i + index : String::NotFound;
+}
+
+TARGET_AVX2 static u64 FindByteAVX2(const char *in, u64 in_length, char symbol)
+{
+    __m256i mm256_symbol = _mm256_set1_epi8(symbol);
+    u64     i            = 0;
+
+    for (; i + sizeof(__m256i) <= in_length; i += sizeof(__m256i))
     {
-        s8 *s8_dest = static_cast<s8 *>(dest);
-        s8 *s8_src  = static_cast<s8 *>(src);
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        u32     mask  = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, mm256_symbol));
 
-        while (bytes)
-        {
-            *s8_dest++ = *s8_src++;
-            --bytes;
-        }
+        if (mask) return i + CountTrailingZeros(mask);
     }
+
+    _mm256_zeroupper();
+    u64 index = FindByteSSE(in + i, in_length - i, symbol);
+    return index != String::NotFound ? i + index : String::NotFound;
 }
 
-String::String()
-    : mData(0),
-      mLength(0),
-      mCapacity(0)
+TARGET_AVX512 static u64 FindByteAVX512(const char *in, u64 in_length, char symbol)
 {
+    __m512i mm512_symbol = _mm512_set1_epi8(symbol);
+    u64     i            = 0;
+
+    for (; i + sizeof(__m512i) <= in_length; i += sizeof(__m512i))
+    {
+        __m512i block = _mm512_loadu_si512(in + i);
+        u64     mask  = _mm512_cmpeq_epi8_mask(block, mm512_symbol);
+
+        if (mask) return i + CountTrailingZeros64(mask);
+    }
+
+    u64 index = FindByteAVX2(in + i, in_length - i, symbol);
+    return index != String::NotFound ? i + index : String::NotFound;
 }
 
-String::String(u64 capacity)
-    : mData(0),
-      mLength(0),
-      mCapacity(Align(mCapacity))
+//
+// FindBytes
+//
+// @NOTE(Roman): Compares first and last bytes of the needle against a vector of positions at once
+//               and checks the middle only where both match. Needle is 2 to FIND_VECTOR_MAX_NEEDLE bytes
+//               and it's never longer than the haystack.
+//
+
+static u64 FindBytesScalar(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    mData = static_cast<char *>(calloc(1, mCapacity));
+    for (u64 i = 0; i + what_length <= in_length; ++i)
+    {
+        if (in[i] == what[0] && in[i + what_length - 1] == what[what_length - 1]
+        &&  !memcmp(in + i + 1, what + 1, what_length - 2))
+        {
+            return i;
+        }
+    }
+    return String::NotFound;
 }
 
-String::String(char symbol, u64 count)
-    : mData(0),
-      mLength(count),
-      mCapacity(0)
+TARGET_SSE static u64 FindBytesSSE(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    mCapacity = Align(mLength + 1);
-    mData     = static_cast<char *>(calloc(1, mCapacity));
-    vmemset(mData, symbol, mLength);
+    __m128i mm128_first = _mm_set1_epi8(what[0]);
+    __m128i mm128_last  = _mm_set1_epi8(what[what_length - 1]);
+    u64     i           = 0;
+
+    for (; i + what_length - 1 + sizeof(__m128i) <= in_length; i += sizeof(__m128i))
+    {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        __m128i block_last  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + what_length - 1));
+        u32     mask        = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, mm128_first),
+                                                              _mm_cmpeq_epi8(block_last,  mm128_last)));
+        while (mask)
+        {
+            u64 offset = i + CountTrailingZeros(mask);
+            if (!memcmp(in + offset + 1, what + 1, what_length - 2)) return offset;
+            mask &= mask - 1;
+        }
+    }
+
+    u64 index = FindBytesScalar(in + i, in_length - i, what, what_length);
+    return index != String::NotFound ? i + index : String::NotFound;
 }
 
-String::String(const char *cstring)
-    : mData(0),
-      mLength(strlen(cstring)),
-      mCapacity(0)
+TARGET_AVX2 static u64 FindBytesAVX2(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    mCapacity = Align(mLength + 1);
-    mData     = static_cast<char *>(calloc(1, mCapacity));
-    vmemcpy(mData, const_cast<char *>(cstring), mLength);
+    __m256i mm256_first = _mm256_set1_epi8(what[0]);
+    __m256i mm256_last  = _mm256_set1_epi8(what[what_length - 1]);
+    u64     i           = 0;
+
+    for (; i + what_length - 1 + sizeof(__m256i) <= in_length; i += sizeof(__m256i))
+    {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        __m256i block_last  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + what_length - 1));
+        u32     mask        = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, mm256_first),
+                                                                    _mm256_cmpeq_epi8(block_last,  mm256_last)));
+        while (mask)
+        {
+            u64 offset = i + CountTrailingZeros(mask);
+            if (!memcmp(in + offset + 1, what + 1, what_length - 2)) return offset;
+            mask &= mask - 1;
+        }
+    }
+
+    _mm256_zeroupper();
+    u64 index = FindBytesSSE(in + i, in_length - i, what, what_length);
+    return index != String::NotFound ? i + index : String::NotFound;
 }
 
-String::String(const char *cstring, u64 length)
-    : mData(0),
-      mLength(length),
-      mCapacity(0)
+TARGET_AVX512 static u64 FindBytesAVX512(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    mCapacity = Align(mLength + 1);
-    mData     = static_cast<char *>(calloc(1, mCapacity));
-    vmemcpy(mData, const_cast<char *>(cstring), mLength);
+    __m512i mm512_first = _mm512_set1_epi8(what[0]);
+    __m512i mm512_last  = _mm512_set1_epi8(what[what_length - 1]);
+    u64     i           = 0;
+
+    for (; i + what_length - 1 + sizeof(__m512i) <= in_length; i += sizeof(__m512i))
+    {
+        __m512i block_first = _mm512_loadu_si512(in + i);
+        __m512i block_last  = _mm512_loadu_si512(in + i + what_length - 1);
+        u64     mask        = _mm512_cmpeq_epi8_mask(block_first, mm512_first)
+                            & _mm512_cmpeq_epi8_mask(block_last,  mm512_last);
+        while (mask)
+        {
+            u64 offset = i + CountTrailingZeros64(mask);
+            if (!memcmp(in + offset + 1, what + 1, what_length - 2)) return offset;
+            mask &= mask - 1;
+        }
+    }
+
+    u64 index = FindBytesAVX2(in + i, in_length - i, what, what_length);
+    return index != String::NotFound ? i + index : String::NotFound;
 }
 
-String::String(const String& other)
-    : mData(0),
-      mLength(other.mLength),
-      mCapacity(other.mCapacity)
+//
+// FindLastByte
+//
+// @NOTE(Roman): Same as FindByte, but vectors are taken from the end and the highest set bit wins.
+//
+
+static u64 FindLastByteScalar(const char *in, u64 in_length, char symbol)
 {
-    mData = static_cast<char *>(calloc(1, mCapacity));
-    vmemcpy(mData, other.mData, mLength);
+    for (u64 i = in_length; i--;)
+    {
+        if (in[i] == symbol) return i;
+    }
+    return String::NotFound;
 }
 
-String::String(String&& other) noexcept
-    : mData(other.mData),
-      mLength(other.mLength),
-      mCapacity(other.mCapacity)
+TARGET_SSE static u64 FindLastByteSSE(const char *in, u64 in_length, char symbol)
 {
-    other.mData = 0;
+    __m128i mm128_symbol = _mm_set1_epi8(symbol);
+    u64     i            = in_length;
+
+    for (; i >= sizeof(__m128i); i -= sizeof(__m128i))
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i - sizeof(__m128i)));
+        u32     mask  = _mm_movemask_epi8(_mm_cmpeq_epi8(block, mm128_symbol));
+
+        if (mask) return i - sizeof(__m128i) + HighestBit(mask);
+    }
+
+    return FindLastByteScalar(in, i, symbol);
 }
 
-String::~String()
+TARGET_AVX2 static u64 FindLastByteAVX2(const char *in, u64 in_length, char symbol)
 {
-    if (mData)
+    __m256i mm256_symbol = _mm256_set1_epi8(symbol);
+    u64     i            = in_length;
+
+    for (; i >= sizeof(__m256i); i -= sizeof(__m256i))
     {
-        free(mData);
-        mData = 0;
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i - sizeof(__m256i)));
+        u32     mask  = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, mm256_symbol));
+
+        if (mask) return i - sizeof(__m256i) + HighestBit(mask);
     }
-    mLength   = 0;
-    mCapacity = 0;
+
+    _mm256_zeroupper();
+    return FindLastByteSSE(in, i, symbol);
 }
 
-String& String::Clear()
+TARGET_AVX512 static u64 FindLastByteAVX512(const char *in, u64 in_length, char symbol)
 {
-    vmemset(mData, '\0', mCapacity);
-    return *this;
+    __m512i mm512_symbol = _mm512_set1_epi8(symbol);
+    u64     i            = in_length;
+
+    for (; i >= sizeof(__m512i); i -= sizeof(__m512i))
+    {
+        __m512i block = _mm512_loadu_si512(in + i - sizeof(__m512i));
+        u64     mask  = _mm512_cmpeq_epi8_mask(block, mm512_symbol);
+
+        if (mask) return i - sizeof(__m512i) + HighestBit64(mask);
+    }
+
+    return FindLastByteAVX2(in, i, symbol);
 }
 
-String& String::Reserve(u64 bytes)
+//
+// FindLastBytes
+//
+// @NOTE(Roman): Same first and last byte filter as FindBytes, vectors of positions are taken from the end.
+//               i is the number of positions not checked yet. Needle is at least 2 bytes
+//               and it's never longer than the haystack. There is no backward two-way search,
+//               so long needles go through the filter too.
+//
+
+static u64 FindLastBytesScalar(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    bytes = Align(bytes);
-    if (bytes > mCapacity)
+    for (u64 i = in_length - what_length + 1; i--;)
     {
-        mCapacity = bytes;
-        mData     = static_cast<char *>(_recalloc(mData, 1, bytes));
+        if (in[i] == what[0] && in[i + what_length - 1] == what[what_length - 1]
+        &&  !memcmp(in + i + 1, what + 1, what_length - 2))
+        {
+            return i;
+        }
     }
-    return *this;
+    return String::NotFound;
 }
 
-s8 String::Compare(const String& other) const
+TARGET_SSE static u64 FindLastBytesSSE(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    if (mLength < other.mLength) return -1;
-    if (mLength > other.mLength) return  1;
-
-    const char *left  = mData;
-    const char *right = other.mData;
+    __m128i mm128_first = _mm_set1_epi8(what[0]);
+    __m128i mm128_last  = _mm_set1_epi8(what[what_length - 1]);
+    u64     i           = in_length - what_length + 1;
 
-    while (*left++ == *right++)
+    for (; i >= sizeof(__m128i); i -= sizeof(__m128i))
     {
+        const char *block       = in + i - sizeof(__m128i);
+        __m128i     block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+        __m128i     block_last  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + what_length - 1));
+        u32         mask        = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, mm128_first),
+                                                                  _mm_cmpeq_epi8(block_last,  mm128_last)));
+        while (mask)
+        {
+            u32 bit = HighestBit(mask);
+            if (!memcmp(block + bit + 1, what + 1, what_length - 2)) return i - sizeof(__m128i) + bit;
+            mask ^= 1u << bit;
+        }
     }
 
-    if (*left < *right) return -1;
-    if (*left > *right) return  1;
-    return 0;
+    return FindLastBytesScalar(in, i + what_length - 1, what, what_length);
 }
 
-s8 String::Compare(const char *cstring) const
+TARGET_AVX2 static u64 FindLastBytesAVX2(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    u64 cstring_length = strlen(cstring);
-
-    if (mLength < cstring_length) return -1;
-    if (mLength > cstring_length) return  1;
-
-    const char *left = mData;
+    __m256i mm256_first = _mm256_set1_epi8(what[0]);
+    __m256i mm256_last  = _mm256_set1_epi8(what[what_length - 1]);
+    u64     i           = in_length - what_length + 1;
 
-    while (*left++ == *cstring++)
+    for (; i >= sizeof(__m256i); i -= sizeof(__m256i))
     {
+        const char *block       = in + i - sizeof(__m256i);
+        __m256i     block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+        __m256i     block_last  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + what_length - 1));
+        u32         mask        = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, mm256_first),
+                                                                        _mm256_cmpeq_epi8(block_last,  mm256_last)));
+        while (mask)
+        {
+            u32 bit = HighestBit(mask);
+            if (!memcmp(block + bit + 1, what + 1, what_length - 2)) return i - sizeof(__m256i) + bit;
+            mask ^= 1u << bit;
+        }
     }
 
-    if (*left < *cstring) return -1;
-    if (*left > *cstring) return  1;
-    return 0;
+    _mm256_zeroupper();
+    return FindLastBytesSSE(in, i + what_length - 1, what, what_length);
 }
 
-s8 String::Compare(const char *cstring, u64 cstring_length) const
+TARGET_AVX512 static u64 FindLastBytesAVX512(const char *in, u64 in_length, const char *what, u64 what_length)
 {
-    if (mLength < cstring_length) return -1;
-    if (mLength > cstring_length) return  1;
+    __m512i mm512_first = _mm512_set1_epi8(what[0]);
+    __m512i mm512_last  = _mm512_set1_epi8(what[what_length - 1]);
+    u64     i           = in_length - what_length + 1;
 
-    const char *left = mData;
-
-    while (*left++ == *cstring++)
+    for (; i >= sizeof(__m512i); i -= sizeof(__m512i))
     {
+        const char *block       = in + i - sizeof(__m512i);
+        __m512i     block_first = _mm512_loadu_si512(block);
+        __m512i     block_last  = _mm512_loadu_si512(block + what_length - 1);
+        u64         mask        = _mm512_cmpeq_epi8_mask(block_first, mm512_first)
+                                & _mm512_cmpeq_epi8_mask(block_last,  mm512_last);
+        while (mask)
+        {
+            u32 bit = HighestBit64(mask);
+            if (!memcmp(block + bit + 1, what + 1, what_length - 2)) return i - sizeof(__m512i) + bit;
+            mask ^= 1ull << bit;
+        }
     }
 
-    if (*left < *cstring) return -1;
-    if (*left > *cstring) return  1;
-    return 0;
+    return FindLastBytesAVX2(in, i + what_length - 1, what, what_length);
 }
 
-String& String::Insert(u64 where, const String& other)
-{
-    Check(where <= mLength);
+//
+// CountByte
+//
+// @NOTE(Roman): Compare results are -1 per matching byte, subtracting them counts matches in byte lanes.
+//               Those overflow after 255 vectors, so every 255 vectors they are summed into 64-bit lanes by psadbw.
+//
 
-    u64 old_length = mLength;
-    
-    mLength += other.mLength;
+#define COUNT_BYTE_MAX_VECTORS 255
 
-    if (mLength + 1 >= mCapacity)
+static u64 CountByteScalar(const char *in, u64 in_length, char symbol)
+{
+    u64 count = 0;
+    for (u64 i = 0; i < in_length; ++i)
     {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
+        count += in[i] == symbol;
     }
-
-    memmove(mData + where + other.mLength, mData + where, old_length - where);
-    vmemcpy(mData + where, other.mData, other.mLength);
-
-    return *this;
+    return count;
 }
 
-String& String::Insert(u64 where, char symbol)
+TARGET_SSE static u64 CountByteSSE(const char *in, u64 in_length, char symbol)
 {
-    Check(where <= mLength);
+    __m128i mm128_symbol = _mm_set1_epi8(symbol);
+    __m128i total        = _mm_setzero_si128();
+    u64     vectors      = in_length / sizeof(__m128i);
 
-    u64 old_length = mLength;
+    while (vectors)
+    {
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m128i counts = _mm_setzero_si128();
 
-    mLength += 1;
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m128i))
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(block, mm128_symbol));
+        }
 
-    if (mLength + 1 >= mCapacity)
-    {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
+        total    = _mm_add_epi64(total, _mm_sad_epu8(counts, _mm_setzero_si128()));
+        vectors -= batch;
     }
 
-    memmove(mData + where + 1, mData + where, old_length - where);
-    mData[where] = symbol;
+    u64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
 
-    return *this;
+    return lanes[0] + lanes[1] + CountByteScalar(in, in_length % sizeof(__m128i), symbol);
 }
 
-String& String::Insert(u64 where, const char *cstring)
+TARGET_AVX2 static u64 CountByteAVX2(const char *in, u64 in_length, char symbol)
 {
-    Check(where <= mLength);
+    __m256i mm256_symbol = _mm256_set1_epi8(symbol);
+    __m256i total        = _mm256_setzero_si256();
+    u64     vectors      = in_length / sizeof(__m256i);
 
-    u64 old_length     = mLength;
-    u64 cstring_length = strlen(cstring);
+    while (vectors)
+    {
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m256i counts = _mm256_setzero_si256();
 
-    mLength += cstring_length;
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m256i))
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(block, mm256_symbol));
+        }
 
-    if (mLength + 1 >= mCapacity)
-    {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
+        total    = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+        vectors -= batch;
     }
 
-    memmove(mData + where + cstring_length, mData + where, old_length - where);
-    vmemcpy(mData + where, const_cast<char *>(cstring), cstring_length);
+    u64 lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
 
-    return *this;
+    _mm256_zeroupper();
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + CountByteSSE(in, in_length % sizeof(__m256i), symbol);
 }
 
-String& String::Insert(u64 where, const char *cstring, u64 cstring_length)
+TARGET_AVX512 static u64 CountByteAVX512(const char *in, u64 in_length, char symbol)
 {
-    Check(where <= mLength);
+    __m512i mm512_symbol = _mm512_set1_epi8(symbol);
+    __m512i total        = _mm512_setzero_si512();
+    u64     vectors      = in_length / sizeof(__m512i);
 
-    u64 old_length = mLength;
+    while (vectors)
+    {
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m512i counts = _mm512_setzero_si512();
 
-    mLength += cstring_length;
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m512i))
+        {
+            __mmask64 mask = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(in), mm512_symbol);
+            counts = _mm512_sub_epi8(counts, _mm512_movm_epi8(mask));
+        }
 
-    if (mLength + 1 >= mCapacity)
-    {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
+        total    = _mm512_add_epi64(total, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+        vectors -= batch;
     }
 
-    memmove(mData + where + cstring_length, mData + where, old_length - where);
-    vmemcpy(mData + where, const_cast<char *>(cstring), cstring_length);
-
-    return *this;
+    return _mm512_reduce_add_epi64(total) + CountByteAVX2(in, in_length % sizeof(__m512i), symbol);
 }
 
-String& String::Erase(u64 from, u64 to)
-{
-    Check(to > from);
-    Check(to <= mLength);
-
-    u64 old_length   = mLength;
-    u64 erase_length = to - from;
-
-    mLength -= erase_length;
+//
+// Utf8
+//
+// @NOTE(Roman): Validation follows Keiser and Lemire: the high nibble of the previous byte, its low nibble and
+//               the high nibble of the current byte each look up a 16-entry table of error classes, and a byte
+//               pair is invalid when all three lookups agree on some class. Third and fourth bytes are checked
+//               separately against the bytes two and three positions back. The lookups need pshufb, so the SSE
+//               level, which is SSE2 only, uses the scalar validator.
+//               Vector kernels only detect that a group of blocks is invalid, the scalar validator then finds
+//               the exact offset starting from the code point which crosses into that group. Errors are tested
+//               once per UTF8_GROUP_VECTORS blocks, testing every block was more than twice slower with AVX2.
+//
 
-    memmove(mData + from, mData + to, old_length - to);
-    vmemset(mData + mLength, '\0' , erase_length);
+#define UTF8_GROUP_VECTORS 4
 
-    return *this;
-}
+#define UTF8_TOO_SHORT  (1 << 0) // 11______ 0_______ or 11______ 11______
+#define UTF8_TOO_LONG   (1 << 1) // 0_______ 10______
+#define UTF8_OVERLONG_3 (1 << 2) // 11100000 100_____
+#define UTF8_TOO_LARGE  (1 << 3) // 11110100 1001____ and above
+#define UTF8_SURROGATE  (1 << 4) // 11101101 101_____
+#define UTF8_OVERLONG_2 (1 << 5) // 1100000_ 10______
+#define UTF8_LARGE_1000 (1 << 6) // 11110101 1000____ and above, also 11110000 1000____ (overlong 4)
+#define UTF8_TWO_CONTS  (1 << 7) // 10______ 10______
+#define UTF8_CARRY      (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
 
-String String::Concat(const String& left, const String& right)
+static const u8 gUtf8Byte1High[16] =
 {
-    String result;
-    result.mLength   = left.mLength + right.mLength;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,                left.mData,  left.mLength);
-    vmemcpy(result.mData + left.mLength, right.mData, right.mLength);
-    return result;
-}
-
-String String::Concat(const String& left, String&& right)
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+};
+
+static const u8 gUtf8Byte1Low[16] =
 {
-    return std::move(right.PushFront(left));
-}
-
-String String::Concat(const String& left, char right)
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_LARGE_1000,
+};
+
+static const u8 gUtf8Byte2High[16] =
 {
-    String result;
-    result.mLength   = left.mLength + 1;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, left.mData, left.mLength);
-    result.mData[left.mLength] = right;
-    return result;
-}
-
-String String::Concat(const String& left, const char *right)
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_LARGE_1000,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE  | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE  | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+};
+
+// @NOTE(Roman): Saturating subtraction of these leaves a nonzero byte where a sequence started in the last
+//               three bytes of a block needs more bytes than the block has left.
+static const u8 gUtf8Incomplete[64] =
 {
-    u64 right_length = strlen(right);
-    String result;
-    result.mLength   = left.mLength + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,                left.mData,                left.mLength);
-    vmemcpy(result.mData + left.mLength, const_cast<char *>(right), right_length);
-    return result;
-}
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
 
-String String::Concat(const String& left, const char *right, u64 right_length)
+static inline bool IsUtf8Continuation(u8 byte)
 {
-    String result;
-    result.mLength   = left.mLength + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,                left.mData,                left.mLength);
-    vmemcpy(result.mData + left.mLength, const_cast<char *>(right), right_length);
-    return result;
+    return (byte & 0xC0) == 0x80;
 }
 
-String String::Concat(String&& left, const String& right)
+// @NOTE(Roman): Returns the length of the sequence at bytes, 0 if it's invalid or cut off by the end.
+static inline u32 DecodeUtf8(const u8 *bytes, u64 left, u32 *code_point)
 {
-    return std::move(left.PushBack(right));
-}
+    u8 lead = bytes[0];
 
-String String::Concat(String&& left, char right)
-{
-    return std::move(left.PushBack(right));
-}
+    if (lead < 0x80)
+    {
+        *code_point = lead;
+        return 1;
+    }
+    else if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        if (left < 2 || !IsUtf8Continuation(bytes[1])) return 0;
 
-String String::Concat(String&& left, const char *right)
-{
-    return std::move(left.PushBack(right));
-}
+        *code_point = (lead & 0x1F) << 6 | (bytes[1] & 0x3F);
+        return 2;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        if (left < 3 || !IsUtf8Continuation(bytes[1]) || !IsUtf8Continuation(bytes[2])) return 0;
 
-String String::Concat(String&& left, const char *right, u64 right_length)
-{
-    return std::move(left.PushBack(right, right_length));
-}
+        u32 decoded = (lead & 0x0F) << 12 | (bytes[1] & 0x3F) << 6 | (bytes[2] & 0x3F);
+        if (decoded < 0x800 || (decoded >= 0xD800 && decoded <= 0xDFFF)) return 0;
 
-String String::Concat(char left, const String& right)
-{
-    String result;
-    result.mLength   = 1 + right.mLength;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    result.mData[0]  = left;
-    vmemcpy(result.mData + 1, right.mData, right.mLength);
-    return result;
-}
+        *code_point = decoded;
+        return 3;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        if (left < 4 || !IsUtf8Continuation(bytes[1]) || !IsUtf8Continuation(bytes[2]) || !IsUtf8Continuation(bytes[3])) return 0;
 
-String String::Concat(char left, String&& right)
-{
-    return std::move(right.PushFront(left));
-}
+        u32 decoded = (lead & 0x07) << 18 | (bytes[1] & 0x3F) << 12 | (bytes[2] & 0x3F) << 6 | (bytes[3] & 0x3F);
+        if (decoded < 0x10000 || decoded > 0x10FFFF) return 0;
 
-String String::Concat(char left, char right)
-{
-    String result;
-    result.mLength   = 2;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    result.mData[0]  = left;
-    result.mData[1]  = right;
-    return result;
-}
+        *code_point = decoded;
+        return 4;
+    }
 
-String String::Concat(char left, const char *right)
-{
-    u64 right_length = strlen(right);
-    String result;
-    result.mLength   = 1 + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    result.mData[0]  = left;
-    vmemcpy(result.mData + 1, const_cast<char *>(right), right_length);
-    return result;
+    return 0;
 }
 
-String String::Concat(char left, const char *right, u64 right_length)
+// @NOTE(Roman): Returns the offset of the first byte of the first invalid sequence.
+static u64 Utf8ErrorScalar(const char *in, u64 in_length)
 {
-    String result;
-    result.mLength   = 1 + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    result.mData[0]  = left;
-    vmemcpy(result.mData + 1, const_cast<char *>(right), right_length);
-    return result;
-}
+    const u8 *bytes = reinterpret_cast<const u8 *>(in);
+    u64       i     = 0;
 
-String String::Concat(const char *left, const String& right)
-{
-    u64 left_length = strlen(left);
-    String result;
-    result.mLength   = left_length + right.mLength;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,               const_cast<char *>(left), left_length);
-    vmemcpy(result.mData + left_length, right.mData,              right.mLength);
-    return result;
-}
+    while (i < in_length)
+    {
+        if (in_length - i >= sizeof(u64))
+        {
+            u64 chunk;
+            memcpy(&chunk, bytes + i, sizeof(u64));
+            if (!(chunk & 0x8080808080808080ull))
+            {
+                i += sizeof(u64);
+                continue;
+            }
+        }
 
-String String::Concat(const char *left, String&& right)
-{
-    return std::move(right.PushFront(left));
-}
+        u8  lead   = bytes[i];
+        u32 length = 1;
+        u8  low    = 0x80;
+        u8  high   = 0xBF;
 
-String String::Concat(const char *left, char right)
-{
-    u64 left_length = strlen(left);
-    String result;
-    result.mLength   = left_length + 1;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(left), left_length);
-    result.mData[left_length] = right;
-    return result;
-}
+        if (lead < 0x80)
+        {
+            ++i;
+            continue;
+        }
+        else if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            length = 2;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 3;
+            if (lead == 0xE0) low  = 0xA0;
+            if (lead == 0xED) high = 0x9F;
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 4;
+            if (lead == 0xF0) low  = 0x90;
+            if (lead == 0xF4) high = 0x8F;
+        }
+        else
+        {
+            return i;
+        }
 
-String String::Concat(const char *left, const char *right)
-{
-    u64 left_length  = strlen(left);
-    u64 right_length = strlen(right);
-    String result;
-    result.mLength   = left_length + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,               const_cast<char *>(left),  left_length);
-    vmemcpy(result.mData + left_length, const_cast<char *>(right), right_length);
-    return result;
-}
+        if (in_length - i < length)                  return i;
+        if (bytes[i + 1] < low || bytes[i + 1] > high) return i;
 
-String String::Concat(const char *left, const char *right, u64 right_length)
-{
-    u64 left_length = strlen(left);
-    String result;
-    result.mLength   = left_length + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,               const_cast<char *>(left),  left_length);
-    vmemcpy(result.mData + left_length, const_cast<char *>(right), right_length);
-    return result;
-}
+        for (u32 k = 2; k < length; ++k)
+        {
+            if (!IsUtf8Continuation(bytes[i + k])) return i;
+        }
 
-String String::Concat(const char *left, u64 left_length, const String& right)
-{
-    String result;
-    result.mLength   = left_length + right.mLength;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,               const_cast<char *>(left), left_length);
-    vmemcpy(result.mData + left_length, right.mData,              right.mLength);
-    return result;
-}
+        i += length;
+    }
 
-String String::Concat(const char *left, u64 left_length, String&& right)
-{
-    return std::move(right.PushFront(left, left_length));
+    return String::NotFound;
 }
 
-String String::Concat(const char *left, u64 left_length, char right)
+static u64 Utf8ErrorFrom(const char *in, u64 in_length, u64 block)
 {
-    String result;
-    result.mLength   = left_length + 1;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(left), left_length);
-    result.mData[left_length] = right;
-    return result;
-}
+    const u8 *bytes = reinterpret_cast<const u8 *>(in);
+    u64       start = block;
 
-String String::Concat(const char *left, u64 left_length, const char *right)
-{
-    u64 right_length = strlen(right);
-    String result;
-    result.mLength   = left_length + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,               const_cast<char *>(left),  left_length);
-    vmemcpy(result.mData + left_length, const_cast<char *>(right), right_length);
-    return result;
-}
+    // @NOTE(Roman): Blocks before this one are valid, only a sequence which crosses into it can be broken,
+    //               so the restart is the last first byte among the three bytes before the block.
+    for (u64 back = 1; back <= 3 && back <= block; ++back)
+    {
+        if (!IsUtf8Continuation(bytes[block - back]))
+        {
+            start = block - back;
+            break;
+        }
+    }
 
-String String::Concat(const char *left, u64 left_length, const char *right, u64 right_length)
-{
-    String result;
-    result.mLength   = left_length + right_length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData,               const_cast<char *>(left),  left_length);
-    vmemcpy(result.mData + left_length, const_cast<char *>(right), right_length);
-    return result;
+    u64 index = Utf8ErrorScalar(in + start, in_length - start);
+    return index == String::NotFound ? index : start + index;
 }
 
-String String::SubString(u64 from, u64 to) const &
+TARGET_AVX2 static inline __m256i Utf8BlockErrorAVX2(__m256i input, __m256i previous, const __m256i *tables)
 {
-    String result;
-    result.mLength   = to - from;
-    result.mCapacity = Align(result.mLength);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, mData + from, result.mLength);
-    return result;
+    __m256i nibble  = _mm256_set1_epi8(0x0F);
+    __m256i carried = _mm256_permute2x128_si256(previous, input, 0x21);
+    __m256i prev1   = _mm256_alignr_epi8(input, carried, 15);
+    __m256i prev2   = _mm256_alignr_epi8(input, carried, 14);
+    __m256i prev3   = _mm256_alignr_epi8(input, carried, 13);
+
+    __m256i byte_1_high = _mm256_shuffle_epi8(tables[0], _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    __m256i byte_1_low  = _mm256_shuffle_epi8(tables[1], _mm256_and_si256(prev1, nibble));
+    __m256i byte_2_high = _mm256_shuffle_epi8(tables[2], _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    __m256i special     = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    __m256i third  = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m256i must   = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm256_xor_si256(must, special);
 }
 
-String String::SubString(u64 from, u64 to) &&
+TARGET_AVX2 static u64 Utf8ErrorAVX2(const char *in, u64 in_length)
 {
-    u64 sub_len = to - from;
-    memmove(mData, mData + from, sub_len);
-    vmemset(mData + from + 1, '\0', mLength - (from + 1));
-    mLength = sub_len;
-    return std::move(*this);
-}
+    __m256i tables[3] =
+    {
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(gUtf8Byte1High))),
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(gUtf8Byte1Low))),
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(gUtf8Byte2High))),
+    };
+    __m256i incomplete = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(gUtf8Incomplete + 32));
+    __m256i previous   = _mm256_setzero_si256();
+    __m256i pending    = _mm256_setzero_si256();
+
+    // @NOTE(Roman): The tail is zero padded, zeros are ASCII and a sequence cut off by the end is caught
+    //               by them as too short. A block of zeros past the end catches it when the length is a
+    //               multiple of the vector size.
+    u64 i = 0;
+
+    for (; in_length - i >= UTF8_GROUP_VECTORS * sizeof(__m256i); i += UTF8_GROUP_VECTORS * sizeof(__m256i))
+    {
+        __m256i error = _mm256_setzero_si256();
 
-String String::SubString(const char *cstring, u64 from, u64 to)
-{
-    String result;
-    result.mLength   = to - from;
-    result.mCapacity = Align(result.mLength);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(cstring) + from, result.mLength);
-    return result;
-}
+        for (u64 k = 0; k < UTF8_GROUP_VECTORS; ++k)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + k * sizeof(__m256i)));
 
-String String::Find(const String& string) const &
-{
-    u64 offset = 0;
-    u64 length = 0;
+            if (!_mm256_movemask_epi8(input))
+            {
+                error = _mm256_or_si256(error, pending);
+            }
+            else
+            {
+                error   = _mm256_or_si256(error, Utf8BlockErrorAVX2(input, previous, tables));
+                pending = _mm256_subs_epu8(input, incomplete);
+            }
 
-    for (u64 i = 0; i < mLength; ++i)
-    {
-        if (mLength - i < string.mLength)
+            previous = input;
+        }
+
+        if (!_mm256_testz_si256(error, error))
         {
-            return std::move(String());
+            _mm256_zeroupper();
+            return Utf8ErrorFrom(in, in_length, i);
         }
+    }
+
+    for (;; i += sizeof(__m256i))
+    {
+        bool    last = in_length - i < sizeof(__m256i);
+        __m256i input;
+        __m256i error;
 
-        if (mData[i] == *string.mData)
+        if (last)
+        {
+            alignas(32) char tail[sizeof(__m256i)] = {};
+            memcpy(tail, in + i, in_length - i);
+            input = _mm256_load_si256(reinterpret_cast<const __m256i *>(tail));
+        }
+        else
         {
-            const char *this_start   = mData + i;
-            const char *string_start = string.mData;
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        }
 
-            while (*this_start++ == *string_start++)
-            {
-            }
+        if (!_mm256_movemask_epi8(input))
+        {
+            error = pending;
+        }
+        else
+        {
+            error   = Utf8BlockErrorAVX2(input, previous, tables);
+            pending = _mm256_subs_epu8(input, incomplete);
+        }
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = this_start - mData - offset;
-                break;
-            }
+        if (!_mm256_testz_si256(error, error))
+        {
+            _mm256_zeroupper();
+            return Utf8ErrorFrom(in, in_length, i);
         }
+
+        if (last) return String::NotFound;
+        previous = input;
     }
+}
 
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, mData + offset, result.mLength);
-    return result;
+TARGET_AVX512 static inline __m512i Utf8BlockErrorAVX512(__m512i input, __m512i previous, const __m512i *tables)
+{
+    __m512i nibble  = _mm512_set1_epi8(0x0F);
+    __m512i carried = _mm512_permutex2var_epi64(previous, _mm512_setr_epi64(6, 7, 8, 9, 10, 11, 12, 13), input);
+    __m512i prev1   = _mm512_alignr_epi8(input, carried, 15);
+    __m512i prev2   = _mm512_alignr_epi8(input, carried, 14);
+    __m512i prev3   = _mm512_alignr_epi8(input, carried, 13);
+
+    __m512i byte_1_high = _mm512_shuffle_epi8(tables[0], _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble));
+    __m512i byte_1_low  = _mm512_shuffle_epi8(tables[1], _mm512_and_si512(prev1, nibble));
+    __m512i byte_2_high = _mm512_shuffle_epi8(tables[2], _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble));
+    __m512i special     = _mm512_and_si512(_mm512_and_si512(byte_1_high, byte_1_low), byte_2_high);
+
+    __m512i third  = _mm512_subs_epu8(prev2, _mm512_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m512i fourth = _mm512_subs_epu8(prev3, _mm512_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m512i must   = _mm512_and_si512(_mm512_or_si512(third, fourth), _mm512_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm512_xor_si512(must, special);
 }
 
-String String::Find(const String& string) &&
+TARGET_AVX512 static u64 Utf8ErrorAVX512(const char *in, u64 in_length)
 {
-    u64 offset = 0;
-    u64 length = 0;
+    __m512i tables[3] =
+    {
+        _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(gUtf8Byte1High))),
+        _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(gUtf8Byte1Low))),
+        _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(gUtf8Byte2High))),
+    };
+    __m512i incomplete = _mm512_loadu_si512(gUtf8Incomplete);
+    __m512i previous   = _mm512_setzero_si512();
+    __m512i pending    = _mm512_setzero_si512();
 
-    for (u64 i = 0; i < mLength; ++i)
+    u64 i = 0;
+
+    for (; in_length - i >= UTF8_GROUP_VECTORS * sizeof(__m512i); i += UTF8_GROUP_VECTORS * sizeof(__m512i))
     {
-        if (mLength - i < string.mLength)
-        {
-            return std::move(String());
-        }
+        __m512i error = _mm512_setzero_si512();
 
-        if (mData[i] == *string.mData)
+        for (u64 k = 0; k < UTF8_GROUP_VECTORS; ++k)
         {
-            const char *this_start   = mData + i;
-            const char *string_start = string.mData;
+            __m512i input = _mm512_loadu_si512(in + i + k * sizeof(__m512i));
 
-            while (*this_start++ == *string_start++)
+            if (!_mm512_movepi8_mask(input))
             {
+                error = _mm512_or_si512(error, pending);
             }
-
-            if (string_start == '\0')
+            else
             {
-                offset = i;
-                length = this_start - mData - offset;
-                break;
+                error   = _mm512_or_si512(error, Utf8BlockErrorAVX512(input, previous, tables));
+                pending = _mm512_subs_epu8(input, incomplete);
             }
+
+            previous = input;
+        }
+
+        if (_mm512_test_epi8_mask(error, error))
+        {
+            _mm256_zeroupper();
+            return Utf8ErrorFrom(in, in_length, i);
         }
     }
 
-    mLength = length;
-    vmemcpy(mData, mData + offset, mLength);
-    return std::move(*this);
+    for (;; i += sizeof(__m512i))
+    {
+        bool    last = in_length - i < sizeof(__m512i);
+        __m512i input;
+        __m512i error;
+
+        if (last)
+        {
+            alignas(64) char tail[sizeof(__m512i)] = {};
+            memcpy(tail, in + i, in_length - i);
+            input = _mm512_load_si512(tail);
+        }
+        else
+        {
+            input = _mm512_loadu_si512(in + i);
+        }
+
+        if (!_mm512_movepi8_mask(input))
+        {
+            error = pending;
+        }
+        else
+        {
+            error   = Utf8BlockErrorAVX512(input, previous, tables);
+            pending = _mm512_subs_epu8(input, incomplete);
+        }
+
+        if (_mm512_test_epi8_mask(error, error))
+        {
+            _mm256_zeroupper();
+            return Utf8ErrorFrom(in, in_length, i);
+        }
+
+        if (last) return String::NotFound;
+        previous = input;
+    }
 }
 
-char String::Find(char symbol) const
+//
+// CountCodePoints
+//
+// @NOTE(Roman): Counts bytes which are not continuation bytes, 10xxxxxx is -128..-65 as a signed byte.
+//               Accumulation is the same as in CountByte.
+//
+
+static u64 CountCodePointsScalar(const char *in, u64 in_length)
 {
-    const char *it = mData;
-    while (*it && *it != symbol)
+    u64 count = 0;
+    for (u64 i = 0; i < in_length; ++i)
     {
-        ++it;
+        count += !IsUtf8Continuation(static_cast<u8>(in[i]));
     }
-    return *it;
+    return count;
 }
 
-String String::Find(const char *cstring) const &
+TARGET_SSE static u64 CountCodePointsSSE(const char *in, u64 in_length)
 {
-    u64 cstring_length = strlen(cstring);
-    u64 offset         = 0;
-    u64 length         = 0;
+    __m128i threshold = _mm_set1_epi8(-65);
+    __m128i total     = _mm_setzero_si128();
+    u64     vectors   = in_length / sizeof(__m128i);
 
-    for (u64 i = 0; i < mLength; ++i)
+    while (vectors)
     {
-        if (mLength - i < cstring_length)
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m128i counts = _mm_setzero_si128();
+
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m128i))
         {
-            return std::move(String());
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+            counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(block, threshold));
         }
 
-        if (mData[i] == *cstring)
-        {
-            const char *this_start   = mData + i;
-            const char *string_start = cstring;
+        total    = _mm_add_epi64(total, _mm_sad_epu8(counts, _mm_setzero_si128()));
+        vectors -= batch;
+    }
 
-            while (*this_start++ == *string_start++)
-            {
-            }
+    u64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = this_start - mData - offset;
-                break;
-            }
+    return lanes[0] + lanes[1] + CountCodePointsScalar(in, in_length % sizeof(__m128i));
+}
+
+TARGET_AVX2 static u64 CountCodePointsAVX2(const char *in, u64 in_length)
+{
+    __m256i threshold = _mm256_set1_epi8(-65);
+    __m256i total     = _mm256_setzero_si256();
+    u64     vectors   = in_length / sizeof(__m256i);
+
+    while (vectors)
+    {
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m256i counts = _mm256_setzero_si256();
+
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m256i))
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpgt_epi8(block, threshold));
         }
+
+        total    = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+        vectors -= batch;
     }
 
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, mData + offset, result.mLength);
-    return result;
+    u64 lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+
+    _mm256_zeroupper();
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + CountCodePointsSSE(in, in_length % sizeof(__m256i));
 }
 
-String String::Find(const char *cstring) &&
+TARGET_AVX512 static u64 CountCodePointsAVX512(const char *in, u64 in_length)
 {
-    u64 cstring_length = strlen(cstring);
-    u64 offset         = 0;
-    u64 length         = 0;
+    __m512i threshold = _mm512_set1_epi8(-65);
+    __m512i total     = _mm512_setzero_si512();
+    u64     vectors   = in_length / sizeof(__m512i);
 
-    for (u64 i = 0; i < mLength; ++i)
+    while (vectors)
     {
-        if (mLength - i < cstring_length)
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m512i counts = _mm512_setzero_si512();
+
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m512i))
         {
-            return std::move(String());
+            __mmask64 mask = _mm512_cmpgt_epi8_mask(_mm512_loadu_si512(in), threshold);
+            counts = _mm512_sub_epi8(counts, _mm512_movm_epi8(mask));
         }
 
-        if (mData[i] == *cstring)
-        {
-            const char *this_start   = mData + i;
-            const char *string_start = cstring;
+        total    = _mm512_add_epi64(total, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+        vectors -= batch;
+    }
 
-            while (*this_start++ == *string_start++)
-            {
-            }
+    return _mm512_reduce_add_epi64(total) + CountCodePointsAVX2(in, in_length % sizeof(__m512i));
+}
 
-            if (string_start == '\0')
+//
+// CountBytesAtLeast
+//
+// @NOTE(Roman): Counts bytes with unsigned values at or above the threshold, which sizes transcoding output:
+//               every Latin-1 byte from 0x80 takes two UTF-8 bytes, every UTF-8 byte from 0xF0 starts
+//               a surrogate pair. SSE2 has no unsigned compare, max(byte, threshold) == byte is one.
+//
+
+static u64 CountBytesAtLeastScalar(const char *in, u64 in_length, u8 threshold)
+{
+    u64 count = 0;
+    for (u64 i = 0; i < in_length; ++i)
+    {
+        count += static_cast<u8>(in[i]) >= threshold;
+    }
+    return count;
+}
+
+TARGET_SSE static u64 CountBytesAtLeastSSE(const char *in, u64 in_length, u8 threshold)
+{
+    __m128i mm128_threshold = _mm_set1_epi8(static_cast<char>(threshold));
+    __m128i total           = _mm_setzero_si128();
+    u64     vectors         = in_length / sizeof(__m128i);
+
+    while (vectors)
+    {
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m128i counts = _mm_setzero_si128();
+
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m128i))
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(_mm_max_epu8(block, mm128_threshold), block));
+        }
+
+        total    = _mm_add_epi64(total, _mm_sad_epu8(counts, _mm_setzero_si128()));
+        vectors -= batch;
+    }
+
+    u64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
+
+    return lanes[0] + lanes[1] + CountBytesAtLeastScalar(in, in_length % sizeof(__m128i), threshold);
+}
+
+TARGET_AVX2 static u64 CountBytesAtLeastAVX2(const char *in, u64 in_length, u8 threshold)
+{
+    __m256i mm256_threshold = _mm256_set1_epi8(static_cast<char>(threshold));
+    __m256i total           = _mm256_setzero_si256();
+    u64     vectors         = in_length / sizeof(__m256i);
+
+    while (vectors)
+    {
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m256i counts = _mm256_setzero_si256();
+
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m256i))
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(_mm256_max_epu8(block, mm256_threshold), block));
+        }
+
+        total    = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+        vectors -= batch;
+    }
+
+    u64 lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+
+    _mm256_zeroupper();
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + CountBytesAtLeastSSE(in, in_length % sizeof(__m256i), threshold);
+}
+
+TARGET_AVX512 static u64 CountBytesAtLeastAVX512(const char *in, u64 in_length, u8 threshold)
+{
+    __m512i mm512_threshold = _mm512_set1_epi8(static_cast<char>(threshold));
+    __m512i total           = _mm512_setzero_si512();
+    u64     vectors         = in_length / sizeof(__m512i);
+
+    while (vectors)
+    {
+        u64     batch  = vectors < COUNT_BYTE_MAX_VECTORS ? vectors : COUNT_BYTE_MAX_VECTORS;
+        __m512i counts = _mm512_setzero_si512();
+
+        for (u64 i = 0; i < batch; ++i, in += sizeof(__m512i))
+        {
+            __mmask64 mask = _mm512_cmpge_epu8_mask(_mm512_loadu_si512(in), mm512_threshold);
+            counts = _mm512_sub_epi8(counts, _mm512_movm_epi8(mask));
+        }
+
+        total    = _mm512_add_epi64(total, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+        vectors -= batch;
+    }
+
+    return _mm512_reduce_add_epi64(total) + CountBytesAtLeastAVX2(in, in_length % sizeof(__m512i), threshold);
+}
+
+//
+// Utf16Utf8Length
+//
+// @NOTE(Roman): Counts the UTF-8 bytes of UTF-16 units: 1 below U+0080, 2 below U+0800, 3 above and 2 for
+//               each surrogate, so a pair takes 4. Every unit adds 3 and each of the three masks takes one
+//               back, a lane grows by at most 3 per vector and psadbw sums 85 of them.
+//
+#define UTF16_UTF8_LENGTH_MAX_VECTORS (COUNT_BYTE_MAX_VECTORS / 3)
+
+static u64 Utf16Utf8LengthScalar(const u16 *in, u64 in_length)
+{
+    u64 length = 0;
+    for (u64 i = 0; i < in_length; ++i)
+    {
+        u16 unit = in[i];
+        length += 1 + (unit >= 0x80) + (unit >= 0x800) - (unit >= 0xD800 && unit <= 0xDFFF);
+    }
+    return length;
+}
+
+TARGET_SSE static u64 Utf16Utf8LengthSSE(const u16 *in, u64 in_length)
+{
+    __m128i two_bytes   = _mm_set1_epi16(static_cast<short>(0xFF80));
+    __m128i three_bytes = _mm_set1_epi16(static_cast<short>(0xF800));
+    __m128i surrogates  = _mm_set1_epi16(static_cast<short>(0xD800));
+    __m128i threes      = _mm_set1_epi16(3);
+    __m128i total       = _mm_setzero_si128();
+    u64     vectors     = in_length / 8;
+
+    while (vectors)
+    {
+        u64     batch  = vectors < UTF16_UTF8_LENGTH_MAX_VECTORS ? vectors : UTF16_UTF8_LENGTH_MAX_VECTORS;
+        __m128i counts = _mm_setzero_si128();
+
+        for (u64 i = 0; i < batch; ++i, in += 8)
+        {
+            __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+            __m128i high  = _mm_and_si128(units, three_bytes);
+            __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(units, two_bytes), _mm_setzero_si128());
+            __m128i small = _mm_cmpeq_epi16(high, _mm_setzero_si128());
+            __m128i pair  = _mm_cmpeq_epi16(high, surrogates);
+
+            counts = _mm_add_epi16(counts, _mm_add_epi16(_mm_add_epi16(ascii, small), _mm_add_epi16(pair, threes)));
+        }
+
+        total    = _mm_add_epi64(total, _mm_sad_epu8(counts, _mm_setzero_si128()));
+        vectors -= batch;
+    }
+
+    u64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
+
+    return lanes[0] + lanes[1] + Utf16Utf8LengthScalar(in, in_length % 8);
+}
+
+TARGET_AVX2 static u64 Utf16Utf8LengthAVX2(const u16 *in, u64 in_length)
+{
+    __m256i two_bytes   = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    __m256i three_bytes = _mm256_set1_epi16(static_cast<short>(0xF800));
+    __m256i surrogates  = _mm256_set1_epi16(static_cast<short>(0xD800));
+    __m256i threes      = _mm256_set1_epi16(3);
+    __m256i total       = _mm256_setzero_si256();
+    u64     vectors     = in_length / 16;
+
+    while (vectors)
+    {
+        u64     batch  = vectors < UTF16_UTF8_LENGTH_MAX_VECTORS ? vectors : UTF16_UTF8_LENGTH_MAX_VECTORS;
+        __m256i counts = _mm256_setzero_si256();
+
+        for (u64 i = 0; i < batch; ++i, in += 16)
+        {
+            __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+            __m256i high  = _mm256_and_si256(units, three_bytes);
+            __m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(units, two_bytes), _mm256_setzero_si256());
+            __m256i small = _mm256_cmpeq_epi16(high, _mm256_setzero_si256());
+            __m256i pair  = _mm256_cmpeq_epi16(high, surrogates);
+
+            counts = _mm256_add_epi16(counts, _mm256_add_epi16(_mm256_add_epi16(ascii, small), _mm256_add_epi16(pair, threes)));
+        }
+
+        total    = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+        vectors -= batch;
+    }
+
+    u64 lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+
+    _mm256_zeroupper();
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + Utf16Utf8LengthSSE(in, in_length % 16);
+}
+
+TARGET_AVX512 static u64 Utf16Utf8LengthAVX512(const u16 *in, u64 in_length)
+{
+    __m512i two_bytes   = _mm512_set1_epi16(static_cast<short>(0xFF80));
+    __m512i three_bytes = _mm512_set1_epi16(static_cast<short>(0xF800));
+    __m512i surrogates  = _mm512_set1_epi16(static_cast<short>(0xD800));
+    __m512i ones        = _mm512_set1_epi16(1);
+    __m512i threes      = _mm512_set1_epi16(3);
+    __m512i total       = _mm512_setzero_si512();
+    u64     vectors     = in_length / 32;
+
+    while (vectors)
+    {
+        u64     batch  = vectors < UTF16_UTF8_LENGTH_MAX_VECTORS ? vectors : UTF16_UTF8_LENGTH_MAX_VECTORS;
+        __m512i counts = _mm512_setzero_si512();
+
+        for (u64 i = 0; i < batch; ++i, in += 32)
+        {
+            __m512i units = _mm512_loadu_si512(in);
+            __m512i high  = _mm512_and_si512(units, three_bytes);
+
+            counts = _mm512_add_epi16(counts, threes);
+            counts = _mm512_mask_sub_epi16(counts, _mm512_testn_epi16_mask(units, two_bytes),   counts, ones);
+            counts = _mm512_mask_sub_epi16(counts, _mm512_testn_epi16_mask(units, three_bytes), counts, ones);
+            counts = _mm512_mask_sub_epi16(counts, _mm512_cmpeq_epi16_mask(high, surrogates),   counts, ones);
+        }
+
+        total    = _mm512_add_epi64(total, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+        vectors -= batch;
+    }
+
+    return _mm512_reduce_add_epi64(total) + Utf16Utf8LengthAVX2(in, in_length % 32);
+}
+
+//
+// Transcode
+//
+// @NOTE(Roman): Vector kernels convert ASCII blocks directly: bytes are widened to UTF-16 units or units
+//               narrowed back, and ASCII is the same in Latin-1 and UTF-8. With AVX2 and AVX512 blocks of
+//               ASCII and two-byte sequences, which is most European text, stay in vectors too: sequences are
+//               decoded in 16-bit lanes and pshufb packs them with 256-entry tables indexed by 8 bits of
+//               a mask, Latin-1 goes the other way by expanding every byte into a pair and dropping unused
+//               leads. Anything else goes through the scalar converters, which take every sequence starting
+//               in the block and report the offset of the first one they can't convert. SSE2 has no pshufb,
+//               so the SSE level only has the ASCII path.
+//
+
+static inline bool Utf8ToUtf16Until(const char *in, u64 in_length, u64 *at, u64 until, u16 *out, u64 *written)
+{
+    const u8 *bytes = reinterpret_cast<const u8 *>(in);
+    u64       i     = *at;
+    u64       w     = *written;
+    bool      valid = true;
+
+    while (i < until)
+    {
+        u32 code_point;
+        u32 length = DecodeUtf8(bytes + i, in_length - i, &code_point);
+
+        if (!length)
+        {
+            valid = false;
+            break;
+        }
+
+        if (code_point < 0x10000)
+        {
+            out[w++] = static_cast<u16>(code_point);
+        }
+        else
+        {
+            code_point -= 0x10000;
+            out[w++]    = static_cast<u16>(0xD800 | code_point >> 10);
+            out[w++]    = static_cast<u16>(0xDC00 | (code_point & 0x3FF));
+        }
+
+        i += length;
+    }
+
+    *at      = i;
+    *written = w;
+    return valid;
+}
+
+static inline bool Utf16ToUtf8Until(const u16 *in, u64 in_length, u64 *at, u64 until, char *out, u64 *written)
+{
+    u8  *bytes = reinterpret_cast<u8 *>(out);
+    u64  i     = *at;
+    u64  w     = *written;
+    bool valid = true;
+
+    while (i < until)
+    {
+        u32 unit = in[i];
+
+        if (unit < 0x80)
+        {
+            bytes[w++] = static_cast<u8>(unit);
+            i += 1;
+        }
+        else if (unit < 0x800)
+        {
+            bytes[w++] = static_cast<u8>(0xC0 | unit >> 6);
+            bytes[w++] = static_cast<u8>(0x80 | (unit & 0x3F));
+            i += 1;
+        }
+        else if (unit < 0xD800 || unit > 0xDFFF)
+        {
+            bytes[w++] = static_cast<u8>(0xE0 | unit >> 12);
+            bytes[w++] = static_cast<u8>(0x80 | (unit >> 6 & 0x3F));
+            bytes[w++] = static_cast<u8>(0x80 | (unit & 0x3F));
+            i += 1;
+        }
+        else if (unit <= 0xDBFF && in_length - i >= 2 && in[i + 1] >= 0xDC00 && in[i + 1] <= 0xDFFF)
+        {
+            u32 code_point = 0x10000 + ((unit - 0xD800) << 10) + (in[i + 1] - 0xDC00);
+            bytes[w++] = static_cast<u8>(0xF0 | code_point >> 18);
+            bytes[w++] = static_cast<u8>(0x80 | (code_point >> 12 & 0x3F));
+            bytes[w++] = static_cast<u8>(0x80 | (code_point >> 6 & 0x3F));
+            bytes[w++] = static_cast<u8>(0x80 | (code_point & 0x3F));
+            i += 2;
+        }
+        else
+        {
+            valid = false;
+            break;
+        }
+    }
+
+    *at      = i;
+    *written = w;
+    return valid;
+}
+
+static inline bool Utf8ToLatin1Until(const char *in, u64 in_length, u64 *at, u64 until, char *out, u64 *written)
+{
+    const u8 *bytes = reinterpret_cast<const u8 *>(in);
+    u64       i     = *at;
+    u64       w     = *written;
+    bool      valid = true;
+
+    while (i < until)
+    {
+        u32 code_point;
+        u32 length = DecodeUtf8(bytes + i, in_length - i, &code_point);
+
+        if (!length || code_point > 0xFF)
+        {
+            valid = false;
+            break;
+        }
+
+        out[w++] = static_cast<char>(code_point);
+        i       += length;
+    }
+
+    *at      = i;
+    *written = w;
+    return valid;
+}
+
+static inline u64 Latin1ToUtf8Until(const char *in, u64 from, u64 until, char *out, u64 written)
+{
+    for (u64 i = from; i < until; ++i)
+    {
+        u8 byte = static_cast<u8>(in[i]);
+
+        if (byte < 0x80)
+        {
+            out[written++] = static_cast<char>(byte);
+        }
+        else
+        {
+            out[written++] = static_cast<char>(0xC0 | byte >> 6);
+            out[written++] = static_cast<char>(0x80 | (byte & 0x3F));
+        }
+    }
+
+    return written;
+}
+
+static u64 Utf8ToUtf16Scalar(const char *in, u64 in_length, u16 *out, u64 *error)
+{
+    u64 i       = 0;
+    u64 written = 0;
+
+    *error = Utf8ToUtf16Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+static u64 Utf16ToUtf8Scalar(const u16 *in, u64 in_length, char *out, u64 *error)
+{
+    u64 i       = 0;
+    u64 written = 0;
+
+    *error = Utf16ToUtf8Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+static u64 Utf8ToLatin1Scalar(const char *in, u64 in_length, char *out, u64 *error)
+{
+    u64 i       = 0;
+    u64 written = 0;
+
+    *error = Utf8ToLatin1Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+static u64 Latin1ToUtf8Scalar(const char *in, u64 in_length, char *out)
+{
+    return Latin1ToUtf8Until(in, 0, in_length, out, 0);
+}
+
+// @NOTE(Roman): expand[mask] keeps the second byte of every pair and the first byte of pairs whose bit is set,
+//               compress_units[mask] keeps 16-bit units and compress_bytes[mask] keeps bytes whose bit is set.
+struct TranscodeTables
+{
+    u8 expand[256][16];
+    u8 compress_units[256][16];
+    u8 compress_bytes[256][16];
+    u8 bits[256];
+};
+
+static TranscodeTables BuildTranscodeTables()
+{
+    TranscodeTables tables;
+    memset(&tables, 0x80, sizeof(tables));
+
+    for (u32 mask = 0; mask < 256; ++mask)
+    {
+        u32 expanded = 0;
+        u32 units    = 0;
+        u32 bytes    = 0;
+
+        for (u32 j = 0; j < 8; ++j)
+        {
+            if (mask & (1 << j))
             {
-                offset = i;
-                length = this_start - mData - offset;
-                break;
+                tables.expand[mask][expanded++]      = static_cast<u8>(2 * j);
+                tables.compress_units[mask][units++] = static_cast<u8>(2 * j);
+                tables.compress_units[mask][units++] = static_cast<u8>(2 * j + 1);
+                tables.compress_bytes[mask][bytes++] = static_cast<u8>(j);
             }
+            tables.expand[mask][expanded++] = static_cast<u8>(2 * j + 1);
         }
+
+        tables.bits[mask] = static_cast<u8>(bytes);
     }
 
-    mLength = length;
-    vmemcpy(mData, mData + offset, mLength);
-    return std::move(*this);
+    return tables;
 }
 
-String String::Find(const char *cstring, u64 cstring_length) const &
+static const TranscodeTables& GetTranscodeTables()
 {
-    u64 offset = 0;
-    u64 length = 0;
+    static const TranscodeTables tables = BuildTranscodeTables();
+    return tables;
+}
+
+// @NOTE(Roman): Pairs are the first and the second byte of 8 two-byte sequences, the mask tells which sequences
+//               really take two bytes, the rest are just their second byte. Writes 16 bytes, returns how many
+//               of them are output, at least 8, so callers leave at least 8 more bytes of output to come.
+TARGET_AVX2 static inline u64 ExpandPairsAVX2(__m128i pairs, u32 mask, char *out, const TranscodeTables& tables)
+{
+    __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.expand[mask]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(pairs, shuffle));
+    return 8 + tables.bits[mask];
+}
+
+// @NOTE(Roman): Decodes 16 bytes of ASCII and two-byte sequences with leads up to max_lead into 16-bit units,
+//               returns false if the block has anything else. Sequences are decoded at their last byte with
+//               the byte before it, so a lead at the end of the block is left for the next one, lead tells
+//               that and the previous block's lead is read from memory, the block always advances 16 bytes.
+//               Blocks followed by 4 continuation bytes in a row are refused too: callers store whole vectors
+//               past their output, and the code points of the next 16 bytes are what tells the destination
+//               has room for that.
+TARGET_AVX2 static inline bool DecodeTwoByteBlockAVX2(const char *in, u64 at, u8 max_lead, __m128i *low, __m128i *high, u32 *keep, bool *lead)
+{
+    __m128i block     = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + at));
+    __m128i previous  = at ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + at - 1)) : _mm_slli_si128(block, 1);
+    __m128i ahead     = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + at + 16));
+    __m128i threshold = _mm_set1_epi8(-64);
+    __m128i min_lead  = _mm_set1_epi8(static_cast<char>(0xC2));
+    __m128i max_leads = _mm_set1_epi8(static_cast<char>(max_lead));
+
+    __m128i is_lead = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(block, min_lead), block),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(block, max_leads), block));
+    __m128i is_cont = _mm_cmpgt_epi8(threshold, block);
+    __m128i after   = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(previous, min_lead), previous),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(previous, max_leads), previous));
+
+    u32 ascii      = ~static_cast<u32>(_mm_movemask_epi8(block)) & 0xFFFF;
+    u32 leads      = static_cast<u32>(_mm_movemask_epi8(is_lead));
+    u32 conts      = static_cast<u32>(_mm_movemask_epi8(is_cont));
+    u32 ahead_cont = static_cast<u32>(_mm_movemask_epi8(_mm_cmpgt_epi8(threshold, ahead)));
+
+    if ((ascii | leads | conts) != 0xFFFF || conts != static_cast<u32>(_mm_movemask_epi8(after))) return false;
+    if (ahead_cont & ahead_cont >> 1 & ahead_cont >> 2 & ahead_cont >> 3)                          return false;
+
+    __m128i low_bits   = _mm_set1_epi16(0x1F);
+    __m128i trail      = _mm_set1_epi16(0x3F);
+    __m128i block_low  = _mm_cvtepu8_epi16(block);
+    __m128i block_high = _mm_cvtepu8_epi16(_mm_srli_si128(block, 8));
+    __m128i prev_low   = _mm_cvtepu8_epi16(previous);
+    __m128i prev_high  = _mm_cvtepu8_epi16(_mm_srli_si128(previous, 8));
+
+    __m128i decoded_low  = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(prev_low,  low_bits), 6), _mm_and_si128(block_low,  trail));
+    __m128i decoded_high = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(prev_high, low_bits), 6), _mm_and_si128(block_high, trail));
+
+    *low  = _mm_blendv_epi8(block_low,  decoded_low,  _mm_cvtepi8_epi16(is_cont));
+    *high = _mm_blendv_epi8(block_high, decoded_high, _mm_cvtepi8_epi16(_mm_srli_si128(is_cont, 8)));
+    *keep = ~leads & 0xFFFF;
+    *lead = leads >> 15;
+    return true;
+}
+
+TARGET_AVX2 static inline bool Utf8ToUtf16BlockAVX2(const char *in, u64 at, u16 *out, u64 *written, bool *lead, const TranscodeTables& tables)
+{
+    __m128i low;
+    __m128i high;
+    u32     keep;
+
+    if (!DecodeTwoByteBlockAVX2(in, at, 0xDF, &low, &high, &keep, lead)) return false;
+
+    u32 low_keep  = keep & 0xFF;
+    u32 high_keep = keep >> 8;
+
+    __m128i low_shuffle  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.compress_units[low_keep]));
+    __m128i high_shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.compress_units[high_keep]));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(low, low_shuffle));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + tables.bits[low_keep]), _mm_shuffle_epi8(high, high_shuffle));
+
+    *written = tables.bits[low_keep] + tables.bits[high_keep];
+    return true;
+}
+
+TARGET_AVX2 static inline bool Utf8ToLatin1BlockAVX2(const char *in, u64 at, char *out, u64 *written, bool *lead, const TranscodeTables& tables)
+{
+    __m128i low;
+    __m128i high;
+    u32     keep;
+
+    if (!DecodeTwoByteBlockAVX2(in, at, 0xC3, &low, &high, &keep, lead)) return false;
+
+    u32 low_keep  = keep & 0xFF;
+    u32 high_keep = keep >> 8;
+
+    __m128i packed       = _mm_packus_epi16(low, high);
+    __m128i low_shuffle  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.compress_bytes[low_keep]));
+    __m128i high_shuffle = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.compress_bytes[high_keep])), _mm_set1_epi8(8));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(packed, low_shuffle));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + tables.bits[low_keep]), _mm_shuffle_epi8(packed, high_shuffle));
+
+    *written = tables.bits[low_keep] + tables.bits[high_keep];
+    return true;
+}
+
+// @NOTE(Roman): 8 units below U+0800 become pairs of a lead and a trail byte, ASCII units keep only themselves.
+TARGET_AVX2 static inline bool Utf16ToUtf8BlockAVX2(const u16 *in, char *out, u64 *written, const TranscodeTables& tables)
+{
+    __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+
+    if (!_mm_testz_si128(units, _mm_set1_epi16(static_cast<short>(0xF800)))) return false;
+
+    __m128i two_bytes = _mm_cmpgt_epi16(units, _mm_set1_epi16(0x7F));
+    __m128i lead      = _mm_or_si128(_mm_srli_epi16(units, 6), _mm_set1_epi16(0xC0));
+    __m128i trail     = _mm_blendv_epi8(units, _mm_or_si128(_mm_and_si128(units, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80)), two_bytes);
+    __m128i pairs     = _mm_or_si128(lead, _mm_slli_epi16(trail, 8));
+    u32     mask      = static_cast<u32>(_mm_movemask_epi8(_mm_packs_epi16(two_bytes, two_bytes))) & 0xFF;
+
+    *written = ExpandPairsAVX2(pairs, mask, out, tables);
+    return true;
+}
+
+TARGET_AVX2 static inline u64 Latin1ToUtf8BlockAVX2(const char *in, char *out, const TranscodeTables& tables)
+{
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    u32     mask  = static_cast<u32>(_mm_movemask_epi8(block));
+    __m128i lead  = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(block, 6), _mm_set1_epi8(0x03)), _mm_set1_epi8(static_cast<char>(0xC0)));
+    __m128i trail = _mm_blendv_epi8(block, _mm_and_si128(block, _mm_set1_epi8(static_cast<char>(0xBF))), block);
+
+    u64 written = ExpandPairsAVX2(_mm_unpacklo_epi8(lead, trail), mask & 0xFF, out, tables);
+    return written + ExpandPairsAVX2(_mm_unpackhi_epi8(lead, trail), mask >> 8, out + written, tables);
+}
+
+TARGET_SSE static u64 Utf8ToUtf16SSE(const char *in, u64 in_length, u16 *out, u64 *error)
+{
+    u64 i       = 0;
+    u64 written = 0;
+
+    while (in_length - i >= sizeof(__m128i))
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+
+        if (!_mm_movemask_epi8(block))
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written),     _mm_unpacklo_epi8(block, _mm_setzero_si128()));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written + 8), _mm_unpackhi_epi8(block, _mm_setzero_si128()));
+            i       += sizeof(__m128i);
+            written += sizeof(__m128i);
+        }
+        else if (!Utf8ToUtf16Until(in, in_length, &i, i + sizeof(__m128i), out, &written))
+        {
+            *error = i;
+            return written;
+        }
+    }
+
+    *error = Utf8ToUtf16Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_AVX2 static u64 Utf8ToUtf16AVX2(const char *in, u64 in_length, u16 *out, u64 *error)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    u64  i       = 0;
+    u64  written = 0;
+    bool lead    = false;
+
+    while (in_length - i >= 2 * sizeof(__m256i))
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+
+        if (!lead && !_mm256_movemask_epi8(block))
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written),      _mm256_cvtepu8_epi16(_mm256_castsi256_si128(block)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(block, 1)));
+            i       += sizeof(__m256i);
+            written += sizeof(__m256i);
+            continue;
+        }
+
+        for (u64 end = i + sizeof(__m256i); i < end;)
+        {
+            u64 units;
+
+            if (Utf8ToUtf16BlockAVX2(in, i, out + written, &units, &lead, tables))
+            {
+                i       += sizeof(__m128i);
+                written += units;
+                continue;
+            }
+
+            // @NOTE(Roman): The lead left by the previous block is converted with its sequence.
+            i    -= lead;
+            lead  = false;
+
+            if (!Utf8ToUtf16Until(in, in_length, &i, end, out, &written))
+            {
+                *error = i;
+                return written;
+            }
+        }
+    }
+
+    i -= lead;
+    *error = Utf8ToUtf16Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_AVX512 static u64 Utf8ToUtf16AVX512(const char *in, u64 in_length, u16 *out, u64 *error)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    u64  i       = 0;
+    u64  written = 0;
+    bool lead    = false;
+
+    while (in_length - i >= 2 * sizeof(__m512i))
+    {
+        __m512i block = _mm512_loadu_si512(in + i);
+
+        if (!lead && !_mm512_movepi8_mask(block))
+        {
+            _mm512_storeu_si512(out + written,      _mm512_cvtepu8_epi16(_mm512_castsi512_si256(block)));
+            _mm512_storeu_si512(out + written + 32, _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(block, 1)));
+            i       += sizeof(__m512i);
+            written += sizeof(__m512i);
+            continue;
+        }
+
+        for (u64 end = i + sizeof(__m512i); i < end;)
+        {
+            u64 units;
+
+            if (Utf8ToUtf16BlockAVX2(in, i, out + written, &units, &lead, tables))
+            {
+                i       += sizeof(__m128i);
+                written += units;
+                continue;
+            }
+
+            // @NOTE(Roman): The lead left by the previous block is converted with its sequence.
+            i    -= lead;
+            lead  = false;
+
+            if (!Utf8ToUtf16Until(in, in_length, &i, end, out, &written))
+            {
+                *error = i;
+                return written;
+            }
+        }
+    }
+
+    i -= lead;
+    *error = Utf8ToUtf16Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_SSE static u64 Utf16ToUtf8SSE(const u16 *in, u64 in_length, char *out, u64 *error)
+{
+    __m128i non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+    u64     i         = 0;
+    u64     written   = 0;
+
+    while (in_length - i >= 2 * 8)
+    {
+        __m128i first  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 8));
+        __m128i high   = _mm_and_si128(_mm_or_si128(first, second), non_ascii);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) == 0xFFFF)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written), _mm_packus_epi16(first, second));
+            i       += 2 * 8;
+            written += 2 * 8;
+        }
+        else if (!Utf16ToUtf8Until(in, in_length, &i, i + 2 * 8, out, &written))
+        {
+            *error = i;
+            return written;
+        }
+    }
+
+    *error = Utf16ToUtf8Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_AVX2 static u64 Utf16ToUtf8AVX2(const u16 *in, u64 in_length, char *out, u64 *error)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    __m256i non_ascii = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    u64     i         = 0;
+    u64     written   = 0;
+
+    while (in_length - i >= 3 * 16)
+    {
+        __m256i first  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 16));
+
+        if (_mm256_testz_si256(_mm256_or_si256(first, second), non_ascii))
+        {
+            // @NOTE(Roman): packus works within 128-bit lanes, the permute puts the quarters back in order.
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written), packed);
+            i       += 2 * 16;
+            written += 2 * 16;
+            continue;
+        }
+
+        for (u64 end = i + 2 * 16; i < end;)
+        {
+            u64 bytes;
+
+            if (Utf16ToUtf8BlockAVX2(in + i, out + written, &bytes, tables))
+            {
+                i       += 8;
+                written += bytes;
+            }
+            else if (!Utf16ToUtf8Until(in, in_length, &i, end, out, &written))
+            {
+                *error = i;
+                return written;
+            }
+        }
+    }
+
+    *error = Utf16ToUtf8Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_AVX512 static u64 Utf16ToUtf8AVX512(const u16 *in, u64 in_length, char *out, u64 *error)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    __m512i non_ascii = _mm512_set1_epi16(static_cast<short>(0xFF80));
+    u64     i         = 0;
+    u64     written   = 0;
+
+    while (in_length - i >= 3 * 32)
+    {
+        __m512i first  = _mm512_loadu_si512(in + i);
+        __m512i second = _mm512_loadu_si512(in + i + 32);
+
+        if (!_mm512_test_epi16_mask(_mm512_or_si512(first, second), non_ascii))
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written),      _mm512_cvtepi16_epi8(first));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written + 32), _mm512_cvtepi16_epi8(second));
+            i       += 2 * 32;
+            written += 2 * 32;
+            continue;
+        }
+
+        for (u64 end = i + 2 * 32; i < end;)
+        {
+            u64 bytes;
+
+            if (Utf16ToUtf8BlockAVX2(in + i, out + written, &bytes, tables))
+            {
+                i       += 8;
+                written += bytes;
+            }
+            else if (!Utf16ToUtf8Until(in, in_length, &i, end, out, &written))
+            {
+                *error = i;
+                return written;
+            }
+        }
+    }
+
+    *error = Utf16ToUtf8Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_SSE static u64 Utf8ToLatin1SSE(const char *in, u64 in_length, char *out, u64 *error)
+{
+    u64 i       = 0;
+    u64 written = 0;
+
+    while (in_length - i >= sizeof(__m128i))
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+
+        if (!_mm_movemask_epi8(block))
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written), block);
+            i       += sizeof(__m128i);
+            written += sizeof(__m128i);
+        }
+        else if (!Utf8ToLatin1Until(in, in_length, &i, i + sizeof(__m128i), out, &written))
+        {
+            *error = i;
+            return written;
+        }
+    }
+
+    *error = Utf8ToLatin1Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_AVX2 static u64 Utf8ToLatin1AVX2(const char *in, u64 in_length, char *out, u64 *error)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    u64  i       = 0;
+    u64  written = 0;
+    bool lead    = false;
+
+    while (in_length - i >= 2 * sizeof(__m256i))
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+
+        if (!lead && !_mm256_movemask_epi8(block))
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written), block);
+            i       += sizeof(__m256i);
+            written += sizeof(__m256i);
+            continue;
+        }
+
+        for (u64 end = i + sizeof(__m256i); i < end;)
+        {
+            u64 units;
+
+            if (Utf8ToLatin1BlockAVX2(in, i, out + written, &units, &lead, tables))
+            {
+                i       += sizeof(__m128i);
+                written += units;
+                continue;
+            }
+
+            // @NOTE(Roman): The lead left by the previous block is converted with its sequence.
+            i    -= lead;
+            lead  = false;
+
+            if (!Utf8ToLatin1Until(in, in_length, &i, end, out, &written))
+            {
+                *error = i;
+                return written;
+            }
+        }
+    }
+
+    i -= lead;
+    *error = Utf8ToLatin1Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_AVX512 static u64 Utf8ToLatin1AVX512(const char *in, u64 in_length, char *out, u64 *error)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    u64  i       = 0;
+    u64  written = 0;
+    bool lead    = false;
+
+    while (in_length - i >= 2 * sizeof(__m512i))
+    {
+        __m512i block = _mm512_loadu_si512(in + i);
+
+        if (!lead && !_mm512_movepi8_mask(block))
+        {
+            _mm512_storeu_si512(out + written, block);
+            i       += sizeof(__m512i);
+            written += sizeof(__m512i);
+            continue;
+        }
+
+        for (u64 end = i + sizeof(__m512i); i < end;)
+        {
+            u64 units;
+
+            if (Utf8ToLatin1BlockAVX2(in, i, out + written, &units, &lead, tables))
+            {
+                i       += sizeof(__m128i);
+                written += units;
+                continue;
+            }
+
+            // @NOTE(Roman): The lead left by the previous block is converted with its sequence.
+            i    -= lead;
+            lead  = false;
+
+            if (!Utf8ToLatin1Until(in, in_length, &i, end, out, &written))
+            {
+                *error = i;
+                return written;
+            }
+        }
+    }
+
+    i -= lead;
+    *error = Utf8ToLatin1Until(in, in_length, &i, in_length, out, &written) ? String::NotFound : i;
+    return written;
+}
+
+TARGET_SSE static u64 Latin1ToUtf8SSE(const char *in, u64 in_length, char *out)
+{
+    u64 i       = 0;
+    u64 written = 0;
+
+    for (; in_length - i >= sizeof(__m128i); i += sizeof(__m128i))
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+
+        if (!_mm_movemask_epi8(block))
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written), block);
+            written += sizeof(__m128i);
+        }
+        else
+        {
+            written = Latin1ToUtf8Until(in, i, i + sizeof(__m128i), out, written);
+        }
+    }
+
+    return Latin1ToUtf8Until(in, i, in_length, out, written);
+}
+
+TARGET_AVX2 static u64 Latin1ToUtf8AVX2(const char *in, u64 in_length, char *out)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    u64 i       = 0;
+    u64 written = 0;
+
+    for (; in_length - i >= 2 * sizeof(__m256i); i += sizeof(__m256i))
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+
+        if (!_mm256_movemask_epi8(block))
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written), block);
+            written += sizeof(__m256i);
+        }
+        else
+        {
+            written += Latin1ToUtf8BlockAVX2(in + i,      out + written, tables);
+            written += Latin1ToUtf8BlockAVX2(in + i + 16, out + written, tables);
+        }
+    }
+
+    return Latin1ToUtf8Until(in, i, in_length, out, written);
+}
+
+TARGET_AVX512 static u64 Latin1ToUtf8AVX512(const char *in, u64 in_length, char *out)
+{
+    const TranscodeTables& tables = GetTranscodeTables();
+
+    u64 i       = 0;
+    u64 written = 0;
+
+    for (; in_length - i >= 2 * sizeof(__m512i); i += sizeof(__m512i))
+    {
+        __m512i block = _mm512_loadu_si512(in + i);
+
+        if (!_mm512_movepi8_mask(block))
+        {
+            _mm512_storeu_si512(out + written, block);
+            written += sizeof(__m512i);
+        }
+        else
+        {
+            for (u64 k = 0; k < sizeof(__m512i); k += 16)
+            {
+                written += Latin1ToUtf8BlockAVX2(in + i + k, out + written, tables);
+            }
+        }
+    }
+
+    return Latin1ToUtf8Until(in, i, in_length, out, written);
+}
+
+//
+// HashStripes
+//
+// @NOTE(Roman): Long inputs are hashed in 64-byte stripes into 8 independent 64-bit lanes
+//               (the XXH3 scheme): each lane adds the neighbour's data and the product of
+//               the low and high halves of its data xored with the secret. 32x32->64 multiplies
+//               vectorize with pmuludq, so every ISA computes exactly the same lanes.
+//               Stripe n is keyed with the secret at offset 8 * n.
+//
+
+#define HASH_STRIPE_SIZE       64
+#define HASH_STRIPES_PER_BLOCK 16
+#define HASH_SECRET_SIZE       192
+
+static const u8 gHashSecret[HASH_SECRET_SIZE] =
+{
+    0x48, 0xD0, 0x64, 0xD7, 0xF6, 0x9E, 0xB0, 0x71, 0xD0, 0xCB, 0xCA, 0xE8, 0xAA, 0x72, 0x1C, 0xB0,
+    0x84, 0x8E, 0x48, 0x7C, 0x19, 0xBF, 0x80, 0x1A, 0x63, 0x39, 0xC6, 0xA3, 0xB4, 0x8E, 0x79, 0xC9,
+    0x36, 0x15, 0xDE, 0x77, 0x71, 0x43, 0x6A, 0xE4, 0x04, 0x18, 0x86, 0xEA, 0x6A, 0x90, 0x34, 0xAD,
+    0x7F, 0xCA, 0x37, 0x7F, 0xA0, 0xB0, 0x8F, 0x43, 0xB5, 0xE7, 0x1F, 0x67, 0x9F, 0xF5, 0x69, 0x64,
+    0xC9, 0x0D, 0x52, 0xE0, 0x37, 0x68, 0x31, 0x79, 0xBF, 0x64, 0x34, 0x6B, 0x4A, 0x89, 0xAE, 0xBC,
+    0x44, 0x0C, 0x43, 0x69, 0xBC, 0x95, 0x96, 0x30, 0x7F, 0x85, 0x43, 0x07, 0xA5, 0x96, 0x8C, 0xAD,
+    0xA8, 0xF3, 0xCE, 0xEA, 0xDE, 0x8A, 0x71, 0x6A, 0x85, 0x71, 0x81, 0x53, 0xB2, 0xC3, 0xC2, 0xB0,
+    0x1B, 0x0E, 0xA1, 0x12, 0x80, 0x58, 0x3A, 0x39, 0x3A, 0x7A, 0x9E, 0x17, 0x4E, 0x62, 0x82, 0x3E,
+    0x61, 0xC3, 0xC2, 0xAD, 0x4C, 0xBD, 0xE8, 0xA4, 0xDF, 0xC9, 0xA2, 0x59, 0x2F, 0xC6, 0xE3, 0x32,
+    0xD4, 0x74, 0xF0, 0x72, 0xAA, 0xC4, 0x91, 0xDF, 0xDC, 0xEE, 0x71, 0xD1, 0x7A, 0x05, 0x39, 0x77,
+    0x18, 0x79, 0x4E, 0x48, 0x9F, 0x41, 0x9B, 0x13, 0xDF, 0xCE, 0x63, 0x0D, 0xA5, 0xE3, 0x89, 0x99,
+    0x20, 0xEF, 0x40, 0x73, 0x95, 0xA0, 0xE2, 0x9C, 0x68, 0x02, 0x46, 0x8A, 0x6D, 0x93, 0x9F, 0x35,
+};
+
+static u64 Read64(const u8 *memory)
+{
+    u64 result;
+    memcpy(&result, memory, sizeof(u64));
+    return result;
+}
+
+static u64 Read32(const u8 *memory)
+{
+    u32 result;
+    memcpy(&result, memory, sizeof(u32));
+    return result;
+}
+
+static void HashStripesScalar(u64 *acc, const u8 *in, u64 stripes, const u8 *secret)
+{
+    for (u64 n = 0; n < stripes; ++n)
+    {
+        const u8 *stripe = in     + n * HASH_STRIPE_SIZE;
+        const u8 *key    = secret + n * sizeof(u64);
+
+        for (u64 i = 0; i < 8; ++i)
+        {
+            u64 data     = Read64(stripe + i * sizeof(u64));
+            u64 data_key = data ^ Read64(key + i * sizeof(u64));
+
+            acc[i ^ 1] += data;
+            acc[i]     += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+        }
+    }
+}
+
+TARGET_SSE static void HashStripesSSE(u64 *acc, const u8 *in, u64 stripes, const u8 *secret)
+{
+    __m128i lanes[4];
+    for (u64 j = 0; j < 4; ++j) lanes[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc) + j);
+
+    for (u64 n = 0; n < stripes; ++n)
+    {
+        const __m128i *stripe = reinterpret_cast<const __m128i *>(in     + n * HASH_STRIPE_SIZE);
+        const __m128i *key    = reinterpret_cast<const __m128i *>(secret + n * sizeof(u64));
+
+        for (u64 j = 0; j < 4; ++j)
+        {
+            __m128i data     = _mm_loadu_si128(stripe + j);
+            __m128i data_key = _mm_xor_si128(data, _mm_loadu_si128(key + j));
+            __m128i product  = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+
+            lanes[j] = _mm_add_epi64(lanes[j], _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+            lanes[j] = _mm_add_epi64(lanes[j], product);
+        }
+    }
+
+    for (u64 j = 0; j < 4; ++j) _mm_storeu_si128(reinterpret_cast<__m128i *>(acc) + j, lanes[j]);
+}
+
+TARGET_AVX2 static void HashStripesAVX2(u64 *acc, const u8 *in, u64 stripes, const u8 *secret)
+{
+    __m256i lanes[2];
+    for (u64 j = 0; j < 2; ++j) lanes[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc) + j);
+
+    for (u64 n = 0; n < stripes; ++n)
+    {
+        const __m256i *stripe = reinterpret_cast<const __m256i *>(in     + n * HASH_STRIPE_SIZE);
+        const __m256i *key    = reinterpret_cast<const __m256i *>(secret + n * sizeof(u64));
+
+        for (u64 j = 0; j < 2; ++j)
+        {
+            __m256i data     = _mm256_loadu_si256(stripe + j);
+            __m256i data_key = _mm256_xor_si256(data, _mm256_loadu_si256(key + j));
+            __m256i product  = _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+
+            lanes[j] = _mm256_add_epi64(lanes[j], _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+            lanes[j] = _mm256_add_epi64(lanes[j], product);
+        }
+    }
+
+    for (u64 j = 0; j < 2; ++j) _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc) + j, lanes[j]);
+}
+
+TARGET_AVX512 static void HashStripesAVX512(u64 *acc, const u8 *in, u64 stripes, const u8 *secret)
+{
+    __m512i lanes = _mm512_loadu_si512(acc);
+
+    for (u64 n = 0; n < stripes; ++n)
+    {
+        __m512i data     = _mm512_loadu_si512(in + n * HASH_STRIPE_SIZE);
+        __m512i data_key = _mm512_xor_si512(data, _mm512_loadu_si512(secret + n * sizeof(u64)));
+        __m512i product  = _mm512_mul_epu32(data_key, _mm512_shuffle_epi32(data_key, static_cast<_MM_PERM_ENUM>(_MM_SHUFFLE(0, 3, 0, 1))));
+
+        lanes = _mm512_add_epi64(lanes, _mm512_shuffle_epi32(data, static_cast<_MM_PERM_ENUM>(_MM_SHUFFLE(1, 0, 3, 2))));
+        lanes = _mm512_add_epi64(lanes, product);
+    }
+
+    _mm512_storeu_si512(acc, lanes);
+}
+
+//
+// Mismatch
+//
+// @NOTE(Roman): Offset of the first byte where left and right differ, length if they are equal.
+//
+
+static u64 MismatchScalar(const char *left, const char *right, u64 length)
+{
+    u64 i = 0;
+
+    for (; i + sizeof(u64) <= length; i += sizeof(u64))
+    {
+        u64 difference = Read64(reinterpret_cast<const u8 *>(left  + i))
+                       ^ Read64(reinterpret_cast<const u8 *>(right + i));
+
+        if (difference) return i + CountTrailingZeros64(difference) / 8;
+    }
+
+    for (; i < length; ++i)
+    {
+        if (left[i] != right[i]) return i;
+    }
+
+    return length;
+}
+
+TARGET_SSE static u64 MismatchSSE(const char *left, const char *right, u64 length)
+{
+    u64 i = 0;
+
+    for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+    {
+        __m128i left_block  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left  + i));
+        __m128i right_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + i));
+        u32     mask        = ~_mm_movemask_epi8(_mm_cmpeq_epi8(left_block, right_block)) & 0xFFFF;
+
+        if (mask) return i + CountTrailingZeros(mask);
+    }
+
+    return i + MismatchScalar(left + i, right + i, length - i);
+}
+
+TARGET_AVX2 static u64 MismatchAVX2(const char *left, const char *right, u64 length)
+{
+    u64 i = 0;
+
+    for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i))
+    {
+        __m256i left_block  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left  + i));
+        __m256i right_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + i));
+        u32     mask        = ~static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(left_block, right_block)));
+
+        if (mask) return i + CountTrailingZeros(mask);
+    }
+
+    _mm256_zeroupper();
+    return i + MismatchSSE(left + i, right + i, length - i);
+}
+
+TARGET_AVX512 static u64 MismatchAVX512(const char *left, const char *right, u64 length)
+{
+    u64 i = 0;
+
+    for (; i + sizeof(__m512i) <= length; i += sizeof(__m512i))
+    {
+        __m512i left_block  = _mm512_loadu_si512(left  + i);
+        __m512i right_block = _mm512_loadu_si512(right + i);
+        u64     mask        = _mm512_cmpneq_epi8_mask(left_block, right_block);
+
+        if (mask) return i + CountTrailingZeros64(mask);
+    }
+
+    return i + MismatchAVX2(left + i, right + i, length - i);
+}
+
+//
+// Case
+//
+// @NOTE(Roman): ASCII only, other bytes are never changed. FlipCase xors 0x20 into bytes from first to first + 25,
+//               so first 'A' lowers and first 'a' uppers. In vector code the range check is a single
+//               signed compare: adding 128 - first moves the range to the bottom of signed bytes.
+//
+
+static char ToLowerASCII(char symbol)
+{
+    return static_cast<u8>(symbol - 'A') < 26 ? symbol ^ 0x20 : symbol;
+}
+
+static void FlipCaseScalar(char *data, u64 length, char first)
+{
+    for (u64 i = 0; i < length; ++i)
+    {
+        if (static_cast<u8>(data[i] - first) < 26) data[i] ^= 0x20;
+    }
+}
+
+TARGET_SSE static __m128i FlipCaseBlockSSE(__m128i block, __m128i bias)
+{
+    __m128i in_range = _mm_cmplt_epi8(_mm_add_epi8(block, bias), _mm_set1_epi8(-128 + 26));
+    return _mm_xor_si128(block, _mm_and_si128(in_range, _mm_set1_epi8(0x20)));
+}
+
+TARGET_AVX2 static __m256i FlipCaseBlockAVX2(__m256i block, __m256i bias)
+{
+    __m256i in_range = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), _mm256_add_epi8(block, bias));
+    return _mm256_xor_si256(block, _mm256_and_si256(in_range, _mm256_set1_epi8(0x20)));
+}
+
+TARGET_AVX512 static __m512i FlipCaseBlockAVX512(__m512i block, __m512i bias)
+{
+    __mmask64 in_range = _mm512_cmplt_epi8_mask(_mm512_add_epi8(block, bias), _mm512_set1_epi8(-128 + 26));
+    return _mm512_mask_blend_epi8(in_range, block, _mm512_xor_si512(block, _mm512_set1_epi8(0x20)));
+}
+
+TARGET_SSE static void FlipCaseSSE(char *data, u64 length, char first)
+{
+    __m128i bias = _mm_set1_epi8(static_cast<char>(128 - first));
+    u64     i    = 0;
+
+    for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+    {
+        __m128i *block = reinterpret_cast<__m128i *>(data + i);
+        _mm_storeu_si128(block, FlipCaseBlockSSE(_mm_loadu_si128(block), bias));
+    }
+
+    FlipCaseScalar(data + i, length - i, first);
+}
+
+TARGET_AVX2 static void FlipCaseAVX2(char *data, u64 length, char first)
+{
+    __m256i bias = _mm256_set1_epi8(static_cast<char>(128 - first));
+    u64     i    = 0;
+
+    for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i))
+    {
+        __m256i *block = reinterpret_cast<__m256i *>(data + i);
+        _mm256_storeu_si256(block, FlipCaseBlockAVX2(_mm256_loadu_si256(block), bias));
+    }
+
+    _mm256_zeroupper();
+    FlipCaseSSE(data + i, length - i, first);
+}
+
+TARGET_AVX512 static void FlipCaseAVX512(char *data, u64 length, char first)
+{
+    __m512i bias = _mm512_set1_epi8(static_cast<char>(128 - first));
+    u64     i    = 0;
+
+    for (; i + sizeof(__m512i) <= length; i += sizeof(__m512i))
+    {
+        _mm512_storeu_si512(data + i, FlipCaseBlockAVX512(_mm512_loadu_si512(data + i), bias));
+    }
+
+    FlipCaseAVX2(data + i, length - i, first);
+}
+
+//
+// MismatchIgnoreCase
+//
+// @NOTE(Roman): Like Mismatch, but both sides are lowered in registers before comparing.
+//
+
+static u64 MismatchIgnoreCaseScalar(const char *left, const char *right, u64 length)
+{
+    for (u64 i = 0; i < length; ++i)
+    {
+        if (ToLowerASCII(left[i]) != ToLowerASCII(right[i])) return i;
+    }
+    return length;
+}
+
+TARGET_SSE static u64 MismatchIgnoreCaseSSE(const char *left, const char *right, u64 length)
+{
+    __m128i bias = _mm_set1_epi8(static_cast<char>(128 - 'A'));
+    u64     i    = 0;
+
+    for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+    {
+        __m128i left_block  = FlipCaseBlockSSE(_mm_loadu_si128(reinterpret_cast<const __m128i *>(left  + i)), bias);
+        __m128i right_block = FlipCaseBlockSSE(_mm_loadu_si128(reinterpret_cast<const __m128i *>(right + i)), bias);
+        u32     mask        = ~_mm_movemask_epi8(_mm_cmpeq_epi8(left_block, right_block)) & 0xFFFF;
+
+        if (mask) return i + CountTrailingZeros(mask);
+    }
+
+    return i + MismatchIgnoreCaseScalar(left + i, right + i, length - i);
+}
+
+TARGET_AVX2 static u64 MismatchIgnoreCaseAVX2(const char *left, const char *right, u64 length)
+{
+    __m256i bias = _mm256_set1_epi8(static_cast<char>(128 - 'A'));
+    u64     i    = 0;
+
+    for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i))
+    {
+        __m256i left_block  = FlipCaseBlockAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(left  + i)), bias);
+        __m256i right_block = FlipCaseBlockAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + i)), bias);
+        u32     mask        = ~static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(left_block, right_block)));
+
+        if (mask) return i + CountTrailingZeros(mask);
+    }
+
+    _mm256_zeroupper();
+    return i + MismatchIgnoreCaseSSE(left + i, right + i, length - i);
+}
+
+TARGET_AVX512 static u64 MismatchIgnoreCaseAVX512(const char *left, const char *right, u64 length)
+{
+    __m512i bias = _mm512_set1_epi8(static_cast<char>(128 - 'A'));
+    u64     i    = 0;
+
+    for (; i + sizeof(__m512i) <= length; i += sizeof(__m512i))
+    {
+        __m512i left_block  = FlipCaseBlockAVX512(_mm512_loadu_si512(left  + i), bias);
+        __m512i right_block = FlipCaseBlockAVX512(_mm512_loadu_si512(right + i), bias);
+        u64     mask        = _mm512_cmpneq_epi8_mask(left_block, right_block);
+
+        if (mask) return i + CountTrailingZeros64(mask);
+    }
+
+    return i + MismatchIgnoreCaseAVX2(left + i, right + i, length - i);
+}
+
+//
+// FindBytesIgnoreCase
+//
+// @NOTE(Roman): Same first and last byte filter as FindBytes, with the haystack lowered in registers.
+//               Needle is at least 1 byte and it's never longer than the haystack.
+//
+
+static u64 FindBytesIgnoreCaseScalar(const char *in, u64 in_length, const char *what, u64 what_length)
+{
+    char first = ToLowerASCII(what[0]);
+
+    for (u64 i = 0; i + what_length <= in_length; ++i)
+    {
+        if (ToLowerASCII(in[i]) == first && MismatchIgnoreCaseScalar(in + i, what, what_length) == what_length)
+        {
+            return i;
+        }
+    }
+    return String::NotFound;
+}
+
+TARGET_SSE static u64 FindBytesIgnoreCaseSSE(const char *in, u64 in_length, const char *what, u64 what_length)
+{
+    __m128i bias     = _mm_set1_epi8(static_cast<char>(128 - 'A'));
+    __m128i mm_first = _mm_set1_epi8(ToLowerASCII(what[0]));
+    __m128i mm_last  = _mm_set1_epi8(ToLowerASCII(what[what_length - 1]));
+    u64     i        = 0;
+
+    for (; i + what_length - 1 + sizeof(__m128i) <= in_length; i += sizeof(__m128i))
+    {
+        __m128i block_first = FlipCaseBlockSSE(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)),                   bias);
+        __m128i block_last  = FlipCaseBlockSSE(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + what_length - 1)), bias);
+        u32     mask        = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, mm_first),
+                                                              _mm_cmpeq_epi8(block_last,  mm_last)));
+        while (mask)
+        {
+            u64 offset = i + CountTrailingZeros(mask);
+            if (MismatchIgnoreCaseSSE(in + offset, what, what_length) == what_length) return offset;
+            mask &= mask - 1;
+        }
+    }
+
+    u64 index = FindBytesIgnoreCaseScalar(in + i, in_length - i, what, what_length);
+    return index != String::NotFound ? i + index : String::NotFound;
+}
+
+TARGET_AVX2 static u64 FindBytesIgnoreCaseAVX2(const char *in, u64 in_length, const char *what, u64 what_length)
+{
+    __m256i bias        = _mm256_set1_epi8(static_cast<char>(128 - 'A'));
+    __m256i mm256_first = _mm256_set1_epi8(ToLowerASCII(what[0]));
+    __m256i mm256_last  = _mm256_set1_epi8(ToLowerASCII(what[what_length - 1]));
+    u64     i           = 0;
+
+    for (; i + what_length - 1 + sizeof(__m256i) <= in_length; i += sizeof(__m256i))
+    {
+        __m256i block_first = FlipCaseBlockAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i)),                   bias);
+        __m256i block_last  = FlipCaseBlockAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + what_length - 1)), bias);
+        u32     mask        = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, mm256_first),
+                                                                    _mm256_cmpeq_epi8(block_last,  mm256_last)));
+        while (mask)
+        {
+            u64 offset = i + CountTrailingZeros(mask);
+            if (MismatchIgnoreCaseAVX2(in + offset, what, what_length) == what_length) return offset;
+            mask &= mask - 1;
+        }
+    }
+
+    _mm256_zeroupper();
+    u64 index = FindBytesIgnoreCaseSSE(in + i, in_length - i, what, what_length);
+    return index != String::NotFound ? i + index : String::NotFound;
+}
+
+TARGET_AVX512 static u64 FindBytesIgnoreCaseAVX512(const char *in, u64 in_length, const char *what, u64 what_length)
+{
+    __m512i bias        = _mm512_set1_epi8(static_cast<char>(128 - 'A'));
+    __m512i mm512_first = _mm512_set1_epi8(ToLowerASCII(what[0]));
+    __m512i mm512_last  = _mm512_set1_epi8(ToLowerASCII(what[what_length - 1]));
+    u64     i           = 0;
+
+    for (; i + what_length - 1 + sizeof(__m512i) <= in_length; i += sizeof(__m512i))
+    {
+        __m512i block_first = FlipCaseBlockAVX512(_mm512_loadu_si512(in + i),                   bias);
+        __m512i block_last  = FlipCaseBlockAVX512(_mm512_loadu_si512(in + i + what_length - 1), bias);
+        u64     mask        = _mm512_cmpeq_epi8_mask(block_first, mm512_first)
+                            & _mm512_cmpeq_epi8_mask(block_last,  mm512_last);
+        while (mask)
+        {
+            u64 offset = i + CountTrailingZeros64(mask);
+            if (MismatchIgnoreCaseAVX512(in + offset, what, what_length) == what_length) return offset;
+            mask &= mask - 1;
+        }
+    }
+
+    u64 index = FindBytesIgnoreCaseAVX2(in + i, in_length - i, what, what_length);
+    return index != String::NotFound ? i + index : String::NotFound;
+}
+
+//
+// MatchMask
+//
+// @NOTE(Roman): Bit i of the result is set if byte i of the 64-byte block is the symbol or belongs to the set.
+//               Set tables are the ones CharSet keeps. SSE2 has no byte shuffle, so sets use the scalar version there.
+//
+
+static u64 MatchByteMaskScalar(const char *block, char symbol)
+{
+    u64 mask = 0;
+    for (u64 i = 0; i < 64; ++i)
+    {
+        mask |= static_cast<u64>(block[i] == symbol) << i;
+    }
+    return mask;
+}
+
+TARGET_SSE static u64 MatchByteMaskSSE(const char *block, char symbol)
+{
+    __m128i mm_symbol = _mm_set1_epi8(symbol);
+    u64     mask      = 0;
+
+    for (u64 i = 0; i < 64; i += sizeof(__m128i))
+    {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        mask |= static_cast<u64>(_mm_movemask_epi8(_mm_cmpeq_epi8(data, mm_symbol))) << i;
+    }
+
+    return mask;
+}
+
+TARGET_AVX2 static u64 MatchByteMaskAVX2(const char *block, char symbol)
+{
+    __m256i mm256_symbol = _mm256_set1_epi8(symbol);
+    __m256i low          = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    __m256i high         = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+
+    return static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, mm256_symbol)))
+         | static_cast<u64>(static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, mm256_symbol)))) << 32;
+}
+
+TARGET_AVX512 static u64 MatchByteMaskAVX512(const char *block, char symbol)
+{
+    return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(block), _mm512_set1_epi8(symbol));
+}
+
+static u64 MatchSetMaskScalar(const char *block, const u8 *tables)
+{
+    u64 mask = 0;
+    for (u64 i = 0; i < 64; ++i)
+    {
+        u8 byte = static_cast<u8>(block[i]);
+        mask |= static_cast<u64>((tables[(byte >> 7) * 16 + (byte & 0x0F)] >> ((byte >> 4) & 7)) & 1) << i;
+    }
+    return mask;
+}
+
+TARGET_AVX2 static u64 MatchSetMaskAVX2(const char *block, const u8 *tables)
+{
+    __m256i tables_low  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables)));
+    __m256i tables_high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables + 16)));
+    __m256i bits        = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                           1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m256i nibble      = _mm256_set1_epi8(0x0F);
+    u64     mask        = 0;
+
+    for (u64 i = 0; i < 64; i += sizeof(__m256i))
+    {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+        __m256i low  = _mm256_and_si256(data, nibble);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(data, 4), nibble);
+
+        // @NOTE(Roman): Sign bit of the byte is the top bit of the high nibble, it picks the table.
+        __m256i row  = _mm256_blendv_epi8(_mm256_shuffle_epi8(tables_low, low), _mm256_shuffle_epi8(tables_high, low), data);
+        __m256i hit  = _mm256_and_si256(row, _mm256_shuffle_epi8(bits, high));
+        u32     miss = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hit, _mm256_setzero_si256())));
+
+        mask |= static_cast<u64>(~miss) << i;
+    }
+
+    return mask;
+}
+
+TARGET_AVX512 static u64 MatchSetMaskAVX512(const char *block, const u8 *tables)
+{
+    __m512i tables_low  = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables)));
+    __m512i tables_high = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables + 16)));
+    __m512i bits        = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    __m512i nibble      = _mm512_set1_epi8(0x0F);
+
+    __m512i data = _mm512_loadu_si512(block);
+    __m512i low  = _mm512_and_si512(data, nibble);
+    __m512i high = _mm512_and_si512(_mm512_srli_epi16(data, 4), nibble);
+    __m512i row  = _mm512_mask_blend_epi8(_mm512_movepi8_mask(data), _mm512_shuffle_epi8(tables_low, low), _mm512_shuffle_epi8(tables_high, low));
+
+    return _mm512_test_epi8_mask(row, _mm512_shuffle_epi8(bits, high));
+}
+
+//
+// FindSet
+//
+// @NOTE(Roman): First byte that is in the set (member) or isn't (!member). Blocks are tested by the MatchSetMask kernel
+//               of the same width, which inlines here, so tables are loaded once. The tail goes through a zero-padded copy.
+//
+
+static u64 FindSetScalar(const char *in, u64 in_length, const u8 *tables, bool member)
+{
+    for (u64 i = 0; i < in_length; ++i)
+    {
+        u8 byte = static_cast<u8>(in[i]);
+        if (static_cast<bool>((tables[(byte >> 7) * 16 + (byte & 0x0F)] >> ((byte >> 4) & 7)) & 1) == member) return i;
+    }
+    return String::NotFound;
+}
+
+TARGET_AVX2 static u64 FindSetAVX2(const char *in, u64 in_length, const u8 *tables, bool member)
+{
+    u64 flip = member ? 0 : ~0ull;
+    u64 i    = 0;
+
+    for (; i + 64 <= in_length; i += 64)
+    {
+        u64 mask = MatchSetMaskAVX2(in + i, tables) ^ flip;
+        if (mask) return i + CountTrailingZeros64(mask);
+    }
+
+    if (i < in_length)
+    {
+        char tail[64];
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, in + i, in_length - i);
+
+        u64 mask = (MatchSetMaskAVX2(tail, tables) ^ flip) & ((1ull << (in_length - i)) - 1);
+        if (mask) return i + CountTrailingZeros64(mask);
+    }
+
+    return String::NotFound;
+}
+
+TARGET_AVX512 static u64 FindSetAVX512(const char *in, u64 in_length, const u8 *tables, bool member)
+{
+    u64 flip = member ? 0 : ~0ull;
+    u64 i    = 0;
+
+    for (; i + 64 <= in_length; i += 64)
+    {
+        u64 mask = MatchSetMaskAVX512(in + i, tables) ^ flip;
+        if (mask) return i + CountTrailingZeros64(mask);
+    }
+
+    if (i < in_length)
+    {
+        char tail[64];
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, in + i, in_length - i);
+
+        u64 mask = (MatchSetMaskAVX512(tail, tables) ^ flip) & ((1ull << (in_length - i)) - 1);
+        if (mask) return i + CountTrailingZeros64(mask);
+    }
+
+    return String::NotFound;
+}
+
+//
+// TeddyMask
+//
+// @NOTE(Roman): Bit i of the result is set if bytes i, i + 1 and i + 2 of the block can start a pattern
+//               of some bucket, byte i of buckets gets the bits of those buckets. The block has to have
+//               66 readable bytes. Tables are 16 low nibble masks followed by 16 high nibble masks for each byte,
+//               a byte matches the buckets that have both of its nibbles. Like sets, SSE2 uses the scalar version.
+//
+
+static u64 TeddyMaskScalar(const char *block, const u8 *tables, u8 *buckets)
+{
+    u64 mask = 0;
+    for (u64 i = 0; i < 64; ++i)
+    {
+        u8 candidates = 0xFF;
+        for (u64 k = 0; k < 3; ++k)
+        {
+            u8 byte = static_cast<u8>(block[i + k]);
+            candidates &= tables[32 * k + (byte & 0x0F)] & tables[32 * k + 16 + (byte >> 4)];
+        }
+        buckets[i] = candidates;
+        mask      |= static_cast<u64>(candidates != 0) << i;
+    }
+    return mask;
+}
+
+TARGET_AVX2 static u64 TeddyMaskAVX2(const char *block, const u8 *tables, u8 *buckets)
+{
+    __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i low_tables[3];
+    __m256i high_tables[3];
+    u64     mask = 0;
+
+    for (u64 k = 0; k < 3; ++k)
+    {
+        low_tables[k]  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables + 32 * k)));
+        high_tables[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables + 32 * k + 16)));
+    }
+
+    for (u64 i = 0; i < 64; i += sizeof(__m256i))
+    {
+        __m256i candidates = _mm256_set1_epi8(-1);
+
+        for (u64 k = 0; k < 3; ++k)
+        {
+            __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i + k));
+            __m256i low  = _mm256_shuffle_epi8(low_tables[k],  _mm256_and_si256(data, nibble));
+            __m256i high = _mm256_shuffle_epi8(high_tables[k], _mm256_and_si256(_mm256_srli_epi16(data, 4), nibble));
+            candidates   = _mm256_and_si256(candidates, _mm256_and_si256(low, high));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(buckets + i), candidates);
+
+        u32 miss = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(candidates, _mm256_setzero_si256())));
+        mask |= static_cast<u64>(~miss) << i;
+    }
+
+    return mask;
+}
+
+TARGET_AVX512 static u64 TeddyMaskAVX512(const char *block, const u8 *tables, u8 *buckets)
+{
+    __m512i nibble     = _mm512_set1_epi8(0x0F);
+    __m512i candidates = _mm512_set1_epi8(-1);
+
+    for (u64 k = 0; k < 3; ++k)
+    {
+        __m512i low_table  = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables + 32 * k)));
+        __m512i high_table = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tables + 32 * k + 16)));
+
+        __m512i data = _mm512_loadu_si512(block + k);
+        __m512i low  = _mm512_shuffle_epi8(low_table,  _mm512_and_si512(data, nibble));
+        __m512i high = _mm512_shuffle_epi8(high_table, _mm512_and_si512(_mm512_srli_epi16(data, 4), nibble));
+        candidates   = _mm512_and_si512(candidates, _mm512_and_si512(low, high));
+    }
+
+    _mm512_storeu_si512(buckets, candidates);
+    return _mm512_test_epi8_mask(candidates, candidates);
+}
+
+//
+// Dispatch
+//
+// @NOTE(Roman): Bulk kernels are picked once at run time from what CPUID reports,
+//               so a single binary uses the widest vectors each host has.
+//               STRING_ISA environment variable (scalar, sse, avx2 or avx512) can lower the choice
+//               to test or benchmark every path on one machine.
+//
+
+struct Kernels
+{
+    void (*vmemset)(void *dest, char val, u64 bytes);
+    void (*vmemcpy)(void *dest, const void *src, u64 bytes);
+    u64  (*find_byte)(const char *in, u64 in_length, char symbol);
+    u64  (*find_bytes)(const char *in, u64 in_length, const char *what, u64 what_length);
+    void (*hash_stripes)(u64 *acc, const u8 *in, u64 stripes, const u8 *secret);
+    u64  (*mismatch)(const char *left, const char *right, u64 length);
+    void (*flip_case)(char *data, u64 length, char first);
+    u64  (*mismatch_ignore_case)(const char *left, const char *right, u64 length);
+    u64  (*find_bytes_ignore_case)(const char *in, u64 in_length, const char *what, u64 what_length);
+    u64  (*match_byte_mask)(const char *block, char symbol);
+    u64  (*match_set_mask)(const char *block, const u8 *tables);
+    u64  (*teddy_mask)(const char *block, const u8 *tables, u8 *buckets);
+    u64  (*find_last_byte)(const char *in, u64 in_length, char symbol);
+    u64  (*find_last_bytes)(const char *in, u64 in_length, const char *what, u64 what_length);
+    u64  (*count_byte)(const char *in, u64 in_length, char symbol);
+    u64  (*find_set)(const char *in, u64 in_length, const u8 *tables, bool member);
+    u64  (*utf8_error)(const char *in, u64 in_length);
+    u64  (*count_code_points)(const char *in, u64 in_length);
+    u64  (*count_bytes_at_least)(const char *in, u64 in_length, u8 threshold);
+    u64  (*utf8_to_utf16)(const char *in, u64 in_length, u16 *out, u64 *error);
+    u64  (*utf16_to_utf8)(const u16 *in, u64 in_length, char *out, u64 *error);
+    u64  (*utf8_to_latin1)(const char *in, u64 in_length, char *out, u64 *error);
+    u64  (*latin1_to_utf8)(const char *in, u64 in_length, char *out);
+    u64  (*utf16_utf8_length)(const u16 *in, u64 in_length);
+
+    u64         vector_size;
+    const char *name;
+};
+
+static const Kernels gKernelTable[] =
+{
+    {
+        vmemset_scalar, vmemcpy_scalar, FindByteScalar, FindBytesScalar, HashStripesScalar, MismatchScalar,
+        FlipCaseScalar, MismatchIgnoreCaseScalar, FindBytesIgnoreCaseScalar,
+        MatchByteMaskScalar, MatchSetMaskScalar, TeddyMaskScalar,
+        FindLastByteScalar, FindLastBytesScalar, CountByteScalar, FindSetScalar,
+        Utf8ErrorScalar, CountCodePointsScalar,
+        CountBytesAtLeastScalar, Utf8ToUtf16Scalar, Utf16ToUtf8Scalar, Utf8ToLatin1Scalar, Latin1ToUtf8Scalar,
+        Utf16Utf8LengthScalar,
+        sizeof(void *), "scalar"
+    },
+    {
+        vmemset_sse, vmemcpy_sse, FindByteSSE, FindBytesSSE, HashStripesSSE, MismatchSSE,
+        FlipCaseSSE, MismatchIgnoreCaseSSE, FindBytesIgnoreCaseSSE,
+        MatchByteMaskSSE, MatchSetMaskScalar, TeddyMaskScalar,
+        FindLastByteSSE, FindLastBytesSSE, CountByteSSE, FindSetScalar,
+        Utf8ErrorScalar, CountCodePointsSSE,
+        CountBytesAtLeastSSE, Utf8ToUtf16SSE, Utf16ToUtf8SSE, Utf8ToLatin1SSE, Latin1ToUtf8SSE,
+        Utf16Utf8LengthSSE,
+        sizeof(__m128i), "sse"
+    },
+    {
+        vmemset_avx2, vmemcpy_avx2, FindByteAVX2, FindBytesAVX2, HashStripesAVX2, MismatchAVX2,
+        FlipCaseAVX2, MismatchIgnoreCaseAVX2, FindBytesIgnoreCaseAVX2,
+        MatchByteMaskAVX2, MatchSetMaskAVX2, TeddyMaskAVX2,
+        FindLastByteAVX2, FindLastBytesAVX2, CountByteAVX2, FindSetAVX2,
+        Utf8ErrorAVX2, CountCodePointsAVX2,
+        CountBytesAtLeastAVX2, Utf8ToUtf16AVX2, Utf16ToUtf8AVX2, Utf8ToLatin1AVX2, Latin1ToUtf8AVX2,
+        Utf16Utf8LengthAVX2,
+        sizeof(__m256i), "avx2"
+    },
+    {
+        vmemset_avx512, vmemcpy_avx512, FindByteAVX512, FindBytesAVX512, HashStripesAVX512, MismatchAVX512,
+        FlipCaseAVX512, MismatchIgnoreCaseAVX512, FindBytesIgnoreCaseAVX512,
+        MatchByteMaskAVX512, MatchSetMaskAVX512, TeddyMaskAVX512,
+        FindLastByteAVX512, FindLastBytesAVX512, CountByteAVX512, FindSetAVX512,
+        Utf8ErrorAVX512, CountCodePointsAVX512,
+        CountBytesAtLeastAVX512, Utf8ToUtf16AVX512, Utf16ToUtf8AVX512, Utf8ToLatin1AVX512, Latin1ToUtf8AVX512,
+        Utf16Utf8LengthAVX512,
+        sizeof(__m512i), "avx512"
+    },
+};
+
+static u32 DetectISA()
+{
+#ifdef _MSC_VER
+    int info[4];
+
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse2    = info[3] & (1 << 26);
+    bool osxsave = info[2] & (1 << 27);
+    bool avx     = info[2] & (1 << 28);
+    bool avx2    = false;
+    bool avx512  = false;
+
+    if (max_leaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2   = info[1] & (1 << 5);
+        avx512 = (info[1] & (1 << 16)) && (info[1] & (1 << 30)); // F and BW
+    }
+
+    // @NOTE(Roman): The OS has to save YMM (and ZMM, opmask) state too.
+    u64 xcr0 = osxsave ? _xgetbv(0) : 0;
+
+    if (avx && avx512 && (xcr0 & 0xE6) == 0xE6) return AVX512;
+    if (avx && avx2   && (xcr0 & 0x06) == 0x06) return AVX2;
+    if (sse2)                                   return SSE;
+    return SCALAR;
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return AVX512;
+    if (__builtin_cpu_supports("avx2"))                                          return AVX2;
+    if (__builtin_cpu_supports("sse2"))                                          return SSE;
+    return SCALAR;
+#endif
+}
+
+static u32 SelectISA()
+{
+    u32 isa = DetectISA();
+
+    if (const char *requested = getenv("STRING_ISA"))
+    {
+        for (u32 lower = SCALAR; lower < isa; ++lower)
+        {
+            if (!strcmp(requested, gKernelTable[lower].name))
+            {
+                isa = lower;
+                break;
+            }
+        }
+    }
+
+    return isa;
+}
+
+// @NOTE(Roman): The table is picked once, on first use, by a function-local static, which is thread-safe,
+//               so concurrent first calls and strings constructed by other static initializers are fine.
+//               After that each call costs a check of the initialized flag.
+static const Kernels& GetKernels()
+{
+    static const Kernels& kernels = gKernelTable[SelectISA()];
+    return kernels;
+}
+
+static void vmemset(void *dest, char val, u64 bytes)
+{
+    GetKernels().vmemset(dest, val, bytes);
+}
+
+// @NOTE(Roman): Short string payloads are copied by memcpy directly, skipping the indirect call.
+static void vmemcpy(void *dest, const void *src, u64 bytes)
+{
+    if (bytes <= String::SmallCapacity)
+    {
+        memcpy(dest, src, bytes);
+        return;
+    }
+
+    GetKernels().vmemcpy(dest, src, bytes);
+}
+
+static u64 FindByte(const char *in, u64 in_length, char symbol)
+{
+    return GetKernels().find_byte(in, in_length, symbol);
+}
+
+static void HashStripes(u64 *acc, const u8 *in, u64 stripes, const u8 *secret)
+{
+    GetKernels().hash_stripes(acc, in, stripes, secret);
+}
+
+static u64 Mismatch(const char *left, const char *right, u64 length)
+{
+    return GetKernels().mismatch(left, right, length);
+}
+
+static void FlipCase(char *data, u64 length, char first)
+{
+    GetKernels().flip_case(data, length, first);
+}
+
+static u64 MismatchIgnoreCase(const char *left, const char *right, u64 length)
+{
+    return GetKernels().mismatch_ignore_case(left, right, length);
+}
+
+static u64 MatchByteMask(const char *block, char symbol)
+{
+    return GetKernels().match_byte_mask(block, symbol);
+}
+
+static u64 MatchSetMask(const char *block, const u8 *tables)
+{
+    return GetKernels().match_set_mask(block, tables);
+}
+
+static u64 TeddyMask(const char *block, const u8 *tables, u8 *buckets)
+{
+    return GetKernels().teddy_mask(block, tables, buckets);
+}
+
+static u64 FindLastByte(const char *in, u64 in_length, char symbol)
+{
+    return GetKernels().find_last_byte(in, in_length, symbol);
+}
+
+static u64 FindLastBytes(const char *in, u64 in_length, const char *what, u64 what_length)
+{
+    if (!what_length)            return in_length;
+    if (in_length < what_length) return String::NotFound;
+    if (what_length == 1)        return FindLastByte(in, in_length, *what);
+    return GetKernels().find_last_bytes(in, in_length, what, what_length);
+}
+
+static u64 CountByte(const char *in, u64 in_length, char symbol)
+{
+    return GetKernels().count_byte(in, in_length, symbol);
+}
+
+static u64 FindSet(const char *in, u64 in_length, const u8 *tables, bool member)
+{
+    return GetKernels().find_set(in, in_length, tables, member);
+}
+
+static u64 Utf8Error(const char *in, u64 in_length)
+{
+    return GetKernels().utf8_error(in, in_length);
+}
+
+static u64 CountCodePoints(const char *in, u64 in_length)
+{
+    return GetKernels().count_code_points(in, in_length);
+}
+
+static u64 CountBytesAtLeast(const char *in, u64 in_length, u8 threshold)
+{
+    return GetKernels().count_bytes_at_least(in, in_length, threshold);
+}
+
+static u64 Utf8ToUtf16(const char *in, u64 in_length, u16 *out, u64 *error)
+{
+    return GetKernels().utf8_to_utf16(in, in_length, out, error);
+}
+
+static u64 Utf16ToUtf8(const u16 *in, u64 in_length, char *out, u64 *error)
+{
+    return GetKernels().utf16_to_utf8(in, in_length, out, error);
+}
+
+static u64 Utf8ToLatin1(const char *in, u64 in_length, char *out, u64 *error)
+{
+    return GetKernels().utf8_to_latin1(in, in_length, out, error);
+}
+
+static u64 Latin1ToUtf8(const char *in, u64 in_length, char *out)
+{
+    return GetKernels().latin1_to_utf8(in, in_length, out);
+}
+
+static u64 Utf16Utf8Length(const u16 *in, u64 in_length)
+{
+    return GetKernels().utf16_utf8_length(in, in_length);
+}
+
+static u64 FindBytesIgnoreCase(const char *in, u64 in_length, const char *what, u64 what_length)
+{
+    if (!what_length)            return 0;
+    if (in_length < what_length) return String::NotFound;
+    return GetKernels().find_bytes_ignore_case(in, in_length, what, what_length);
+}
+
+// @NOTE(Roman): Heap capacities are rounded up to the vector size of the selected kernels.
+static u64 Align(u64 x)
+{
+    u64 vector_size = GetKernels().vector_size;
+    return (x + (vector_size - 1)) & ~(vector_size - 1);
+}
+
+const char *String::KernelISA()
+{
+    return GetKernels().name;
+}
+
+static s8 CompareBytes(const char *left, u64 left_length, const char *right, u64 right_length)
+{
+    if (left_length < right_length) return -1;
+    if (left_length > right_length) return  1;
+
+    u64 index = Mismatch(left, right, left_length);
+
+    if (index == left_length)       return  0;
+    if (left[index] < right[index]) return -1;
+    return 1;
+}
+
+static s8 CompareBytesLexicographic(const char *left, u64 left_length, const char *right, u64 right_length)
+{
+    u64 length = left_length < right_length ? left_length : right_length;
+    u64 index  = Mismatch(left, right, length);
+
+    if (index < length)
+    {
+        return static_cast<u8>(left[index]) < static_cast<u8>(right[index]) ? -1 : 1;
+    }
+
+    if (left_length < right_length) return -1;
+    if (left_length > right_length) return  1;
+    return 0;
+}
+
+static s8 CompareBytesIgnoreCase(const char *left, u64 left_length, const char *right, u64 right_length, CompareMode mode)
+{
+    u64 length = left_length < right_length ? left_length : right_length;
+
+    if (mode == CompareMode::LengthFirst)
+    {
+        if (left_length < right_length) return -1;
+        if (left_length > right_length) return  1;
+    }
+
+    u64 index = MismatchIgnoreCase(left, right, length);
+
+    if (index < length)
+    {
+        char left_symbol  = ToLowerASCII(left[index]);
+        char right_symbol = ToLowerASCII(right[index]);
+
+        if (mode == CompareMode::Lexicographic)
+        {
+            return static_cast<u8>(left_symbol) < static_cast<u8>(right_symbol) ? -1 : 1;
+        }
+        return left_symbol < right_symbol ? -1 : 1;
+    }
+
+    if (left_length < right_length) return -1;
+    if (left_length > right_length) return  1;
+    return 0;
+}
+
+// @NOTE(Roman): Two-Way string matching (Crochemore & Perrin) with a bad character shift on the last byte.
+//               Linear in the worst case, used for needles too long for the vector filter to pay off.
+static u64 FindBytesTwoWay(const u8 *in, u64 in_length, const u8 *what, u64 what_length)
+{
+    u64 shift[256] = {};
+
+    for (u64 i = 0; i < what_length; ++i)
+    {
+        shift[what[i]] = i + 1;
+    }
+
+    // @NOTE(Roman): Critical factorization: maximal suffix for both orderings, take the later one.
+    u64 ip = ~0ull, jp = 0, k = 1, p = 1;
+
+    while (jp + k < what_length)
+    {
+        u8 a = what[ip + k];
+        u8 b = what[jp + k];
+
+        if (a == b)
+        {
+            if (k == p) { jp += p; k = 1; }
+            else        { ++k;            }
+        }
+        else if (a > b) { jp += k; k = 1; p = jp - ip; }
+        else            { ip = jp++; k = p = 1;        }
+    }
+
+    u64 ms = ip;
+    u64 p0 = p;
+
+    ip = ~0ull, jp = 0, k = 1, p = 1;
+
+    while (jp + k < what_length)
+    {
+        u8 a = what[ip + k];
+        u8 b = what[jp + k];
+
+        if (a == b)
+        {
+            if (k == p) { jp += p; k = 1; }
+            else        { ++k;            }
+        }
+        else if (a < b) { jp += k; k = 1; p = jp - ip; }
+        else            { ip = jp++; k = p = 1;        }
+    }
+
+    if (ip + 1 > ms + 1) ms = ip;
+    else                 p  = p0;
+
+    u64 memory0 = 0;
+
+    if (memcmp(what, what + p, ms + 1))
+    {
+        u64 right = what_length - ms - 1;
+        p = (ms > right ? ms : right) + 1;
+    }
+    else
+    {
+        memory0 = what_length - p;
+    }
+
+    const u8 *it     = in;
+    const u8 *end    = in + in_length;
+    u64       memory = 0;
+
+    while (static_cast<u64>(end - it) >= what_length)
+    {
+        k = what_length - shift[it[what_length - 1]];
+        if (k)
+        {
+            it    += k < memory ? memory : k;
+            memory = 0;
+            continue;
+        }
+
+        for (k = ms + 1 > memory ? ms + 1 : memory; k < what_length && what[k] == it[k]; ++k)
+        {
+        }
+
+        if (k < what_length)
+        {
+            it    += k - ms;
+            memory = 0;
+            continue;
+        }
+
+        for (k = ms + 1; k > memory && what[k - 1] == it[k - 1]; --k)
+        {
+        }
+
+        if (k <= memory) return it - in;
+
+        it    += p;
+        memory = memory0;
+    }
+
+    return String::NotFound;
+}
+
+// @NOTE(Roman): Needles longer than this go to Two-Way. Shorter ones are searched
+//               by comparing first and last bytes of the needle a vector at a time
+//               and checking the middle only where both match.
+#define FIND_VECTOR_MAX_NEEDLE 64
+
+static u64 FindBytes(const char *in, u64 in_length, const char *what, u64 what_length)
+{
+    if (!what_length)            return 0;
+    if (in_length < what_length) return String::NotFound;
+    if (what_length == 1)        return FindByte(in, in_length, *what);
+
+    if (what_length > FIND_VECTOR_MAX_NEEDLE)
+    {
+        return FindBytesTwoWay(reinterpret_cast<const u8 *>(in),   in_length,
+                               reinterpret_cast<const u8 *>(what), what_length);
+    }
+
+    return GetKernels().find_bytes(in, in_length, what, what_length);
+}
+
+s8 StringView::Compare(StringView other, CompareMode mode) const
+{
+    if (mode == CompareMode::Lexicographic)
+    {
+        return CompareBytesLexicographic(mData, mLength, other.mData, other.mLength);
+    }
+    return CompareBytes(mData, mLength, other.mData, other.mLength);
+}
+
+bool StringView::StartsWith(StringView prefix) const
+{
+    return prefix.mLength <= mLength
+        && Mismatch(mData, prefix.mData, prefix.mLength) == prefix.mLength;
+}
+
+bool StringView::EndsWith(StringView suffix) const
+{
+    return suffix.mLength <= mLength
+        && Mismatch(mData + mLength - suffix.mLength, suffix.mData, suffix.mLength) == suffix.mLength;
+}
+
+u64 StringView::CommonPrefixLength(StringView other) const
+{
+    return Mismatch(mData, other.mData, mLength < other.mLength ? mLength : other.mLength);
+}
+
+s8 StringView::CompareIgnoreCase(StringView other, CompareMode mode) const
+{
+    return CompareBytesIgnoreCase(mData, mLength, other.mData, other.mLength, mode);
+}
+
+bool StringView::EqualsIgnoreCase(StringView other) const
+{
+    return mLength == other.mLength && MismatchIgnoreCase(mData, other.mData, mLength) == mLength;
+}
+
+StringView StringView::FindIgnoreCase(StringView string) const
+{
+    u64 index = FindBytesIgnoreCase(mData, mLength, string.mData, string.mLength);
+    return index != NotFound ? StringView(mData + index, string.mLength) : StringView();
+}
+
+u64 StringView::FindIndexIgnoreCase(StringView string, u64 from) const
+{
+    if (from > mLength) return NotFound;
+    u64 index = FindBytesIgnoreCase(mData + from, mLength - from, string.mData, string.mLength);
+    return index != NotFound ? from + index : NotFound;
+}
+
+StringView StringView::Find(StringView string) const
+{
+    u64 index = FindBytes(mData, mLength, string.mData, string.mLength);
+    return index != NotFound ? StringView(mData + index, string.mLength) : StringView();
+}
+
+u64 StringView::FindIndex(StringView string, u64 from) const
+{
+    if (from > mLength) return NotFound;
+    u64 index = FindBytes(mData + from, mLength - from, string.mData, string.mLength);
+    return index != NotFound ? from + index : NotFound;
+}
+
+u64 StringView::FindIndex(char symbol, u64 from) const
+{
+    if (from > mLength) return NotFound;
+    u64 index = FindByte(mData + from, mLength - from, symbol);
+    return index != NotFound ? from + index : NotFound;
+}
+
+u64 StringView::FindIndex(const CharSet& set, u64 from) const
+{
+    if (from > mLength) return NotFound;
+    u64 index = FindSet(mData + from, mLength - from, set.Tables(), true);
+    return index != NotFound ? from + index : NotFound;
+}
+
+u64 StringView::FindIndexNotIn(const CharSet& set, u64 from) const
+{
+    if (from > mLength) return NotFound;
+    u64 index = FindSet(mData + from, mLength - from, set.Tables(), false);
+    return index != NotFound ? from + index : NotFound;
+}
+
+u64 StringView::FindLastIndex(StringView string, u64 to) const
+{
+    return FindLastBytes(mData, to < mLength ? to : mLength, string.mData, string.mLength);
+}
+
+u64 StringView::FindLastIndex(char symbol, u64 to) const
+{
+    return FindLastByte(mData, to < mLength ? to : mLength, symbol);
+}
+
+// @NOTE(Roman): Whole 64-byte blocks from the end, then the head through a zero-padded copy.
+u64 StringView::FindLastIndex(const CharSet& set, u64 to) const
+{
+    u64 i = to < mLength ? to : mLength;
+
+    for (; i >= 64; i -= 64)
+    {
+        u64 mask = MatchSetMask(mData + i - 64, set.Tables());
+        if (mask) return i - 64 + HighestBit64(mask);
+    }
+
+    if (i)
+    {
+        char head[64];
+        vmemset(head, '\0', sizeof(head));
+        vmemcpy(head, mData, i);
+
+        u64 mask = MatchSetMask(head, set.Tables()) & ((1ull << i) - 1);
+        if (mask) return HighestBit64(mask);
+    }
+
+    return NotFound;
+}
+
+StringView StringView::FindLast(StringView string) const
+{
+    u64 index = FindLastBytes(mData, mLength, string.mData, string.mLength);
+    return index != NotFound ? StringView(mData + index, string.mLength) : StringView();
+}
+
+StringView StringView::AfterLast(char symbol) const
+{
+    u64 index = FindLastByte(mData, mLength, symbol);
+    return index != NotFound ? StringView(mData + index + 1, mLength - index - 1) : *this;
+}
+
+StringView StringView::AfterLast(StringView string) const
+{
+    u64 index = FindLastBytes(mData, mLength, string.mData, string.mLength);
+    return index != NotFound ? StringView(mData + index + string.mLength, mLength - index - string.mLength) : *this;
+}
+
+StringView StringView::AfterLast(const CharSet& set) const
+{
+    u64 index = FindLastIndex(set);
+    return index != NotFound ? StringView(mData + index + 1, mLength - index - 1) : *this;
+}
+
+StringView StringView::BeforeLast(char symbol) const
+{
+    u64 index = FindLastByte(mData, mLength, symbol);
+    return index != NotFound ? StringView(mData, index) : *this;
+}
+
+StringView StringView::BeforeLast(StringView string) const
+{
+    u64 index = FindLastBytes(mData, mLength, string.mData, string.mLength);
+    return index != NotFound ? StringView(mData, index) : *this;
+}
+
+StringView StringView::BeforeLast(const CharSet& set) const
+{
+    u64 index = FindLastIndex(set);
+    return index != NotFound ? StringView(mData, index) : *this;
+}
+
+StringView StringView::SubString(u64 from, u64 to) const
+{
+    Check(from <= to);
+    Check(to <= mLength);
+    return StringView(mData + from, to - from);
+}
+
+//
+// Utf8
+//
+// @NOTE(Roman): CodePointOffset skips whole blocks by their code point counts,
+//               only the block holding the wanted code point is walked byte by byte.
+//
+
+#define CODE_POINT_BLOCK 512
+
+bool StringView::IsValidUtf8() const
+{
+    return Utf8Error(mData, mLength) == NotFound;
+}
+
+u64 StringView::FindInvalidUtf8Index() const
+{
+    return Utf8Error(mData, mLength);
+}
+
+u64 StringView::CountCodePoints() const
+{
+    return ::CountCodePoints(mData, mLength);
+}
+
+u64 StringView::CodePointOffset(u64 index) const
+{
+    u64 i = 0;
+
+    while (mLength - i >= CODE_POINT_BLOCK)
+    {
+        u64 count = ::CountCodePoints(mData + i, CODE_POINT_BLOCK);
+        if (count > index) break;
+
+        index -= count;
+        i     += CODE_POINT_BLOCK;
+    }
+
+    for (; i < mLength; ++i)
+    {
+        if (IsUtf8Continuation(static_cast<u8>(mData[i]))) continue;
+        if (!index) return i;
+        --index;
+    }
+
+    return index ? NotFound : mLength;
+}
+
+u64 StringView::CodePointStart(u64 offset) const
+{
+    Check(offset <= mLength);
+
+    for (u32 i = 0; i < 3 && offset && offset < mLength && IsUtf8Continuation(static_cast<u8>(mData[offset])); ++i)
+    {
+        --offset;
+    }
+
+    return offset;
+}
+
+u32 StringView::CodePointAt(u64 offset, u32 *length) const
+{
+    Check(offset < mLength);
+
+    u32 code_point;
+    u32 size = DecodeUtf8(reinterpret_cast<const u8 *>(mData + offset), mLength - offset, &code_point);
+
+    if (!size)
+    {
+        code_point = 0xFFFD;
+        size       = 1;
+    }
+
+    if (length) *length = size;
+    return code_point;
+}
+
+StringView StringView::SubStringCodePoints(u64 from, u64 to) const
+{
+    Check(from <= to);
+
+    u64 begin = CodePointOffset(from);
+    Check(begin != NotFound);
+
+    u64 end = StringView(mData + begin, mLength - begin).CodePointOffset(to - from);
+    Check(end != NotFound);
+
+    return StringView(mData + begin, end);
+}
+
+//
+// Transcode
+//
+
+u64 StringView::Utf16Length() const
+{
+    return ::CountCodePoints(mData, mLength) + CountBytesAtLeast(mData, mLength, 0xF0);
+}
+
+u64 StringView::Latin1Length() const
+{
+    return ::CountCodePoints(mData, mLength);
+}
+
+u64 StringView::ToUtf16(u16 *out, u64 *error_index) const
+{
+    u64 error;
+    u64 written = Utf8ToUtf16(mData, mLength, out, &error);
+    if (error_index) *error_index = error;
+    return written;
+}
+
+u64 StringView::ToLatin1(char *out, u64 *error_index) const
+{
+    u64 error;
+    u64 written = Utf8ToLatin1(mData, mLength, out, &error);
+    if (error_index) *error_index = error;
+    return written;
+}
+
+//
+// Hash
+//
+// @NOTE(Roman): Inputs up to HASH_SHORT_MAX bytes are mixed 16 or 48 bytes at a time with 64x64->128 multiplies
+//               (the wyhash scheme), longer ones go through the striped HashStripes kernels.
+//
+
+#define HASH_SHORT_MAX 1024
+
+static const u64 gHashPrimes[4] =
+{
+    0xA0761D6478BD642Full, 0xE7037ED1A0B428DBull, 0x8EBC6AF09C88C6E3ull, 0x589965CC75374CC3ull
+};
+
+static void Multiply128(u64 *lo, u64 *hi)
+{
+#ifdef _MSC_VER
+    *lo = _umul128(*lo, *hi, hi);
+#else
+    unsigned __int128 product = static_cast<unsigned __int128>(*lo) * *hi;
+    *lo = static_cast<u64>(product);
+    *hi = static_cast<u64>(product >> 64);
+#endif
+}
+
+static u64 Mix(u64 a, u64 b)
+{
+    Multiply128(&a, &b);
+    return a ^ b;
+}
+
+static u64 HashShort(const u8 *in, u64 length, u64 seed)
+{
+    const u64 *p = gHashPrimes;
+
+    seed ^= Mix(seed ^ p[0], p[1]);
+
+    u64 a = 0;
+    u64 b = 0;
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            u64 offset = (length >> 3) << 2;
+            a = (Read32(in)              << 32) | Read32(in + offset);
+            b = (Read32(in + length - 4) << 32) | Read32(in + length - 4 - offset);
+        }
+        else if (length)
+        {
+            a = (static_cast<u64>(in[0]) << 16) | (static_cast<u64>(in[length >> 1]) << 8) | in[length - 1];
+        }
+    }
+    else
+    {
+        u64 rest = length;
+
+        if (rest > 48)
+        {
+            u64 seed1 = seed;
+            u64 seed2 = seed;
+
+            do
+            {
+                seed  = Mix(Read64(in)      ^ p[1], Read64(in + 8)  ^ seed);
+                seed1 = Mix(Read64(in + 16) ^ p[2], Read64(in + 24) ^ seed1);
+                seed2 = Mix(Read64(in + 32) ^ p[3], Read64(in + 40) ^ seed2);
+                in   += 48;
+                rest -= 48;
+            }
+            while (rest > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (rest > 16)
+        {
+            seed  = Mix(Read64(in) ^ p[1], Read64(in + 8) ^ seed);
+            in   += 16;
+            rest -= 16;
+        }
+
+        a = Read64(in + rest - 16);
+        b = Read64(in + rest - 8);
+    }
+
+    a ^= p[1];
+    b ^= seed;
+    Multiply128(&a, &b);
+
+    return Mix(a ^ p[0] ^ length, b ^ p[1]);
+}
+
+static u64 HashLong(const u8 *in, u64 length, u64 seed)
+{
+    u64 acc[8] =
+    {
+        gHashPrimes[0], gHashPrimes[1], gHashPrimes[2], gHashPrimes[3],
+        ~gHashPrimes[0], ~gHashPrimes[1], ~gHashPrimes[2], ~gHashPrimes[3],
+    };
+
+    const u64 block_size = HASH_STRIPE_SIZE * HASH_STRIPES_PER_BLOCK;
+    const u64 stripes    = (length - 1) / HASH_STRIPE_SIZE;
+    const u64 blocks     = stripes / HASH_STRIPES_PER_BLOCK;
+
+    for (u64 block = 0; block < blocks; ++block)
+    {
+        HashStripes(acc, in + block * block_size, HASH_STRIPES_PER_BLOCK, gHashSecret);
+
+        // @NOTE(Roman): Scramble keeps the lanes from degrading on long inputs.
+        const u8 *key = gHashSecret + HASH_SECRET_SIZE - HASH_STRIPE_SIZE;
+        for (u64 i = 0; i < 8; ++i)
+        {
+            acc[i] ^= acc[i] >> 47;
+            acc[i] ^= Read64(key + i * sizeof(u64));
+            acc[i] *= 0x9E3779B1;
+        }
+    }
+
+    HashStripes(acc, in + blocks * block_size, stripes % HASH_STRIPES_PER_BLOCK, gHashSecret);
+
+    // @NOTE(Roman): The last stripe always goes in whole, overlapping the previous one if needed.
+    HashStripes(acc, in + length - HASH_STRIPE_SIZE, 1, gHashSecret + HASH_SECRET_SIZE - HASH_STRIPE_SIZE - 7);
+
+    u64 result = length * gHashPrimes[0] ^ seed;
+    for (u64 i = 0; i < 4; ++i)
+    {
+        result += Mix(acc[2 * i]     ^ Read64(gHashSecret + 11 + 16 * i),
+                      acc[2 * i + 1] ^ Read64(gHashSecret + 19 + 16 * i));
+    }
+
+    result ^= result >> 37;
+    result *= 0x165667919E3779F9ull;
+    result ^= result >> 32;
+
+    return result;
+}
+
+u64 StringView::Hash(u64 seed) const
+{
+    const u8 *in     = reinterpret_cast<const u8 *>(mData);
+    u64       result = mLength <= HASH_SHORT_MAX ? HashShort(in, mLength, seed) : HashLong(in, mLength, seed);
+
+    // @NOTE(Roman): 0 marks String's cached hash as not computed.
+    return result ? result : 1;
+}
+
+//
+// Split
+//
+
+StringSplit StringView::Split(char delimiter, bool skip_empty) const
+{
+    StringSplit split(*this, StringSplit::Kind::Byte, skip_empty);
+    split.mByte = delimiter;
+    return split;
+}
+
+StringSplit StringView::Split(StringView delimiter, bool skip_empty) const
+{
+    // @NOTE(Roman): An empty set never matches, so the whole view is the only piece.
+    if (delimiter.mLength == 0) return Split(CharSet(), skip_empty);
+    if (delimiter.mLength == 1) return Split(*delimiter.mData, skip_empty);
+
+    StringSplit split(*this, StringSplit::Kind::Bytes, skip_empty);
+    split.mDelimiter = delimiter;
+    return split;
+}
+
+StringSplit StringView::Split(const CharSet& delimiters, bool skip_empty) const
+{
+    StringSplit split(*this, StringSplit::Kind::Set, skip_empty);
+    split.mSet = delimiters;
+    return split;
+}
+
+StringSplit::Iterator::Iterator(const StringSplit *split)
+    : mSplit(split),
+      mNext(0),
+      mBlock(StringView::NotFound),
+      mIndex(0),
+      mCount(0),
+      mDone(!split)
+{
+    Advance();
+}
+
+u64 StringSplit::Iterator::NextDelimiter()
+{
+    const StringView& string = mSplit->mString;
+
+    if (mSplit->mKind == Kind::Bytes)
+    {
+        return string.FindIndex(mSplit->mDelimiter, mNext);
+    }
+
+    u64 mask = 0;
+
+    while (!mask)
+    {
+        u64 block = mBlock == StringView::NotFound ? 0 : mBlock + 64;
+        if (block >= string.Length()) return StringView::NotFound;
+
+        const char *data = string.Data() + block;
+        u64         left = string.Length() - block;
+
+        // @NOTE(Roman): Kernels read whole 64-byte blocks, the tail is copied so we don't read past the end.
+        char tail[64];
+        if (left < 64)
+        {
+            memcpy(tail, data, left);
+            memset(tail + left, 0, 64 - left);
+            data = tail;
+        }
+
+        mask = mSplit->mKind == Kind::Byte
+             ? MatchByteMask(data, mSplit->mByte)
+             : MatchSetMask(data, mSplit->mSet.Tables());
+
+        if (left < 64) mask &= (1ull << left) - 1;
+
+        mBlock = block;
+    }
+
+    mIndex = 1;
+    mCount = 0;
+
+    while (mask)
+    {
+        mOffsets[mCount++] = static_cast<u8>(CountTrailingZeros64(mask));
+        mask &= mask - 1;
+    }
+
+    return mBlock + mOffsets[0];
+}
+
+
+//
+// Worker pool
+//
+// @NOTE(Roman): Workers are started on first use and wait for parallel loops until the process exits.
+//               Parts of a loop are taken from an atomic counter by the workers and the calling thread alike.
+//               One loop runs at a time, a caller that finds the pool busy runs its loop alone,
+//               so nested and concurrent loops never wait for each other.
+//               A new loop starts only after every worker left the previous one,
+//               so late workers never mix parts of different loops.
+//
+
+typedef void (*ParallelBody)(void *context, u32 part);
+
+struct WorkerPool
+{
+    std::mutex              busy;
+    std::mutex              mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    ParallelBody            body;
+    void                   *context;
+    u32                     parts;
+    u32                     done;
+    u32                     active;
+    u32                     workers;
+    u64                     generation;
+    std::atomic<u32>        next;
+};
+
+static void RunParallelParts(WorkerPool *pool)
+{
+    u32 finished = 0;
+
+    for (u32 part; (part = pool->next.fetch_add(1, std::memory_order_relaxed)) < pool->parts; ++finished)
+    {
+        pool->body(pool->context, part);
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->done += finished;
+}
+
+static void WorkerMain(WorkerPool *pool)
+{
+    u64 seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(pool->mutex);
+            pool->wake.wait(lock, [&]() { return pool->generation != seen; });
+
+            seen = pool->generation;
+            ++pool->active;
+        }
+
+        RunParallelParts(pool);
+
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        --pool->active;
+        pool->finished.notify_all();
+    }
+}
+
+static WorkerPool *CreateWorkerPool()
+{
+    WorkerPool *pool = new WorkerPool;
+    u32         hardware_threads = std::thread::hardware_concurrency();
+
+    pool->body       = 0;
+    pool->context    = 0;
+    pool->parts      = 0;
+    pool->done       = 0;
+    pool->active     = 0;
+    pool->workers    = STRING_WORKERS ? STRING_WORKERS : hardware_threads > 1 ? hardware_threads - 1 : 0;
+    pool->generation = 0;
+    pool->next.store(0, std::memory_order_relaxed);
+
+    for (u32 i = 0; i < pool->workers; ++i)
+    {
+        std::thread(WorkerMain, pool).detach();
+    }
+
+    return pool;
+}
+
+static WorkerPool *GetWorkerPool()
+{
+    static WorkerPool *pool = CreateWorkerPool();
+    return pool;
+}
+
+static u32 ParallelThreads()
+{
+    return GetWorkerPool()->workers + 1;
+}
+
+static void ParallelFor(u32 parts, ParallelBody body, void *context)
+{
+    WorkerPool                  *pool = GetWorkerPool();
+    std::unique_lock<std::mutex> busy(pool->busy, std::try_to_lock);
+
+    if (!busy || !pool->workers || parts < 2)
+    {
+        for (u32 part = 0; part < parts; ++part) body(context, part);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        pool->finished.wait(lock, [&]() { return !pool->active; });
+
+        pool->body    = body;
+        pool->context = context;
+        pool->parts   = parts;
+        pool->done    = 0;
+        pool->next.store(0, std::memory_order_relaxed);
+        ++pool->generation;
+    }
+    pool->wake.notify_all();
+
+    RunParallelParts(pool);
+
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->finished.wait(lock, [&]() { return pool->done == pool->parts && !pool->active; });
+}
+
+//
+// FindAll
+//
+// @NOTE(Roman): A part owns the matches that start in it and searches needle_length - 1 bytes
+//               past its end for them. Parts are counted in parallel first, then only the parts
+//               whose matches fit into offsets are searched again to write them at their place.
+//
+
+#define FIND_ALL_MIN_PART (1ull << 20)
+
+static u64 FindAllRange(const char *data, u64 length, u64 from, u64 to, const char *what, u64 what_length, u64 *offsets, u64 max_offsets)
+{
+    u64 last  = what_length - 1;
+    u64 count = 0;
+    u64 at    = from;
+
+    // @NOTE(Roman): Whole blocks are filtered on the first and the last byte of the needle, 64 positions at once,
+    //               so dense matches cost no more calls than sparse ones. Needles of up to 2 bytes need no verification
+    //               and are just counted once offsets are full.
+    for (; at + 64 <= to && at + last + 64 <= length; at += 64)
+    {
+        u64 mask = MatchByteMask(data + at, what[0]);
+        if (last) mask &= MatchByteMask(data + at + last, what[last]);
+
+        if (what_length <= 2 && count >= max_offsets)
+        {
+            count += PopCount64(mask);
+            continue;
+        }
+
+        for (; mask; mask &= mask - 1)
+        {
+            u64 position = at + CountTrailingZeros64(mask);
+
+            if (what_length > 2 && memcmp(data + position + 1, what + 1, what_length - 2)) continue;
+
+            if (count < max_offsets) offsets[count] = position;
+            ++count;
+        }
+    }
+
+    u64 end = to + last < length ? to + last : length;
+
+    while (at < to)
+    {
+        u64 index = FindBytes(data + at, end - at, what, what_length);
+        if (index == String::NotFound) break;
+
+        if (count < max_offsets) offsets[count] = at + index;
+
+        ++count;
+        at += index + 1;
+    }
+
+    return count;
+}
+
+struct FindAllJob
+{
+    const char *data;
+    u64         length;
+    const char *what;
+    u64         what_length;
+    u64         part_length;
+    u64        *offsets;
+    u64         max_offsets;
+    u64        *counts;
+    u64        *firsts;
+};
+
+static void CountPart(void *context, u32 part)
+{
+    FindAllJob *job  = static_cast<FindAllJob *>(context);
+    u64         from = part * job->part_length;
+    u64         to   = from + job->part_length < job->length ? from + job->part_length : job->length;
+
+    job->counts[part] = FindAllRange(job->data, job->length, from, to, job->what, job->what_length, 0, 0);
+}
+
+static void WritePart(void *context, u32 part)
+{
+    FindAllJob *job   = static_cast<FindAllJob *>(context);
+    u64         from  = part * job->part_length;
+    u64         to    = from + job->part_length < job->length ? from + job->part_length : job->length;
+    u64         first = job->firsts[part];
+
+    if (first < job->max_offsets && job->counts[part])
+    {
+        FindAllRange(job->data, job->length, from, to, job->what, job->what_length, job->offsets + first, job->max_offsets - first);
+    }
+}
+
+u64 StringView::FindAll(StringView string, u64 *offsets, u64 max_offsets) const
+{
+    if (!string.mLength || string.mLength > mLength) return 0;
+
+    if (!STRING_PARALLEL_THRESHOLD || mLength < STRING_PARALLEL_THRESHOLD)
+    {
+        return FindAllRange(mData, mLength, 0, mLength, string.mData, string.mLength, offsets, max_offsets);
+    }
+
+    // @NOTE(Roman): A few parts per thread, so a slow thread doesn't hold the whole loop.
+    u64 parts = 4 * ParallelThreads();
+    if (parts > mLength / FIND_ALL_MIN_PART) parts = mLength / FIND_ALL_MIN_PART;
+    if (parts < 1)                           parts = 1;
+
+    u64  stack_counts[256];
+    u64 *counts = parts <= 128 ? stack_counts : static_cast<u64 *>(malloc(2 * parts * sizeof(u64)));
+    Check(counts);
+
+    FindAllJob job;
+    job.data        = mData;
+    job.length      = mLength;
+    job.what        = string.mData;
+    job.what_length = string.mLength;
+    job.part_length = (mLength + parts - 1) / parts;
+    job.offsets     = offsets;
+    job.max_offsets = max_offsets;
+    job.counts      = counts;
+    job.firsts      = counts + parts;
+
+    ParallelFor(static_cast<u32>(parts), CountPart, &job);
+
+    u64 total = 0;
+    for (u64 part = 0; part < parts; ++part)
+    {
+        job.firsts[part] = total;
+        total           += counts[part];
+    }
+
+    if (offsets && max_offsets && total)
+    {
+        ParallelFor(static_cast<u32>(parts), WritePart, &job);
+    }
+
+    if (counts != stack_counts) free(counts);
+
+    return total;
+}
+
+u64 StringView::Count(StringView string) const
+{
+    return FindAll(string, 0, 0);
+}
+
+u64 StringView::Count(char symbol) const
+{
+    return CountByte(mData, mLength, symbol);
+}
+
+u64 StringView::Count(const CharSet& set) const
+{
+    u64 count = 0;
+    u64 i     = 0;
+
+    for (; i + 64 <= mLength; i += 64)
+    {
+        count += PopCount64(MatchSetMask(mData + i, set.Tables()));
+    }
+
+    if (i < mLength)
+    {
+        char tail[64];
+        vmemset(tail, '\0', sizeof(tail));
+        vmemcpy(tail, mData + i, mLength - i);
+
+        count += PopCount64(MatchSetMask(tail, set.Tables()) & ((1ull << (mLength - i)) - 1));
+    }
+
+    return count;
+}
+
+//
+// Allocators
+//
+
+static void *Allocate(Allocator *allocator, u64 bytes)
+{
+    return allocator ? allocator->Allocate(bytes) : malloc(bytes);
+}
+
+static void *Reallocate(Allocator *allocator, void *memory, u64 old_bytes, u64 new_bytes)
+{
+    return allocator ? allocator->Reallocate(memory, old_bytes, new_bytes) : realloc(memory, new_bytes);
+}
+
+static void Free(Allocator *allocator, void *memory, u64 bytes)
+{
+    if (allocator) allocator->Free(memory, bytes);
+    else           free(memory);
+}
+
+#define ALLOCATOR_ALIGNMENT 16
+
+static u64 AlignAllocation(u64 bytes)
+{
+    return (bytes + (ALLOCATOR_ALIGNMENT - 1)) & ~static_cast<u64>(ALLOCATOR_ALIGNMENT - 1);
+}
+
+ArenaAllocator::ArenaAllocator(u64 block_size)
+    : mBlocks(0),
+      mLast(0),
+      mBlockSize(block_size)
+{
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+    while (mBlocks)
+    {
+        Block *next = mBlocks->next;
+        free(mBlocks);
+        mBlocks = next;
+    }
+}
+
+void *ArenaAllocator::Allocate(u64 bytes)
+{
+    bytes = AlignAllocation(bytes);
+
+    if (!mBlocks || mBlocks->used + bytes > mBlocks->size)
+    {
+        u64    size  = bytes > mBlockSize ? bytes : mBlockSize;
+        Block *block = static_cast<Block *>(malloc(AlignAllocation(sizeof(Block)) + size));
+
+        block->next = mBlocks;
+        block->size = size;
+        block->used = 0;
+        mBlocks     = block;
+    }
+
+    mLast = reinterpret_cast<char *>(mBlocks) + AlignAllocation(sizeof(Block)) + mBlocks->used;
+    mBlocks->used += bytes;
+
+    return mLast;
+}
+
+void *ArenaAllocator::Reallocate(void *memory, u64 old_bytes, u64 new_bytes)
+{
+    if (memory && memory == mLast)
+    {
+        u64 start = mBlocks->used - AlignAllocation(old_bytes);
+
+        if (start + AlignAllocation(new_bytes) <= mBlocks->size)
+        {
+            mBlocks->used = start + AlignAllocation(new_bytes);
+            return memory;
+        }
+    }
+
+    void *result = Allocate(new_bytes);
+    if (memory) vmemcpy(result, memory, old_bytes < new_bytes ? old_bytes : new_bytes);
+    return result;
+}
+
+void ArenaAllocator::Free(void *memory, u64 bytes)
+{
+    if (memory && memory == mLast)
+    {
+        mBlocks->used -= AlignAllocation(bytes);
+        mLast          = 0;
+    }
+}
+
+void ArenaAllocator::Reset()
+{
+    // @NOTE(Roman): Keep the latest block, it's the one to reuse.
+    if (mBlocks)
+    {
+        Block *next = mBlocks->next;
+
+        while (next)
+        {
+            Block *after = next->next;
+            free(next);
+            next = after;
+        }
+
+        mBlocks->next = 0;
+        mBlocks->used = 0;
+    }
+
+    mLast = 0;
+}
+
+PoolAllocator::PoolAllocator(u64 chunk_size, u64 chunks_per_block)
+    : mBlocks(0),
+      mFreeList(0),
+      mChunkSize(AlignAllocation(chunk_size < sizeof(Chunk) ? sizeof(Chunk) : chunk_size)),
+      mChunksPerBlock(chunks_per_block ? chunks_per_block : 1)
+{
+}
+
+PoolAllocator::~PoolAllocator()
+{
+    while (mBlocks)
+    {
+        Block *next = mBlocks->next;
+        free(mBlocks);
+        mBlocks = next;
+    }
+}
+
+void *PoolAllocator::Allocate(u64 bytes)
+{
+    if (bytes > mChunkSize)
+    {
+        return malloc(bytes);
+    }
+
+    if (!mFreeList)
+    {
+        Block *block = static_cast<Block *>(malloc(AlignAllocation(sizeof(Block)) + mChunkSize * mChunksPerBlock));
+        block->next  = mBlocks;
+        mBlocks      = block;
+
+        char *chunks = reinterpret_cast<char *>(block) + AlignAllocation(sizeof(Block));
+
+        for (u64 i = mChunksPerBlock; i; --i)
+        {
+            Chunk *chunk = reinterpret_cast<Chunk *>(chunks + (i - 1) * mChunkSize);
+            chunk->next  = mFreeList;
+            mFreeList    = chunk;
+        }
+    }
+
+    Chunk *chunk = mFreeList;
+    mFreeList    = chunk->next;
+    return chunk;
+}
+
+void *PoolAllocator::Reallocate(void *memory, u64 old_bytes, u64 new_bytes)
+{
+    if (!memory)
+    {
+        return Allocate(new_bytes);
+    }
+
+    if (old_bytes > mChunkSize && new_bytes > mChunkSize)
+    {
+        return realloc(memory, new_bytes);
+    }
+
+    if (old_bytes <= mChunkSize && new_bytes <= mChunkSize)
+    {
+        return memory;
+    }
+
+    void *result = Allocate(new_bytes);
+    vmemcpy(result, memory, old_bytes < new_bytes ? old_bytes : new_bytes);
+    Free(memory, old_bytes);
+    return result;
+}
+
+void PoolAllocator::Free(void *memory, u64 bytes)
+{
+    if (!memory) return;
+
+    if (bytes > mChunkSize)
+    {
+        free(memory);
+    }
+    else
+    {
+        Chunk *chunk = static_cast<Chunk *>(memory);
+        chunk->next  = mFreeList;
+        mFreeList    = chunk;
+    }
+}
+
+//
+// Number formatting
+//
+// @NOTE(Roman): Integers are written from the last digit, two digits at a time from gDigitPairs,
+//               into exactly as many bytes as DecimalDigits counts, so nothing is moved afterwards.
+//               Doubles are converted with Ryu (Ulf Adams, PLDI 2018): the interval of decimals that round
+//               to the double is computed with 128-bit multiplies by tabulated powers of 5,
+//               then digits are removed while both bounds stay apart, which gives the shortest decimal
+//               that parses back to the same double, the closest one if there are several.
+//
+
+static const char gDigitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static u32 DecimalDigits(u64 value)
+{
+    u32 digits = 1;
+    for (;;)
+    {
+        if (value < 10)    return digits;
+        if (value < 100)   return digits + 1;
+        if (value < 1000)  return digits + 2;
+        if (value < 10000) return digits + 3;
+        value  /= 10000;
+        digits += 4;
+    }
+}
+
+static u32 FormatUInt(char *out, u64 value)
+{
+    u32   digits = DecimalDigits(value);
+    char *end    = out + digits;
+
+    while (value >= 100)
+    {
+        u64 pair = value % 100;
+        value   /= 100;
+        end     -= 2;
+        memcpy(end, gDigitPairs + 2 * pair, 2);
+    }
+
+    if (value >= 10) memcpy(end - 2, gDigitPairs + 2 * value, 2);
+    else             end[-1] = static_cast<char>('0' + value);
+
+    return digits;
+}
+
+static u32 FormatInt(char *out, s64 value)
+{
+    if (value >= 0) return FormatUInt(out, static_cast<u64>(value));
+    *out = '-';
+    return 1 + FormatUInt(out + 1, 0 - static_cast<u64>(value));
+}
+
+static u32 FormatHex(char *out, u64 value, u32 min_digits, bool uppercase)
+{
+    const char *symbols = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    u32         digits  = HighestBit64(value | 1) / 4 + 1;
+
+    if (digits < min_digits) digits = min_digits;
+
+    for (u32 i = digits; i--; value >>= 4)
+    {
+        out[i] = symbols[value & 0x0F];
+    }
+
+    return digits;
+}
+
+// @NOTE(Roman): gPow5InvSplit[q] is 2^(bits(5^q) - 1 + 125) / 5^q + 1 and gPow5Split[i] is 5^i scaled to 125 bits,
+//               both as { low, high } halves of 128-bit numbers.
+#define DOUBLE_MANTISSA_BITS     52
+#define DOUBLE_EXPONENT_BITS     11
+#define DOUBLE_BIAS              1023
+#define DOUBLE_POW5_INV_BITCOUNT 125
+#define DOUBLE_POW5_BITCOUNT     125
+
+static const u64 gPow5InvSplit[342][2] =
+{
+    { 0x0000000000000001ull, 0x2000000000000000ull }, { 0x999999999999999Aull, 0x1999999999999999ull },
+    { 0x47AE147AE147AE15ull, 0x147AE147AE147AE1ull }, { 0x6C8B4395810624DEull, 0x10624DD2F1A9FBE7ull },
+    { 0x7A786C226809D496ull, 0x1A36E2EB1C432CA5ull }, { 0x61F9F01B866E43ABull, 0x14F8B588E368F084ull },
+    { 0xB4C7F34938583622ull, 0x10C6F7A0B5ED8D36ull }, { 0x87A6520EC08D236Aull, 0x1AD7F29ABCAF4857ull },
+    { 0x9FB841A566D74F88ull, 0x15798EE2308C39DFull }, { 0xE62D01511F12A607ull, 0x112E0BE826D694B2ull },
+    { 0xD6AE6881CB5109A4ull, 0x1B7CDFD9D7BDBAB7ull }, { 0xDEF1ED34A2A73AEAull, 0x15FD7FE17964955Full },
+    { 0x7F27F0F6E885C8BBull, 0x119799812DEA1119ull }, { 0x650CB4BE40D60DF8ull, 0x1C25C268497681C2ull },
+    { 0xEA70909833DE7193ull, 0x16849B86A12B9B01ull }, { 0x21F3A6E0297EC143ull, 0x1203AF9EE756159Bull },
+    { 0x6985D7CD0F313537ull, 0x1CD2B297D889BC2Bull }, { 0x2137DFD73F5A90F9ull, 0x170EF54646D49689ull },
+    { 0xE75FE645CC4873FAull, 0x12725DD1D243ABA0ull }, { 0xA5663D3C7A0D865Dull, 0x1D83C94FB6D2AC34ull },
+    { 0x511E976394D79EB1ull, 0x179CA10C9242235Dull }, { 0xDA7EDF82DD794BC1ull, 0x12E3B40A0E9B4F7Dull },
+    { 0x2A6498D1625BAC68ull, 0x1E392010175EE596ull }, { 0xEEB6E0A781E2F053ull, 0x182DB34012B25144ull },
+    { 0x58924D52CE4F26A9ull, 0x1357C299A88EA76Aull }, { 0x27507BB7B07EA441ull, 0x1EF2D0F5DA7DD8AAull },
+    { 0x52A6C95FC0655034ull, 0x18C240C4AECB13BBull }, { 0x0EEBD44C99EAA690ull, 0x13CE9A36F23C0FC9ull },
+    { 0xB17953ADC3110A80ull, 0x1FB0F6BE50601941ull }, { 0xC12DDC8B02740867ull, 0x195A5EFEA6B34767ull },
+    { 0x3424B06F3529A052ull, 0x14484BFEEBC29F86ull }, { 0x901D59F290EE19DBull, 0x1039D66589687F9Eull },
+    { 0x4CFBC31DB4B0295Full, 0x19F623D5A8A73297ull }, { 0x3D9635B15D59BAB2ull, 0x14C4E977BA1F5BACull },
+    { 0x97AB5E277DE16228ull, 0x109D8792FB4C4956ull }, { 0xF2ABC9D8C9689D0Dull, 0x1A95A5B7F87A0EF0ull },
+    { 0x5BBCA17A3ABA173Eull, 0x154484932D2E725Aull }, { 0xAFCA1AC82EFB45CBull, 0x11039D428A8B8EAEull },
+    { 0xB2DCF7A6B1920945ull, 0x1B38FB9DAA78E44Aull }, { 0xF57D92EBC141A104ull, 0x15C72FB1552D836Eull },
+    { 0xC46475896767B403ull, 0x116C262777579C58ull }, { 0x6D6D88DBD8A5ECD2ull, 0x1BE03D0BF225C6F4ull },
+    { 0x8ABE071646EB23DBull, 0x164CFDA3281E38C3ull }, { 0x6EFE6C11D255B649ull, 0x11D7314F534B609Cull },
+    { 0xB197134FB6EF8A0Eull, 0x1C8B821885456760ull }, { 0x27AC0F72F8BFA1A5ull, 0x16D601AD376AB91Aull },
+    { 0xB95672C260994E1Eull, 0x1244CE242C5560E1ull }, { 0xF5571E03CDC21695ull, 0x1D3AE36D13BBCE35ull },
+    { 0x2AAC18030B01ABABull, 0x17624F8A762FD82Bull }, { 0xBBBCE0026F348956ull, 0x12B50C6EC4F31355ull },
+    { 0x92C7CCD0B1EDA889ull, 0x1DEE7A4AD4B81EEFull }, { 0xDBD30A408E57BA07ull, 0x17F1FB6F10934BF2ull },
+    { 0x7CA8D50071DFC806ull, 0x1327FC58DA0F6FF5ull }, { 0xFAA7BB33E9660CD6ull, 0x1EA6608E29B24CBBull },
+    { 0x9552FC298784D711ull, 0x18851A0B548EA3C9ull }, { 0xAAA8C9BAD2D0AC0Eull, 0x139DAE6F76D88307ull },
+    { 0xDDDADC5E1E1AACE3ull, 0x1F62B0B257C0D1A5ull }, { 0x7E48B04B4B488A4Full, 0x191BC08EAC9A4151ull },
+    { 0xCB6D59D5D5D3A1D9ull, 0x141633A556E1CDDAull }, { 0x3C577B1177DC817Bull, 0x1011C2EAABE7D7E2ull },
+    { 0xC6F25E825960CF2Aull, 0x19B604AAACA62636ull }, { 0x6BF518684780A5BBull, 0x14919D5556EB51C5ull },
+    { 0x232A79ED06008496ull, 0x10747DDDDF22A7D1ull }, { 0xD1DD8FE1A3340756ull, 0x1A53FC9631D10C81ull },
+    { 0xA7E4731AE8F66C45ull, 0x150FFD44F4A73D34ull }, { 0x531D28E253F8569Eull, 0x10D9976A5D52975Dull },
+    { 0xEB61DB03B98D5762ull, 0x1AF5BF109550F22Eull }, { 0xBC4E48CFC7A445E8ull, 0x159165A6DDDA5B58ull },
+    { 0x6371D3D96C836B20ull, 0x11411E1F17E1E2ADull }, { 0x9F1C8628AD9F11CDull, 0x1B9B6364F3030448ull },
+    { 0xE5B06B53BE18DB0Bull, 0x1615E91D8F359D06ull }, { 0xEAF3890FCB4715A2ull, 0x11AB20E472914A6Bull },
+    { 0x44B8DB4C7871BC37ull, 0x1C45016D841BAA46ull }, { 0x03C715D6C6C1635Full, 0x169D9ABE03495505ull },
+    { 0x3638DE456BCDE919ull, 0x1217AEFE69077737ull }, { 0x56C163A2461641C1ull, 0x1CF2B1970E725858ull },
+    { 0xDF011C81D1AB67CEull, 0x17288E1271F51379ull }, { 0x7F3416CE4155ECA5ull, 0x1286D80EC190DC61ull },
+    { 0x6520247D3556476Eull, 0x1DA48CE468E7C702ull }, { 0xEA801D30F7783925ull, 0x17B6D71D20B96C01ull },
+    { 0xBB99B0F3F92CFA84ull, 0x12F8AC174D612334ull }, { 0x5F5C4E532847F739ull, 0x1E5AACF215683854ull },
+    { 0x7F7D0B75B9D32C2Eull, 0x18488A5B44536043ull }, { 0x9930D5F7C7DC2358ull, 0x136D3B7C36A919CFull },
+    { 0x8EB4898C72F9D226ull, 0x1F152BF9F10E8FB2ull }, { 0x722A07A38F2E41B8ull, 0x18DDBCC7F40BA628ull },
+    { 0xC1BB394FA5BE9AFAull, 0x13E497065CD61E86ull }, { 0x9C5EC2190930F7F6ull, 0x1FD424D6FAF030D7ull },
+    { 0x49E56814075A5FF8ull, 0x197683DF2F268D79ull }, { 0x6E51201005E1E660ull, 0x145ECFE5BF520AC7ull },
+    { 0xF1DA800CD181851Aull, 0x104BD984990E6F05ull }, { 0x4FC400148268D4F5ull, 0x1A12F5A0F4E3E4D6ull },
+    { 0xD96999AA01ED772Bull, 0x14DBF7B3F71CB711ull }, { 0xADEE1488018AC5BCull, 0x10AFF95CC5B09274ull },
+    { 0x497CEDA668DE092Cull, 0x1AB328946F80EA54ull }, { 0x3ACA57B853E4D424ull, 0x155C2076BF9A5510ull },
+    { 0x623B7960431D7683ull, 0x1116805EFFAEAA73ull }, { 0x9D2BF566D1C8BD9Eull, 0x1B5733CB32B110B8ull },
+    { 0x7DBCC452416D647Full, 0x15DF5CA28EF40D60ull }, { 0xCAFD69DB678AB6CCull, 0x117F7D4ED8C33DE6ull },
+    { 0xAB2F0FC572778ADFull, 0x1BFF2EE48E052FD7ull }, { 0x88F273045B92D580ull, 0x1665BF1D3E6A8CACull },
+    { 0xD3F528D049424466ull, 0x11EAFF4A98553D56ull }, { 0xB988414D4203A0A3ull, 0x1CAB3210F3BB9557ull },
+    { 0x6139CDD76802E6E9ull, 0x16EF5B40C2FC7779ull }, { 0xE761717920025254ull, 0x125915CD68C9F92Dull },
+    { 0xA568B58E999D5086ull, 0x1D5B561574765B7Cull }, { 0x5120913EE14AA6D2ull, 0x177C44DDF6C515FDull },
+    { 0xA74D40FF1AA21F0Eull, 0x12C9D0B1923744CAull }, { 0x0BAECE64F769CB4Aull, 0x1E0FB44F50586E11ull },
+    { 0x3C8BD850C5EE3C3Bull, 0x180C903F7379F1A7ull }, { 0xCA0979DA37F1C9C9ull, 0x133D4032C2C7F485ull },
+    { 0xA9A8C2F6BFE942DBull, 0x1EC866B79E0CBA6Full }, { 0x2153CF2BCCBA9BE3ull, 0x18A0522C7E709526ull },
+    { 0x1AA9728970954982ull, 0x13B374F06526DDB8ull }, { 0xF775840F1A88759Dull, 0x1F8587E7083E2F8Cull },
+    { 0x5F9136727BA05E17ull, 0x19379FEC0698260Aull }, { 0x1940F85B9619E4DFull, 0x142C7FF0054684D5ull },
+    { 0xE100C6AFAB47EA4Cull, 0x1023998CD1053710ull }, { 0xCE67A44C453FDD47ull, 0x19D28F47B4D524E7ull },
+    { 0xD852E9D69DCCB106ull, 0x14A8729FC3DDB71Full }, { 0x79DBEE454B0A2738ull, 0x1086C219697E2C19ull },
+    { 0x295FE3A211A9D859ull, 0x1A71368F0F30468Full }, { 0xBAB31C81A7BB137Aull, 0x15275ED8D8F36BA5ull },
+    { 0x6228E39AEC95A92Full, 0x10EC4BE0AD8F8951ull }, { 0x9D0E38F7E0EF7517ull, 0x1B13AC9AAF4C0EE8ull },
+    { 0xB0D82D931A592A79ull, 0x15A956E225D67253ull }, { 0x8D79BE0F4847552Eull, 0x11544581B7DEC1DCull },
+    { 0x158F967EDA0BBB7Cull, 0x1BBA08CF8C979C94ull }, { 0x77A611FF14D62F97ull, 0x162E6D72D6DFB076ull },
+    { 0xF951A7FF43DE8C79ull, 0x11BEBDF578B2F391ull }, { 0xC21C3FFED2FDAD8Eull, 0x1C6463225AB7EC1Cull },
+    { 0x01B0333242648AD8ull, 0x16B6B5B5155FF017ull }, { 0x0159C28E9B83A246ull, 0x122BC490DDE659ACull },
+    { 0xCEF604175F3903A3ull, 0x1D12D41AFCA3C2ACull }, { 0x725E69AC4C2D9C83ull, 0x17424348CA1C9BBDull },
+    { 0xF5185489D68AE39Cull, 0x129B69070816E2FDull }, { 0xEE8D540FBDAB05C6ull, 0x1DC574D80CF16B2Full },
+    { 0xBED77672FE226B05ull, 0x17D12A4670C1228Cull }, { 0xFF12C528CB4EBC04ull, 0x130DBB6B8D674ED6ull },
+    { 0xCB513B74787DF9A0ull, 0x1E7C5F127BD87E24ull }, { 0x090DC929F9FE614Dull, 0x18637F41FCAD31B7ull },
+    { 0xA0D7D42194CB810Aull, 0x1382CC34CA2427C5ull }, { 0x67BFB9CF5478CE77ull, 0x1F37AD21436D0C6Full },
+    { 0x1FCC94A5DD2D71F9ull, 0x18F9574DCF8A7059ull }, { 0x7FD6DD517DBDF4C7ull, 0x13FAAC3E3FA1F37Aull },
+    { 0xFFBE2EE8C92FEE0Bull, 0x1FF779FD329CB8C3ull }, { 0x6631BF20A0F324D6ull, 0x1992C7FDC216FA36ull },
+    { 0xB827CC1A1A5C1D78ull, 0x14756CCB01ABFB5Eull }, { 0x935309AE7B7CE460ull, 0x105DF0A267BCC918ull },
+    { 0x1EEB42B0C594A099ull, 0x1A2FE76A3F9474F4ull }, { 0xE58902270476E6E1ull, 0x14F31F8832DD2A5Cull },
+    { 0xB7A0CE859D2BEBE7ull, 0x10C27FA028B0EEB0ull }, { 0x59014A6F61DFDFD8ull, 0x1AD0CC33744E4AB4ull },
+    { 0xE0CDD525E7E64CADull, 0x1573D68F903EA229ull }, { 0x4D7177518651D6F1ull, 0x11297872D9CBB4EEull },
+    { 0x7BE8BEE8D6E957E8ull, 0x1B758D848FAC54B0ull }, { 0xFCBA3253DF211320ull, 0x15F7A46A0C89DD59ull },
+    { 0x63C8284318E74280ull, 0x1192E9EE706E4AAEull }, { 0x060D0D3827D86A66ull, 0x1C1E43171A4A1117ull },
+    { 0x6B3DA42CECAD21EBull, 0x167E9C127B6E7412ull }, { 0x88FE1CF0BD574E56ull, 0x11FEE341FC585CDBull },
+    { 0x419694B462254A23ull, 0x1CCB0536608D615Full }, { 0x67ABAA29E81DD4E9ull, 0x1708D0F84D3DE77Full },
+    { 0xB95621BB2017DD87ull, 0x126D73F9D764B932ull }, { 0xC223692B668C95A5ull, 0x1D7BECC2F23AC1EAull },
+    { 0xCE82BA891ED6DE1Dull, 0x179657025B6234BBull }, { 0xA53562074BDF1818ull, 0x12DEAC01E2B4F6FCull },
+    { 0x3B889CD87964F359ull, 0x1E3113363787F194ull }, { 0xFC6D4A46C783F5E1ull, 0x18274291C6065ADCull },
+    { 0x30576E9F06032B1Aull, 0x13529BA7D19EAF17ull }, { 0x1A257DCB3CD1DE90ull, 0x1EEA92A61C311825ull },
+    { 0x481DFE3C30A7E540ull, 0x18BBA884E35A79B7ull }, { 0xD34B31C9C0865100ull, 0x13C9539D82AEC7C5ull },
+    { 0x5211E942CDA3B4CDull, 0x1FA885C8D117A609ull }, { 0x74DB21023E1C90A4ull, 0x19539E3A40DFB807ull },
+    { 0xF715B401CB4A0D50ull, 0x1442E4FB67196005ull }, { 0xF8DE299B09080AA7ull, 0x103583FC527AB337ull },
+    { 0x8E304291A80CDDD7ull, 0x19EF3993B72AB859ull }, { 0x3E8D020E200A4B13ull, 0x14BF6142F8EEF9E1ull },
+    { 0x653D9B3E80083C0Full, 0x10991A9BFA58C7E7ull }, { 0x6EC8F864000D2CE4ull, 0x1A8E90F9908E0CA5ull },
+    { 0x8BD3F9E999A423EAull, 0x153EDA614071A3B7ull }, { 0x3CA994BAE1501CBBull, 0x10FF151A99F482F9ull },
+    { 0xC775BAC49BB3612Bull, 0x1B31BB5DC320D18Eull }, { 0xD2C4956A16291A89ull, 0x15C162B168E70E0Bull },
+    { 0xDBD0778811BA7BA1ull, 0x11678227871F3E6Full }, { 0x2C80BF401C5D929Bull, 0x1BD8D03F3E9863E6ull },
+    { 0xBD33CC3349E47549ull, 0x16470CFF6546B651ull }, { 0xCA8FD68F6E505DD4ull, 0x11D270CC51055EA7ull },
+    { 0x4419574BE3B3C953ull, 0x1C83E7AD4E6EFDD9ull }, { 0x0347790982F63AA9ull, 0x16CFEC8AA52597E1ull },
+    { 0xCF6C60D468C4FBBAull, 0x123FF06EEA847980ull }, { 0xE57A34870E07F92Aull, 0x1D331A4B10D3F59Aull },
+    { 0x512E906C0B399422ull, 0x175C1508DA432AE2ull }, { 0xDA8BA6BCD5C7A9B5ull, 0x12B010D3E1CF5581ull },
+    { 0x90DF712E22D90F87ull, 0x1DE6815302E5559Cull }, { 0xDA4C5A8B4F140C6Cull, 0x17EB9AA8CF1DDE16ull },
+    { 0xAEA37BA2A5A9A38Aull, 0x1322E220A5B17E78ull }, { 0x7DD25F6AA2A905A9ull, 0x1E9E369AA2B59727ull },
+    { 0x97DB7F888220D154ull, 0x187E92154EF7AC1Full }, { 0x797C6606CE80A777ull, 0x139874DDD8C6234Cull },
+    { 0x8F2D700AE4010BF1ull, 0x1F5A549627A36BADull }, { 0x0C2459A25000D65Aull, 0x191510781FB5EFBEull },
+    { 0x701D1481D99A4515ull, 0x1410D9F9B2F7F2FEull }, { 0xC017439B147B6A77ull, 0x100D7B2E28C65BFEull },
+    { 0xCCF205C4ED9243F2ull, 0x19AF2B7D0E0A2CCAull }, { 0x0A5B37D0BE0E9CC2ull, 0x148C22CA71A1BD6Full },
+    { 0x0848F973CB3EE3CEull, 0x10701BD527B4978Cull }, { 0xDA0E5BEC78649FB0ull, 0x1A4CF9550C5425ACull },
+    { 0x7B3EAFF060507FC0ull, 0x150A6110D6A9B7BDull }, { 0x95CBBFF380406633ull, 0x10D51A73DEEE2C97ull },
+    { 0xEFAC665266CD7052ull, 0x1AEE90B964B04758ull }, { 0x2623850EB8A459DBull, 0x158BA6FAB6F36C47ull },
+    { 0x1E82D0D893B6AE49ull, 0x113C85955F29236Cull }, { 0xFD9E1AF41F8AB075ull, 0x1B9408EEFEA838ACull },
+    { 0x97B1AF29B2D559F7ull, 0x16100725988693BDull }, { 0xAC8E25BAF5777B2Cull, 0x11A66C1E139EDC97ull },
+    { 0x7A7D092B2258C513ull, 0x1C3D79C9B8FE2DBFull }, { 0x61FDA0EF4EAD6A76ull, 0x169794A160CB57CCull },
+    { 0xE7FE1A590BBDEEC5ull, 0x1212DD4DE7091309ull }, { 0xA6635D5B45FCB13Aull, 0x1CEAFBAFD80E84DCull },
+    { 0x851C4AAF6B308DC8ull, 0x172262F3133ED0B0ull }, { 0xD0E36EF2BC26D7D4ull, 0x1281E8C275CBDA26ull },
+    { 0xB49F17EAC6A48C86ull, 0x1D9CA79D894629D7ull }, { 0x2A18DFEF0550706Bull, 0x17B08617A104EE46ull },
+    { 0x54E0B3259DD9F389ull, 0x12F39E794D9D8B6Bull }, { 0x87CDEB6F62F65274ull, 0x1E5297287C2F4578ull },
+    { 0xD30B22BF825EA85Dull, 0x18421286C9BF6AC6ull }, { 0x0F3C1BCC684BB9E4ull, 0x13680ED23AFF889Full },
+    { 0x18602C7A4079296Dull, 0x1F0CE4839198DA98ull }, { 0x46B356C833942124ull, 0x18D71D360E13E213ull },
+    { 0x388F78A029434DB6ull, 0x13DF4A91A4DCB4DCull }, { 0x5A7F2766A86BAF8Aull, 0x1FCBAA82A1612160ull },
+    { 0x153285EBB9EFBFA2ull, 0x196FBB9BB44DB44Dull }, { 0xAA8ED189618C994Eull, 0x145962E2F6A4903Dull },
+    { 0xEED8A7A11AD6E10Cull, 0x1047824F2BB6D9CAull }, { 0x7E27729B5E249B45ull, 0x1A0C03B1DF8AF611ull },
+    { 0xFE85F549181D4904ull, 0x14D6695B193BF80Dull }, { 0xCB9E5DD4134AA0D0ull, 0x10AB877C142FF9A4ull },
+    { 0xDF63C9535211014Dull, 0x1AAC0BF9B9E65C3Aull }, { 0x191CA10F74DA6771ull, 0x15566FFAFB1EB02Full },
+    { 0xADB080D92A4852C1ull, 0x1111F32F2F4BC025ull }, { 0x15E7348EAA0D5134ull, 0x1B4FEB7EB212CD09ull },
+    { 0xAB1F5D3EEE710DC4ull, 0x15D98932280F0A6Dull }, { 0xBC1917658B8DA49Dull, 0x117AD428200C0857ull },
+    { 0x2CF4F23C127C3A94ull, 0x1BF7B9D9CCE00D59ull }, { 0xF0C3F4FCDB969543ull, 0x165FC7E170B33DE0ull },
+    { 0x5A365D9716121103ull, 0x11E6398126F5CB1Aull }, { 0x9056FC24F01CE804ull, 0x1CA38F350B22DE90ull },
+    { 0xD9DF301D8CE3ECD0ull, 0x16E93F5DA2824BA6ull }, { 0xE17F59B13D8323DAull, 0x125432B14ECEA2EBull },
+    { 0x68CBC2B52F38395Cull, 0x1D53844EE47DD179ull }, { 0x53D6355DBF602DE3ull, 0x177603725064A794ull },
+    { 0xA9782AB165E68B1Cull, 0x12C4CF8EA6B6EC76ull }, { 0x0F26AAB56FD744FAull, 0x1E07B27DD78B13F1ull },
+    { 0x3F52222ABFDF6A62ull, 0x18062864AC6F4327ull }, { 0x65DB4E88997F884Eull, 0x1338205089F29C1Full },
+    { 0x6FC54A7428CC0D4Aull, 0x1EC033B40FEA9365ull }, { 0x596AA1F68709A43Bull, 0x1899C2F673220F84ull },
+    { 0xADEEE7F86C07B696ull, 0x13AE3591F5B4D936ull }, { 0x497E3FF3E00C5756ull, 0x1F7D228322BAF524ull },
+    { 0xD464FFF64CD6AC45ull, 0x1930E868E89590E9ull }, { 0x4383FFF83D7889D1ull, 0x14272053ED4473EEull },
+    { 0xCF9CCCC69793A174ull, 0x101F4D0FF1038FF1ull }, { 0x7F6147A425B90252ull, 0x19CBAE7FE805B31Cull },
+    { 0xCC4DD2E9B7C7350Full, 0x14A2F1FFECD15C16ull }, { 0x3D0B0F215FD290D9ull, 0x10825B3323DAB012ull },
+    { 0x61AB4B689950E7C1ull, 0x1A6A2B85062AB350ull }, { 0x4E22A2BA1440B967ull, 0x1521BC6A6B555C40ull },
+    { 0x0B4EE894DD009453ull, 0x10E7C9EEBC4449CDull }, { 0x1217DA87C800ED51ull, 0x1B0C764AC6D3A948ull },
+    { 0xDB46486CA000BDDAull, 0x15A391D56BDC876Cull }, { 0x490506BD4CCD64AFull, 0x114FA7DDEFE39F8Aull },
+    { 0xA8080AC87AE23AB1ull, 0x1BB2A62FE638FF43ull }, { 0x5339A239FBE82EF4ull, 0x162884F31E93FF69ull },
+    { 0x75C7B4FB2FECF25Dull, 0x11BA03F5B20FFF87ull }, { 0x22D92191E647EA2Eull, 0x1C5CD322B67FFF3Full },
+    { 0xB57A8141850654F2ull, 0x16B0A8E891FFFF65ull }, { 0xC4620101373843F5ull, 0x1226ED86DB3332B7ull },
+    { 0x3A366801F1F39FEEull, 0x1D0B15A491EB8459ull }, { 0xFB5EB99B27F6198Bull, 0x173C115074BC69E0ull },
+    { 0x2F7EFAE2865E7AD6ull, 0x129674405D6387E7ull }, { 0xE597F7D0D6FD9156ull, 0x1DBD86CD6238D971ull },
+    { 0x8479930D78CADAABull, 0x17CAD23DE82D7AC1ull }, { 0xD06142712D6F1556ull, 0x1308A831868AC89Aull },
+    { 0x4D686A4EAF182222ull, 0x1E74404F3DAADA91ull }, { 0xA453883EF279B4E8ull, 0x185D003F6488AEDAull },
+    { 0xE9DC6CFF28615D87ull, 0x137D99CC506D58AEull }, { 0xA960AE650D6895A4ull, 0x1F2F5C7A1A488DE4ull },
+    { 0xBAB3BEB73DED4483ull, 0x18F2B061AEA07183ull }, { 0x2EF6322C318A9D36ull, 0x13F559E7BEE6C136ull },
+    { 0xE4BD1D13827761F0ull, 0x1FEEF63F97D79B89ull }, { 0x83CA7DA9352C4E5Aull, 0x198BF832DFDFAFA1ull },
+    { 0x9CA1FE20F756A515ull, 0x146FF9C24CB2F2E7ull }, { 0x4A1B31B3F9121DAAull, 0x1059949B708F28B9ull },
+    { 0x435EB5ECC1B695DDull, 0x1A28EDC580E50DF5ull }, { 0x35E55E57015EDE4Aull, 0x14ED8B04671DA4C4ull },
+    { 0xC4B77EAC0118B1D5ull, 0x10BE08D0527E1D69ull }, { 0xA12597799B5AB622ull, 0x1AC9A7B3B7302F0Full },
+    { 0x4DB7AC6149155E81ull, 0x156E1FC2F8F358D9ull }, { 0xD7C6238107444B9Bull, 0x1124E63593F5E0ADull },
+    { 0x593D059B3ED3AC2Bull, 0x1B6E3D2286563449ull }, { 0xE0FD9E15CBDC89BCull, 0x15F1CA820511C36Dull },
+    { 0xB3FE18116FE3A163ull, 0x118E3B9B37416924ull }, { 0x866359B57FD29BD1ull, 0x1C16C5C525357507ull },
+    { 0xD1E91491330EE30Eull, 0x16789E3750F790D2ull }, { 0x74BA76DA8F3F1C0Bull, 0x11FA182C40C60D75ull },
+    { 0xEDF72490E531C678ull, 0x1CC359E067A348BBull }, { 0x8B2C1D40B75B052Dull, 0x1702AE4D1FB5D3C9ull },
+    { 0x6F567DCD5F7C0424ull, 0x12688B70E62B0FD4ull }, { 0x7EF0C94898C66D06ull, 0x1D74124E3D11B2EDull },
+    { 0x98C0A106E09EBD9Full, 0x17900EA4FDA7C257ull }, { 0x470080D24D4BCAE6ull, 0x12D9A550CAEC9B79ull },
+    { 0xD800CE1D487944A2ull, 0x1E29088144ADC58Eull }, { 0x1333D8176D2DD082ull, 0x1820D39A9D57D13Full },
+    { 0xA8F646792424A6CEull, 0x134D76154AACA765ull }, { 0x74BD3D8EA03AA47Dull, 0x1EE25688777AA56Full },
+    { 0x5D64313EE6955064ull, 0x18B51206C5FBB78Cull }, { 0x4AB68DCBEBAAA6B7ull, 0x13C40E6BD1962C70ull },
+    { 0x1124161312AAA457ull, 0x1FA01712E8F0471Aull }, { 0xDA8344DC0EEEE9DFull, 0x194CDF4253F36C14ull },
+    { 0xE2029D7CD8BF2180ull, 0x143D7F6843292343ull }, { 0x4E687DFD7A328133ull, 0x103132B9CF541C36ull },
+    { 0x4A40C9959050CEB8ull, 0x19E851294BB9C6BDull }, { 0x0833D477A6A70BC6ull, 0x14B9DA876FC7D231ull },
+    { 0xA02976C61EEC096Bull, 0x1094AED2BFD30E8Dull }, { 0x004257A364ACDBDFull, 0x1A877E1DFFB81749ull },
+    { 0xCD01DFB5EA23E319ull, 0x153931B1996012A0ull }, { 0x70CE4C91881CB5AEull, 0x10FA8E27ADE6754Dull },
+    { 0x1AE3ADB5A69455E2ull, 0x1B2A7D0C4970BBAFull }, { 0x7BE957C4854377E8ull, 0x15BB973D078D62F2ull },
+    { 0xC987796A0435F987ull, 0x1162DF64060AB58Eull }, { 0x75A58F1006BCC271ull, 0x1BD1656CD67788E4ull },
+    { 0xF7B7A5A66BCA3527ull, 0x16411DF0AB92D3E9ull }, { 0x5FC61E1EBCA1C41Full, 0x11CDB18D560F0FEEull },
+    { 0xFFA363646102D365ull, 0x1C7C4F4889B1B316ull }, { 0x32E91C504D9BDC51ull, 0x16C9D906D48E28DFull },
+    { 0x8F20E37371497D0Eull, 0x123B140576D820B2ull }, { 0x7E9B0585820F2E7Cull, 0x1D2B533BF159CDEAull },
+    { 0xCBAF379E01A5BECAull, 0x1755DC2FF447D7EEull }, { 0x0958F94B348498A1ull, 0x12AB168CC36CACBFull },
+};
+
+static const u64 gPow5Split[326][2] =
+{
+    { 0x0000000000000000ull, 0x1000000000000000ull }, { 0x0000000000000000ull, 0x1400000000000000ull },
+    { 0x0000000000000000ull, 0x1900000000000000ull }, { 0x0000000000000000ull, 0x1F40000000000000ull },
+    { 0x0000000000000000ull, 0x1388000000000000ull }, { 0x0000000000000000ull, 0x186A000000000000ull },
+    { 0x0000000000000000ull, 0x1E84800000000000ull }, { 0x0000000000000000ull, 0x1312D00000000000ull },
+    { 0x0000000000000000ull, 0x17D7840000000000ull }, { 0x0000000000000000ull, 0x1DCD650000000000ull },
+    { 0x0000000000000000ull, 0x12A05F2000000000ull }, { 0x0000000000000000ull, 0x174876E800000000ull },
+    { 0x0000000000000000ull, 0x1D1A94A200000000ull }, { 0x0000000000000000ull, 0x12309CE540000000ull },
+    { 0x0000000000000000ull, 0x16BCC41E90000000ull }, { 0x0000000000000000ull, 0x1C6BF52634000000ull },
+    { 0x0000000000000000ull, 0x11C37937E0800000ull }, { 0x0000000000000000ull, 0x16345785D8A00000ull },
+    { 0x0000000000000000ull, 0x1BC16D674EC80000ull }, { 0x0000000000000000ull, 0x1158E460913D0000ull },
+    { 0x0000000000000000ull, 0x15AF1D78B58C4000ull }, { 0x0000000000000000ull, 0x1B1AE4D6E2EF5000ull },
+    { 0x0000000000000000ull, 0x10F0CF064DD59200ull }, { 0x0000000000000000ull, 0x152D02C7E14AF680ull },
+    { 0x0000000000000000ull, 0x1A784379D99DB420ull }, { 0x0000000000000000ull, 0x108B2A2C28029094ull },
+    { 0x0000000000000000ull, 0x14ADF4B7320334B9ull }, { 0x4000000000000000ull, 0x19D971E4FE8401E7ull },
+    { 0x8800000000000000ull, 0x1027E72F1F128130ull }, { 0xAA00000000000000ull, 0x1431E0FAE6D7217Cull },
+    { 0xD480000000000000ull, 0x193E5939A08CE9DBull }, { 0xC9A0000000000000ull, 0x1F8DEF8808B02452ull },
+    { 0xBE04000000000000ull, 0x13B8B5B5056E16B3ull }, { 0xAD85000000000000ull, 0x18A6E32246C99C60ull },
+    { 0xD8E6400000000000ull, 0x1ED09BEAD87C0378ull }, { 0x878FE80000000000ull, 0x13426172C74D822Bull },
+    { 0x6973E20000000000ull, 0x1812F9CF7920E2B6ull }, { 0x03D0DA8000000000ull, 0x1E17B84357691B64ull },
+    { 0x8262889000000000ull, 0x12CED32A16A1B11Eull }, { 0x22FB2AB400000000ull, 0x178287F49C4A1D66ull },
+    { 0xABB9F56100000000ull, 0x1D6329F1C35CA4BFull }, { 0xCB54395CA0000000ull, 0x125DFA371A19E6F7ull },
+    { 0xBE2947B3C8000000ull, 0x16F578C4E0A060B5ull }, { 0x2DB399A0BA000000ull, 0x1CB2D6F618C878E3ull },
+    { 0xFC90400474400000ull, 0x11EFC659CF7D4B8Dull }, { 0x7BB4500591500000ull, 0x166BB7F0435C9E71ull },
+    { 0xDAA16406F5A40000ull, 0x1C06A5EC5433C60Dull }, { 0xA8A4DE8459868000ull, 0x118427B3B4A05BC8ull },
+    { 0xD2CE16256FE82000ull, 0x15E531A0A1C872BAull }, { 0x87819BAECBE22800ull, 0x1B5E7E08CA3A8F69ull },
+    { 0xF4B1014D3F6D5900ull, 0x111B0EC57E6499A1ull }, { 0x71DD41A08F48AF40ull, 0x1561D276DDFDC00Aull },
+    { 0x0E549208B31ADB10ull, 0x1ABA4714957D300Dull }, { 0x28F4DB456FF0C8EAull, 0x10B46C6CDD6E3E08ull },
+    { 0x33321216CBECFB24ull, 0x14E1878814C9CD8Aull }, { 0xBFFE969C7EE839EDull, 0x1A19E96A19FC40ECull },
+    { 0xF7FF1E21CF512434ull, 0x105031E2503DA893ull }, { 0xF5FEE5AA43256D41ull, 0x14643E5AE44D12B8ull },
+    { 0x337E9F14D3EEC892ull, 0x197D4DF19D605767ull }, { 0x005E46DA08EA7AB6ull, 0x1FDCA16E04B86D41ull },
+    { 0xA03AEC4845928CB2ull, 0x13E9E4E4C2F34448ull }, { 0xC849A75A56F72FDEull, 0x18E45E1DF3B0155Aull },
+    { 0x7A5C1130ECB4FBD6ull, 0x1F1D75A5709C1AB1ull }, { 0xEC798ABE93F11D65ull, 0x13726987666190AEull },
+    { 0xA797ED6E38ED64BFull, 0x184F03E93FF9F4DAull }, { 0x517DE8C9C728BDEFull, 0x1E62C4E38FF87211ull },
+    { 0xD2EEB17E1C7976B5ull, 0x12FDBB0E39FB474Aull }, { 0x87AA5DDDA397D462ull, 0x17BD29D1C87A191Dull },
+    { 0xE994F5550C7DC97Bull, 0x1DAC74463A989F64ull }, { 0x11FD195527CE9DEDull, 0x128BC8ABE49F639Full },
+    { 0xD67C5FAA71C24568ull, 0x172EBAD6DDC73C86ull }, { 0x8C1B77950E32D6C2ull, 0x1CFA698C95390BA8ull },
+    { 0x57912ABD28DFC639ull, 0x121C81F7DD43A749ull }, { 0xAD75756C7317B7C8ull, 0x16A3A275D494911Bull },
+    { 0x98D2D2C78FDDA5BAull, 0x1C4C8B1349B9B562ull }, { 0x9F83C3BCB9EA8794ull, 0x11AFD6EC0E14115Dull },
+    { 0x0764B4ABE8652979ull, 0x161BCCA7119915B5ull }, { 0x493DE1D6E27E73D7ull, 0x1BA2BFD0D5FF5B22ull },
+    { 0x6DC6AD264D8F0866ull, 0x1145B7E285BF98F5ull }, { 0xC938586FE0F2CA80ull, 0x159725DB272F7F32ull },
+    { 0x7B866E8BD92F7D20ull, 0x1AFCEF51F0FB5EFFull }, { 0xAD34051767BDAE34ull, 0x10DE1593369D1B5Full },
+    { 0x9881065D41AD19C1ull, 0x15159AF804446237ull }, { 0x7EA147F492186032ull, 0x1A5B01B605557AC5ull },
+    { 0x6F24CCF8DB4F3C1Full, 0x1078E111C3556CBBull }, { 0x4AEE003712230B27ull, 0x14971956342AC7EAull },
+    { 0xDDA98044D6ABCDF0ull, 0x19BCDFABC13579E4ull }, { 0x0A89F02B062B60B6ull, 0x10160BCB58C16C2Full },
+    { 0xCD2C6C35C7B638E4ull, 0x141B8EBE2EF1C73Aull }, { 0x8077874339A3C71Dull, 0x1922726DBAAE3909ull },
+    { 0xE0956914080CB8E4ull, 0x1F6B0F092959C74Bull }, { 0x6C5D61AC8507F38Eull, 0x13A2E965B9D81C8Full },
+    { 0x4774BA17A649F072ull, 0x188BA3BF284E23B3ull }, { 0x1951E89D8FDC6C8Full, 0x1EAE8CAEF261ACA0ull },
+    { 0x0FD3316279E9C3D9ull, 0x132D17ED577D0BE4ull }, { 0x13C7FDBB186434CFull, 0x17F85DE8AD5C4EDDull },
+    { 0x58B9FD29DE7D4203ull, 0x1DF67562D8B36294ull }, { 0xB7743E3A2B0E4942ull, 0x12BA095DC7701D9Cull },
+    { 0xE5514DC8B5D1DB92ull, 0x17688BB5394C2503ull }, { 0xDEA5A13AE3465277ull, 0x1D42AEA2879F2E44ull },
+    { 0x0B2784C4CE0BF38Aull, 0x1249AD2594C37CEBull }, { 0xCDF165F6018EF06Dull, 0x16DC186EF9F45C25ull },
+    { 0x416DBF7381F2AC88ull, 0x1C931E8AB871732Full }, { 0x88E497A83137ABD5ull, 0x11DBF316B346E7FDull },
+    { 0xEB1DBD923D8596CAull, 0x1652EFDC6018A1FCull }, { 0x25E52CF6CCE6FC7Dull, 0x1BE7ABD3781ECA7Cull },
+    { 0x97AF3C1A40105DCEull, 0x1170CB642B133E8Dull }, { 0xFD9B0B20D0147542ull, 0x15CCFE3D35D80E30ull },
+    { 0x3D01CDE904199292ull, 0x1B403DCC834E11BDull }, { 0x462120B1A28FFB9Bull, 0x1108269FD210CB16ull },
+    { 0xD7A968DE0B33FA82ull, 0x154A3047C694FDDBull }, { 0xCD93C3158E00F923ull, 0x1A9CBC59B83A3D52ull },
+    { 0xC07C59ED78C09BB6ull, 0x10A1F5B813246653ull }, { 0xB09B7068D6F0C2A3ull, 0x14CA732617ED7FE8ull },
+    { 0xDCC24C830CACF34Cull, 0x19FD0FEF9DE8DFE2ull }, { 0xC9F96FD1E7EC180Full, 0x103E29F5C2B18BEDull },
+    { 0x3C77CBC661E71E13ull, 0x144DB473335DEEE9ull }, { 0x8B95BEB7FA60E598ull, 0x1961219000356AA3ull },
+    { 0x6E7B2E65F8F91EFEull, 0x1FB969F40042C54Cull }, { 0xC50CFCFFBB9BB35Full, 0x13D3E2388029BB4Full },
+    { 0xB6503C3FAA82A037ull, 0x18C8DAC6A0342A23ull }, { 0xA3E44B4F95234844ull, 0x1EFB1178484134ACull },
+    { 0xE66EAF11BD360D2Bull, 0x135CEAEB2D28C0EBull }, { 0xE00A5AD62C839075ull, 0x183425A5F872F126ull },
+    { 0x980CF18BB7A47493ull, 0x1E412F0F768FAD70ull }, { 0x5F0816F752C6C8DCull, 0x12E8BD69AA19CC66ull },
+    { 0xF6CA1CB527787B13ull, 0x17A2ECC414A03F7Full }, { 0xF47CA3E2715699D7ull, 0x1D8BA7F519C84F5Full },
+    { 0xF8CDE66D86D62026ull, 0x127748F9301D319Bull }, { 0xF7016008E88BA830ull, 0x17151B377C247E02ull },
+    { 0xB4C1B80B22AE923Cull, 0x1CDA62055B2D9D83ull }, { 0x50F91306F5AD1B65ull, 0x12087D4358FC8272ull },
+    { 0xE53757C8B318623Full, 0x168A9C942F3BA30Eull }, { 0x9E852DBADFDE7ACFull, 0x1C2D43B93B0A8BD2ull },
+    { 0xA3133C94CBEB0CC1ull, 0x119C4A53C4E69763ull }, { 0x8BD80BB9FEE5CFF1ull, 0x16035CE8B6203D3Cull },
+    { 0xAECE0EA87E9F43EEull, 0x1B843422E3A84C8Bull }, { 0x4D40C9294F238A75ull, 0x1132A095CE492FD7ull },
+    { 0x2090FB73A2EC6D12ull, 0x157F48BB41DB7BCDull }, { 0x68B53A508BA78856ull, 0x1ADF1AEA12525AC0ull },
+    { 0x417144725748B536ull, 0x10CB70D24B7378B8ull }, { 0x51CD958EED1AE283ull, 0x14FE4D06DE5056E6ull },
+    { 0xE640FAF2A8619B24ull, 0x1A3DE04895E46C9Full }, { 0xEFE89CD7A93D00F7ull, 0x1066AC2D5DAEC3E3ull },
+    { 0xEBE2C40D938C4134ull, 0x14805738B51A74DCull }, { 0x26DB7510F86F5181ull, 0x19A06D06E2611214ull },
+    { 0x9849292A9B4592F1ull, 0x100444244D7CAB4Cull }, { 0xBE5B73754216F7ADull, 0x1405552D60DBD61Full },
+    { 0xADF25052929CB598ull, 0x1906AA78B912CBA7ull }, { 0x996EE4673743E2FFull, 0x1F485516E7577E91ull },
+    { 0xFFE54EC0828A6DDFull, 0x138D352E5096AF1Aull }, { 0xBFDEA270A32D0957ull, 0x18708279E4BC5AE1ull },
+    { 0x2FD64B0CCBF84BADull, 0x1E8CA3185DEB719Aull }, { 0x5DE5EEE7FF7B2F4Cull, 0x1317E5EF3AB32700ull },
+    { 0x755F6AA1FF59FB1Full, 0x17DDDF6B095FF0C0ull }, { 0x92B7454A7F3079E7ull, 0x1DD55745CBB7ECF0ull },
+    { 0x5BB28B4E8F7E4C30ull, 0x12A5568B9F52F416ull }, { 0xF29F2E22335DDF3Cull, 0x174EAC2E8727B11Bull },
+    { 0xEF46F9AAC035570Bull, 0x1D22573A28F19D62ull }, { 0xD58C5C0AB8215667ull, 0x123576845997025Dull },
+    { 0x4AEF730D6629AC01ull, 0x16C2D4256FFCC2F5ull }, { 0x9DAB4FD0BFB41701ull, 0x1C73892ECBFBF3B2ull },
+    { 0xA28B11E277D08E60ull, 0x11C835BD3F7D784Full }, { 0x8B2DD65B15C4B1F9ull, 0x163A432C8F5CD663ull },
+    { 0x6DF94BF1DB35DE77ull, 0x1BC8D3F7B3340BFCull }, { 0xC4BBCF772901AB0Aull, 0x115D847AD000877Dull },
+    { 0x35EAC354F34215CDull, 0x15B4E5998400A95Dull }, { 0x8365742A30129B40ull, 0x1B221EFFE500D3B4ull },
+    { 0xD21F689A5E0BA108ull, 0x10F5535FEF208450ull }, { 0x06A742C0F58E894Aull, 0x1532A837EAE8A565ull },
+    { 0x4851137132F22B9Dull, 0x1A7F5245E5A2CEBEull }, { 0xED32AC26BFD75B42ull, 0x108F936BAF85C136ull },
+    { 0xA87F57306FCD3212ull, 0x14B378469B673184ull }, { 0xD29F2CFC8BC07E97ull, 0x19E056584240FDE5ull },
+    { 0xA3A37C1DD7584F1Eull, 0x102C35F729689EAFull }, { 0x8C8C5B254D2E62E6ull, 0x14374374F3C2C65Bull },
+    { 0x6FAF71EEA079FB9Full, 0x1945145230B377F2ull }, { 0x0B9B4E6A48987A87ull, 0x1F965966BCE055EFull },
+    { 0x674111026D5F4C94ull, 0x13BDF7E0360C35B5ull }, { 0xC111554308B71FBAull, 0x18AD75D8438F4322ull },
+    { 0x7155AA93CAE4E7A8ull, 0x1ED8D34E547313EBull }, { 0x26D58A9C5ECF10C9ull, 0x13478410F4C7EC73ull },
+    { 0xF08AED437682D4FBull, 0x1819651531F9E78Full }, { 0xECADA89454238A3Aull, 0x1E1FBE5A7E786173ull },
+    { 0x73EC895CB4963664ull, 0x12D3D6F88F0B3CE8ull }, { 0x90E7ABB3E1BBC3FDull, 0x1788CCB6B2CE0C22ull },
+    { 0x352196A0DA2AB4FDull, 0x1D6AFFE45F818F2Bull }, { 0x0134FE24885AB11Eull, 0x1262DFEEBBB0F97Bull },
+    { 0xC1823DADAA715D65ull, 0x16FB97EA6A9D37D9ull }, { 0x31E2CD19150DB4BFull, 0x1CBA7DE5054485D0ull },
+    { 0x1F2DC02FAD2890F7ull, 0x11F48EAF234AD3A2ull }, { 0xA6F9303B9872B535ull, 0x1671B25AEC1D888Aull },
+    { 0x50B77C4A7E8F6282ull, 0x1C0E1EF1A724EAADull }, { 0x5272ADAE8F199D91ull, 0x1188D357087712ACull },
+    { 0x670F591A32E004F6ull, 0x15EB082CCA94D757ull }, { 0x40D32F60BF980633ull, 0x1B65CA37FD3A0D2Dull },
+    { 0x4883FD9C77BF03E0ull, 0x111F9E62FE44483Cull }, { 0x5AA4FD0395AEC4D8ull, 0x156785FBBDD55A4Bull },
+    { 0x314E3C447B1A760Eull, 0x1AC1677AAD4AB0DEull }, { 0xDED0E5AACCF089C9ull, 0x10B8E0ACAC4EAE8Aull },
+    { 0x96851F15802CAC3Bull, 0x14E718D7D7625A2Dull }, { 0xFC2666DAE037D74Aull, 0x1A20DF0DCD3AF0B8ull },
+    { 0x9D980048CC22E68Eull, 0x10548B68A044D673ull }, { 0x84FE005AFF2BA032ull, 0x1469AE42C8560C10ull },
+    { 0xA63D8071BEF6883Eull, 0x198419D37A6B8F14ull }, { 0xCFCCE08E2EB42A4Eull, 0x1FE52048590672D9ull },
+    { 0x21E00C58DD309A70ull, 0x13EF342D37A407C8ull }, { 0x2A580F6F147CC10Dull, 0x18EB0138858D09BAull },
+    { 0xB4EE134AD99BF150ull, 0x1F25C186A6F04C28ull }, { 0x7114CC0EC80176D2ull, 0x137798F428562F99ull },
+    { 0xCD59FF127A01D486ull, 0x18557F31326BBB7Full }, { 0xC0B07ED7188249A8ull, 0x1E6ADEFD7F06AA5Full },
+    { 0xD86E4F466F516E09ull, 0x1302CB5E6F642A7Bull }, { 0xCE89E3180B25C98Bull, 0x17C37E360B3D351Aull },
+    { 0x822C5BDE0DEF3BEEull, 0x1DB45DC38E0C8261ull }, { 0xF15BB96AC8B58575ull, 0x1290BA9A38C7D17Cull },
+    { 0x2DB2A7C57AE2E6D2ull, 0x1734E940C6F9C5DCull }, { 0x391F51B6D99BA086ull, 0x1D022390F8B83753ull },
+    { 0x03B3931248014454ull, 0x1221563A9B732294ull }, { 0x04A077D6DA019569ull, 0x16A9ABC9424FEB39ull },
+    { 0x45C895CC9081FAC3ull, 0x1C5416BB92E3E607ull }, { 0x8B9D5D9FDA513CBAull, 0x11B48E353BCE6FC4ull },
+    { 0xAE84B507D0E58BE8ull, 0x1621B1C28AC20BB5ull }, { 0x1A25E249C51EEEE3ull, 0x1BAA1E332D728EA3ull },
+    { 0xF057AD6E1B33554Dull, 0x114A52DFFC679925ull }, { 0x6C6D98C9A2002AA1ull, 0x159CE797FB817F6Full },
+    { 0x4788FEFC0A803549ull, 0x1B04217DFA61DF4Bull }, { 0x0CB59F5D8690214Eull, 0x10E294EEBC7D2B8Full },
+    { 0xCFE30734E83429A1ull, 0x151B3A2A6B9C7672ull }, { 0x83DBC9022241340Aull, 0x1A6208B50683940Full },
+    { 0xB2695DA15568C086ull, 0x107D457124123C89ull }, { 0x1F03B509AAC2F0A7ull, 0x149C96CD6D16CBACull },
+    { 0x26C4A24C1573ACD1ull, 0x19C3BC80C85C7E97ull }, { 0x783AE56F8D684C03ull, 0x101A55D07D39CF1Eull },
+    { 0x16499ECB70C25F03ull, 0x1420EB449C8842E6ull }, { 0x9BDC067E4CF2F6C4ull, 0x19292615C3AA539Full },
+    { 0x82D3081DE02FB476ull, 0x1F736F9B3494E887ull }, { 0xB1C3E512AC1DD0C9ull, 0x13A825C100DD1154ull },
+    { 0xDE34DE57572544FCull, 0x18922F31411455A9ull }, { 0x55C215ED2CEE963Bull, 0x1EB6BAFD91596B14ull },
+    { 0xB5994DB43C151DE5ull, 0x133234DE7AD7E2ECull }, { 0xE2FFA1214B1A655Eull, 0x17FEC216198DDBA7ull },
+    { 0xDBBF89699DE0FEB6ull, 0x1DFE729B9FF15291ull }, { 0x2957B5E202AC9F31ull, 0x12BF07A143F6D39Bull },
+    { 0xF3ADA35A8357C6FEull, 0x176EC98994F48881ull }, { 0x70990C31242DB8BDull, 0x1D4A7BEBFA31AAA2ull },
+    { 0x865FA79EB69C9376ull, 0x124E8D737C5F0AA5ull }, { 0xE7F791866443B854ull, 0x16E230D05B76CD4Eull },
+    { 0xA1F575E7FD54A669ull, 0x1C9ABD04725480A2ull }, { 0xA53969B0FE54E801ull, 0x11E0B622C774D065ull },
+    { 0x0E87C41D3DEA2202ull, 0x1658E3AB7952047Full }, { 0xD229B5248D64AA82ull, 0x1BEF1C9657A6859Eull },
+    { 0x435A1136D85EEA91ull, 0x117571DDF6C81383ull }, { 0x143095848E76A536ull, 0x15D2CE55747A1864ull },
+    { 0x193CBAE5B2144E83ull, 0x1B4781EAD1989E7Dull }, { 0x2FC5F4CF8F4CB112ull, 0x110CB132C2FF630Eull },
+    { 0xBBB77203731FDD56ull, 0x154FDD7F73BF3BD1ull }, { 0x2AA54E844FE7D4ACull, 0x1AA3D4DF50AF0AC6ull },
+    { 0xDAA75112B1F0E4EBull, 0x10A6650B926D66BBull }, { 0xD15125575E6D1E26ull, 0x14CFFE4E7708C06Aull },
+    { 0x85A56EAD360865B0ull, 0x1A03FDE214CAF085ull }, { 0x7387652C41C53F8Eull, 0x10427EAD4CFED653ull },
+    { 0x50693E7752368F71ull, 0x14531E58A03E8BE8ull }, { 0x64838E1526C4334Eull, 0x1967E5EEC84E2EE2ull },
+    { 0xFDA4719A70754022ull, 0x1FC1DF6A7A61BA9Aull }, { 0xDE86C70086494815ull, 0x13D92BA28C7D14A0ull },
+    { 0x162878C0A7DB9A1Aull, 0x18CF768B2F9C59C9ull }, { 0x5BB296F0D1D280A1ull, 0x1F03542DFB83703Bull },
+    { 0x194F9E5683239064ull, 0x1362149CBD322625ull }, { 0x5FA385EC23EC747Eull, 0x183A99C3EC7EAFAEull },
+    { 0xF78C67672CE7919Dull, 0x1E494034E79E5B99ull }, { 0x3AB7C0A07C10BB02ull, 0x12EDC82110C2F940ull },
+    { 0x4965B0C89B14E9C3ull, 0x17A93A2954F3B790ull }, { 0x5BBF1CFAC1DA2433ull, 0x1D9388B3AA30A574ull },
+    { 0xB957721CB92856A0ull, 0x127C35704A5E6768ull }, { 0xE7AD4EA3E7726C48ull, 0x171B42CC5CF60142ull },
+    { 0xA198A24CE14F075Aull, 0x1CE2137F74338193ull }, { 0x44FF65700CD16498ull, 0x120D4C2FA8A030FCull },
+    { 0x563F3ECC1005BDBEull, 0x16909F3B92C83D3Bull }, { 0x2BCF0E7F14072D2Eull, 0x1C34C70A777A4C8Aull },
+    { 0x5B61690F6C847C3Dull, 0x11A0FC668AAC6FD6ull }, { 0xF239C35347A59B4Cull, 0x16093B802D578BCBull },
+    { 0xEEC83428198F021Full, 0x1B8B8A6038AD6EBEull }, { 0x553D20990FF96153ull, 0x1137367C236C6537ull },
+    { 0x2A8C68BF53F7B9A8ull, 0x1585041B2C477E85ull }, { 0x752F82EF28F5A812ull, 0x1AE64521F7595E26ull },
+    { 0x093DB1D57999890Bull, 0x10CFEB353A97DAD8ull }, { 0x0B8D1E4AD7FFEB4Eull, 0x1503E602893DD18Eull },
+    { 0x8E7065DD8DFFE622ull, 0x1A44DF832B8D45F1ull }, { 0xF9063FAA78BFEFD5ull, 0x106B0BB1FB384BB6ull },
+    { 0xB747CF9516EFEBCAull, 0x1485CE9E7A065EA4ull }, { 0xE519C37A5CABE6BDull, 0x19A742461887F64Dull },
+    { 0xAF301A2C79EB7036ull, 0x1008896BCF54F9F0ull }, { 0xDAFC20B798664C43ull, 0x140AABC6C32A386Cull },
+    { 0x11BB28E57E7FDF54ull, 0x190D56B873F4C688ull }, { 0x1629F31EDE1FD72Aull, 0x1F50AC6690F1F82Aull },
+    { 0x4DDA37F34AD3E67Aull, 0x13926BC01A973B1Aull }, { 0xE150C5F01D88E019ull, 0x187706B0213D09E0ull },
+    { 0x19A4F76C24EB181Full, 0x1E94C85C298C4C59ull }, { 0xB0071AA39712EF13ull, 0x131CFD3999F7AFB7ull },
+    { 0x9C08E14C7CD7AAD8ull, 0x17E43C8800759BA5ull }, { 0x030B199F9C0D958Eull, 0x1DDD4BAA0093028Full },
+    { 0x61E6F003C1887D79ull, 0x12AA4F4A405BE199ull }, { 0xBA60AC04B1EA9CD7ull, 0x1754E31CD072D9FFull },
+    { 0xA8F8D705DE65440Dull, 0x1D2A1BE4048F907Full }, { 0xC99B8663AAFF4A88ull, 0x123A516E82D9BA4Full },
+    { 0xBC0267FC95BF1D2Aull, 0x16C8E5CA239028E3ull }, { 0xAB0301FBBB2EE474ull, 0x1C7B1F3CAC74331Cull },
+    { 0xEAE1E13D54FD4EC9ull, 0x11CCF385EBC89FF1ull }, { 0x659A598CAA3CA27Bull, 0x1640306766BAC7EEull },
+    { 0xFF00EFEFD4CBCB1Aull, 0x1BD03C81406979E9ull }, { 0x3F6095F5E4FF5EF0ull, 0x116225D0C841EC32ull },
+    { 0xCF38BB735E3F36ACull, 0x15BAAF44FA52673Eull }, { 0x8306EA5035CF0457ull, 0x1B295B1638E7010Eull },
+    { 0x11E4527221A162B6ull, 0x10F9D8EDE39060A9ull }, { 0x565D670EAA09BB64ull, 0x15384F295C7478D3ull },
+    { 0x2BF4C0D2548C2A3Dull, 0x1A8662F3B3919708ull }, { 0x1B78F88374D79A66ull, 0x1093FDD8503AFE65ull },
+    { 0x625736A4520D8100ull, 0x14B8FD4E6449BDFEull }, { 0xFAED044D6690E140ull, 0x19E73CA1FD5C2D7Dull },
+    { 0xBCD422B0601A8CC8ull, 0x103085E53E599C6Eull }, { 0x6C092B5C78212FFAull, 0x143CA75E8DF0038Aull },
+    { 0x070B763396297BF8ull, 0x194BD136316C046Dull }, { 0x48CE53C07BB3DAF6ull, 0x1F9EC583BDC70588ull },
+    { 0x2D80F4584D5068DAull, 0x13C33B72569C6375ull }, { 0x78E1316E60A48310ull, 0x18B40A4EEC437C52ull },
+};
+
+// @NOTE(Roman): ceil(log2(5^e)) for 0 <= e <= 3528, floor(log10(2^e)) for 0 <= e <= 1650, floor(log10(5^e)) for 0 <= e <= 2620.
+static s32 Pow5Bits(s32 e)  { return static_cast<s32>((static_cast<u32>(e) * 1217359) >> 19) + 1; }
+static u32 Log10Pow2(s32 e) { return (static_cast<u32>(e) * 78913) >> 18;                         }
+static u32 Log10Pow5(s32 e) { return (static_cast<u32>(e) * 732923) >> 20;                        }
+
+static bool MultipleOfPowerOf5(u64 value, u32 p)
+{
+    u32 count = 0;
+    for (; value % 5 == 0; value /= 5) ++count;
+    return count >= p;
+}
+
+static bool MultipleOfPowerOf2(u64 value, u32 p)
+{
+    return !(value & ((1ull << p) - 1));
+}
+
+// @NOTE(Roman): (m * mul) >> j for 64 < j < 128, mul is a 128-bit table entry.
+static u64 MulShift64(u64 m, const u64 *mul, s32 j)
+{
+    u64 low0 = m, high0 = mul[0];
+    u64 low1 = m, high1 = mul[1];
+    Multiply128(&low0, &high0);
+    Multiply128(&low1, &high1);
+
+    u64 middle = high0 + low1;
+    u64 high   = high1 + (middle < high0);
+    u32 shift  = static_cast<u32>(j - 64);
+
+    return (high << (64 - shift)) | (middle >> shift);
+}
+
+// @NOTE(Roman): Shortest decimal digits and their exponent, value = *digits * 10^exponent.
+//               The double is finite and positive.
+static void DoubleToDecimal(u64 mantissa_bits, u32 exponent_bits, u64 *digits, s32 *exponent)
+{
+    // @NOTE(Roman): Integers below 2^53 are exact, only their trailing zeros go to the exponent.
+    if (exponent_bits)
+    {
+        u64 m2 = (1ull << DOUBLE_MANTISSA_BITS) | mantissa_bits;
+        s32 e2 = static_cast<s32>(exponent_bits) - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS;
+
+        if (e2 <= 0 && e2 >= -DOUBLE_MANTISSA_BITS && !(m2 & ((1ull << -e2) - 1)))
+        {
+            u64 value = m2 >> -e2;
+            s32 zeros = 0;
+            for (; value % 10 == 0; value /= 10) ++zeros;
+
+            *digits   = value;
+            *exponent = zeros;
+            return;
+        }
+    }
+
+    s32 e2;
+    u64 m2;
+    if (exponent_bits)
+    {
+        e2 = static_cast<s32>(exponent_bits) - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = (1ull << DOUBLE_MANTISSA_BITS) | mantissa_bits;
+    }
+    else
+    {
+        e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = mantissa_bits;
+    }
+
+    // @NOTE(Roman): Round half to even, so with an even mantissa the bounds themselves round to it too.
+    bool accept_bounds = !(m2 & 1);
+
+    // @NOTE(Roman): The interval is [mm, mp] around mv = 4 * m2 in units of 2^e2,
+    //               it's asymmetric at powers of 2, where the next smaller double is closer.
+    u64 mv       = 4 * m2;
+    u32 mm_shift = mantissa_bits || exponent_bits <= 1;
+
+    u64  vr, vp, vm;
+    s32  e10;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+
+    if (e2 >= 0)
+    {
+        u32 q = Log10Pow2(e2) - (e2 > 3);
+        s32 k = DOUBLE_POW5_INV_BITCOUNT + Pow5Bits(static_cast<s32>(q)) - 1;
+        s32 i = -e2 + static_cast<s32>(q) + k;
+
+        e10 = static_cast<s32>(q);
+        vr  = MulShift64(4 * m2,                gPow5InvSplit[q], i);
+        vp  = MulShift64(4 * m2 + 2,            gPow5InvSplit[q], i);
+        vm  = MulShift64(4 * m2 - 1 - mm_shift, gPow5InvSplit[q], i);
+
+        // @NOTE(Roman): Only here the exact result can end with zeros, which the truncated products don't show.
+        if (q <= 21)
+        {
+            if (mv % 5 == 0)        vr_trailing_zeros  = MultipleOfPowerOf5(mv, q);
+            else if (accept_bounds) vm_trailing_zeros  = MultipleOfPowerOf5(mv - 1 - mm_shift, q);
+            else                    vp                -= MultipleOfPowerOf5(mv + 2, q);
+        }
+    }
+    else
+    {
+        u32 q = Log10Pow5(-e2) - (-e2 > 1);
+        s32 i = -e2 - static_cast<s32>(q);
+        s32 k = Pow5Bits(i) - DOUBLE_POW5_BITCOUNT;
+        s32 j = static_cast<s32>(q) - k;
+
+        e10 = static_cast<s32>(q) + e2;
+        vr  = MulShift64(4 * m2,                gPow5Split[i], j);
+        vp  = MulShift64(4 * m2 + 2,            gPow5Split[i], j);
+        vm  = MulShift64(4 * m2 - 1 - mm_shift, gPow5Split[i], j);
+
+        if (q <= 1)
+        {
+            // @NOTE(Roman): mv = 4 * m2 always has at least 2 trailing zero bits.
+            vr_trailing_zeros = true;
+            if (accept_bounds) vm_trailing_zeros = mm_shift == 1;
+            else               --vp;
+        }
+        else if (q < 63)
+        {
+            vr_trailing_zeros = MultipleOfPowerOf2(mv, q);
+        }
+    }
+
+    s32 removed    = 0;
+    u64 last_digit = 0;
+    u64 output;
+
+    if (vm_trailing_zeros || vr_trailing_zeros)
+    {
+        // @NOTE(Roman): Rare, exact ties and bounds are tracked digit by digit.
+        for (; vp / 10 > vm / 10; ++removed)
+        {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_digit == 0;
+            last_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+
+        if (vm_trailing_zeros)
+        {
+            for (; vm % 10 == 0; ++removed)
+            {
+                vr_trailing_zeros &= last_digit == 0;
+                last_digit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+            }
+        }
+
+        if (vr_trailing_zeros && last_digit == 5 && vr % 2 == 0) last_digit = 4;
+
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_digit >= 5);
+    }
+    else
+    {
+        bool round_up = false;
+
+        if (vp / 100 > vm / 100)
+        {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+
+        for (; vp / 10 > vm / 10; ++removed)
+        {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+
+        output = vr + (vr == vm || round_up);
+    }
+
+    *digits   = output;
+    *exponent = e10 + removed;
+}
+
+// @NOTE(Roman): Fixed notation for decimal exponents from -6 to 20 (0.000001, 123.25, 100000000000000000000),
+//               scientific otherwise (1e-7, 1.5e+300), the same choice JavaScript makes. Non-finite values are nan and inf.
+static u32 FormatDouble(char *out, double value)
+{
+    u64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    u64   mantissa_bits = bits & ((1ull << DOUBLE_MANTISSA_BITS) - 1);
+    u32   exponent_bits = static_cast<u32>(bits >> DOUBLE_MANTISSA_BITS) & ((1u << DOUBLE_EXPONENT_BITS) - 1);
+    char *start         = out;
+
+    if (exponent_bits == (1u << DOUBLE_EXPONENT_BITS) - 1 && mantissa_bits)
+    {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+
+    if (bits >> 63) *out++ = '-';
+
+    if (exponent_bits == (1u << DOUBLE_EXPONENT_BITS) - 1)
+    {
+        memcpy(out, "inf", 3);
+        return static_cast<u32>(out - start) + 3;
+    }
+
+    if (!exponent_bits && !mantissa_bits)
+    {
+        *out = '0';
+        return static_cast<u32>(out - start) + 1;
+    }
+
+    u64 decimal;
+    s32 exponent;
+    DoubleToDecimal(mantissa_bits, exponent_bits, &decimal, &exponent);
+
+    char digits[20];
+    s32  length = static_cast<s32>(FormatUInt(digits, decimal));
+    s32  point  = length + exponent;
+
+    if (point > -6 && point <= 21)
+    {
+        if (point <= 0)
+        {
+            memcpy(out, "0.", 2);
+            memset(out + 2, '0', -point);
+            memcpy(out + 2 - point, digits, length);
+            out += 2 - point + length;
+        }
+        else if (point < length)
+        {
+            memcpy(out, digits, point);
+            out[point] = '.';
+            memcpy(out + point + 1, digits + point, length - point);
+            out += length + 1;
+        }
+        else
+        {
+            memcpy(out, digits, length);
+            memset(out + length, '0', point - length);
+            out += point;
+        }
+    }
+    else
+    {
+        *out++ = digits[0];
+        if (length > 1)
+        {
+            *out++ = '.';
+            memcpy(out, digits + 1, length - 1);
+            out += length - 1;
+        }
+
+        s32 scientific = point - 1;
+        *out++ = 'e';
+        *out++ = scientific < 0 ? '-' : '+';
+        out   += FormatUInt(out, static_cast<u64>(scientific < 0 ? -scientific : scientific));
+    }
+
+    return static_cast<u32>(out - start);
+}
+
+//
+// Number parsing
+//
+// @NOTE(Roman): Digits are taken 8 at a time: a SWAR test finds how many leading bytes of a word are digits,
+//               and three multiplies turn up to 8 of them into a number. Doubles are converted with
+//               the Eisel-Lemire algorithm (fast_float, Lemire 2021): the decimal significand is multiplied
+//               by a tabulated 128-bit approximation of the power of 5, which is always enough
+//               to round correctly for significands of up to 19 digits. Longer ones are truncated
+//               to 19 digits, and if the truncated and the next significand round to different doubles,
+//               strtod in the C locale decides.
+//
+
+#define EIGHT_ZEROS 0x3030303030303030ull
+
+static const u64 gPow10[20] =
+{
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+    10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+    1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+};
+
+static const double gPow10Double[23] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool IsDigit(char symbol)
+{
+    return static_cast<u8>(symbol - '0') < 10;
+}
+
+// @NOTE(Roman): Number of leading digit bytes of 8 little-endian bytes. Digits become 0-9 after the xor,
+//               bit 7 of every other byte gets set by the add, which can't carry into the next byte.
+static u32 LeadingDigits8(u64 chunk)
+{
+    u64 value     = chunk ^ EIGHT_ZEROS;
+    u64 non_digit = (((value & 0x7F7F7F7F7F7F7F7Full) + 0x7676767676767676ull) | value) & 0x8080808080808080ull;
+    return non_digit ? CountTrailingZeros64(non_digit) / 8 : 8;
+}
+
+// @NOTE(Roman): 8 digit bytes, the first one is the lowest byte. Neighbour digits are merged into pairs,
+//               then pairs into fours and fours into the result.
+static u64 EightDigits(u64 chunk)
+{
+    chunk -= EIGHT_ZEROS;
+    chunk  = chunk * 10 + (chunk >> 8);
+    chunk  = ((chunk & 0x000000FF000000FFull) * 0x000F424000000064ull
+           + ((chunk >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull) >> 32;
+    return static_cast<u32>(chunk);
+}
+
+// @NOTE(Roman): Appends the digits at the start of [at, end) to *value, returns where they end.
+//               Overflow wraps, callers that care check the number of digits.
+static const char *ParseDigits(const char *at, const char *end, u64 *value)
+{
+    u64 result = *value;
+
+    for (; end - at >= 8; at += 8)
+    {
+        u64 chunk;
+        memcpy(&chunk, at, sizeof(chunk));
+
+        u32 count = LeadingDigits8(chunk);
+        if (count < 8)
+        {
+            // @NOTE(Roman): The digits are moved to the top and the rest is filled with zeros.
+            if (count) result = result * gPow10[count] + EightDigits((chunk << (64 - 8 * count)) | (EIGHT_ZEROS >> (8 * count)));
+            *value = result;
+            return at + count;
+        }
+
+        result = result * 100000000 + EightDigits(chunk);
+    }
+
+    for (; at < end && IsDigit(*at); ++at)
+    {
+        result = result * 10 + (*at - '0');
+    }
+
+    *value = result;
+    return at;
+}
+
+// @NOTE(Roman): Digits of an unsigned 64-bit number. Returns where they end, or 0 if there are none or they don't fit.
+static const char *ParseUInt64(const char *at, const char *end, u64 *value)
+{
+    const char *start = at;
+    u64         result = 0;
+
+    at = ParseDigits(at, end, &result);
+    if (at == start) return 0;
+
+    // @NOTE(Roman): Up to 19 significant digits always fit. With 20 the wrapped result is below 10^19
+    //               exactly when it wrapped, since 2^64 is between 10^19 and 2 * 10^19.
+    for (; start < at - 1 && *start == '0'; ++start) {}
+
+    u64 digits = at - start;
+    if (digits > 20 || (digits == 20 && (*start != '1' || result < gPow10[19]))) return 0;
+
+    *value = result;
+    return at;
+}
+
+#define DOUBLE_MIN_POW10 (-342)
+#define DOUBLE_MAX_POW10 308
+
+// @NOTE(Roman): gPow5Decimal[q + 342] is 5^q normalized to 128 bits as { high, low }, truncated for q >= 0,
+//               rounded up for q < 0.
+static const u64 gPow5Decimal[651][2] =
+{
+    { 0xEEF453D6923BD65Aull, 0x113FAA2906A13B3Full }, { 0x9558B4661B6565F8ull, 0x4AC7CA59A424C507ull },
+    { 0xBAAEE17FA23EBF76ull, 0x5D79BCF00D2DF649ull }, { 0xE95A99DF8ACE6F53ull, 0xF4D82C2C107973DCull },
+    { 0x91D8A02BB6C10594ull, 0x79071B9B8A4BE869ull }, { 0xB64EC836A47146F9ull, 0x9748E2826CDEE284ull },
+    { 0xE3E27A444D8D98B7ull, 0xFD1B1B2308169B25ull }, { 0x8E6D8C6AB0787F72ull, 0xFE30F0F5E50E20F7ull },
+    { 0xB208EF855C969F4Full, 0xBDBD2D335E51A935ull }, { 0xDE8B2B66B3BC4723ull, 0xAD2C788035E61382ull },
+    { 0x8B16FB203055AC76ull, 0x4C3BCB5021AFCC31ull }, { 0xADDCB9E83C6B1793ull, 0xDF4ABE242A1BBF3Dull },
+    { 0xD953E8624B85DD78ull, 0xD71D6DAD34A2AF0Dull }, { 0x87D4713D6F33AA6Bull, 0x8672648C40E5AD68ull },
+    { 0xA9C98D8CCB009506ull, 0x680EFDAF511F18C2ull }, { 0xD43BF0EFFDC0BA48ull, 0x0212BD1B2566DEF2ull },
+    { 0x84A57695FE98746Dull, 0x014BB630F7604B57ull }, { 0xA5CED43B7E3E9188ull, 0x419EA3BD35385E2Dull },
+    { 0xCF42894A5DCE35EAull, 0x52064CAC828675B9ull }, { 0x818995CE7AA0E1B2ull, 0x7343EFEBD1940993ull },
+    { 0xA1EBFB4219491A1Full, 0x1014EBE6C5F90BF8ull }, { 0xCA66FA129F9B60A6ull, 0xD41A26E077774EF6ull },
+    { 0xFD00B897478238D0ull, 0x8920B098955522B4ull }, { 0x9E20735E8CB16382ull, 0x55B46E5F5D5535B0ull },
+    { 0xC5A890362FDDBC62ull, 0xEB2189F734AA831Dull }, { 0xF712B443BBD52B7Bull, 0xA5E9EC7501D523E4ull },
+    { 0x9A6BB0AA55653B2Dull, 0x47B233C92125366Eull }, { 0xC1069CD4EABE89F8ull, 0x999EC0BB696E840Aull },
+    { 0xF148440A256E2C76ull, 0xC00670EA43CA250Dull }, { 0x96CD2A865764DBCAull, 0x380406926A5E5728ull },
+    { 0xBC807527ED3E12BCull, 0xC605083704F5ECF2ull }, { 0xEBA09271E88D976Bull, 0xF7864A44C633682Eull },
+    { 0x93445B8731587EA3ull, 0x7AB3EE6AFBE0211Dull }, { 0xB8157268FDAE9E4Cull, 0x5960EA05BAD82964ull },
+    { 0xE61ACF033D1A45DFull, 0x6FB92487298E33BDull }, { 0x8FD0C16206306BABull, 0xA5D3B6D479F8E056ull },
+    { 0xB3C4F1BA87BC8696ull, 0x8F48A4899877186Cull }, { 0xE0B62E2929ABA83Cull, 0x331ACDABFE94DE87ull },
+    { 0x8C71DCD9BA0B4925ull, 0x9FF0C08B7F1D0B14ull }, { 0xAF8E5410288E1B6Full, 0x07ECF0AE5EE44DD9ull },
+    { 0xDB71E91432B1A24Aull, 0xC9E82CD9F69D6150ull }, { 0x892731AC9FAF056Eull, 0xBE311C083A225CD2ull },
+    { 0xAB70FE17C79AC6CAull, 0x6DBD630A48AAF406ull }, { 0xD64D3D9DB981787Dull, 0x092CBBCCDAD5B108ull },
+    { 0x85F0468293F0EB4Eull, 0x25BBF56008C58EA5ull }, { 0xA76C582338ED2621ull, 0xAF2AF2B80AF6F24Eull },
+    { 0xD1476E2C07286FAAull, 0x1AF5AF660DB4AEE1ull }, { 0x82CCA4DB847945CAull, 0x50D98D9FC890ED4Dull },
+    { 0xA37FCE126597973Cull, 0xE50FF107BAB528A0ull }, { 0xCC5FC196FEFD7D0Cull, 0x1E53ED49A96272C8ull },
+    { 0xFF77B1FCBEBCDC4Full, 0x25E8E89C13BB0F7Aull }, { 0x9FAACF3DF73609B1ull, 0x77B191618C54E9ACull },
+    { 0xC795830D75038C1Dull, 0xD59DF5B9EF6A2417ull }, { 0xF97AE3D0D2446F25ull, 0x4B0573286B44AD1Dull },
+    { 0x9BECCE62836AC577ull, 0x4EE367F9430AEC32ull }, { 0xC2E801FB244576D5ull, 0x229C41F793CDA73Full },
+    { 0xF3A20279ED56D48Aull, 0x6B43527578C1110Full }, { 0x9845418C345644D6ull, 0x830A13896B78AAA9ull },
+    { 0xBE5691EF416BD60Cull, 0x23CC986BC656D553ull }, { 0xEDEC366B11C6CB8Full, 0x2CBFBE86B7EC8AA8ull },
+    { 0x94B3A202EB1C3F39ull, 0x7BF7D71432F3D6A9ull }, { 0xB9E08A83A5E34F07ull, 0xDAF5CCD93FB0CC53ull },
+    { 0xE858AD248F5C22C9ull, 0xD1B3400F8F9CFF68ull }, { 0x91376C36D99995BEull, 0x23100809B9C21FA1ull },
+    { 0xB58547448FFFFB2Dull, 0xABD40A0C2832A78Aull }, { 0xE2E69915B3FFF9F9ull, 0x16C90C8F323F516Cull },
+    { 0x8DD01FAD907FFC3Bull, 0xAE3DA7D97F6792E3ull }, { 0xB1442798F49FFB4Aull, 0x99CD11CFDF41779Cull },
+    { 0xDD95317F31C7FA1Dull, 0x40405643D711D583ull }, { 0x8A7D3EEF7F1CFC52ull, 0x482835EA666B2572ull },
+    { 0xAD1C8EAB5EE43B66ull, 0xDA3243650005EECFull }, { 0xD863B256369D4A40ull, 0x90BED43E40076A82ull },
+    { 0x873E4F75E2224E68ull, 0x5A7744A6E804A291ull }, { 0xA90DE3535AAAE202ull, 0x711515D0A205CB36ull },
+    { 0xD3515C2831559A83ull, 0x0D5A5B44CA873E03ull }, { 0x8412D9991ED58091ull, 0xE858790AFE9486C2ull },
+    { 0xA5178FFF668AE0B6ull, 0x626E974DBE39A872ull }, { 0xCE5D73FF402D98E3ull, 0xFB0A3D212DC8128Full },
+    { 0x80FA687F881C7F8Eull, 0x7CE66634BC9D0B99ull }, { 0xA139029F6A239F72ull, 0x1C1FFFC1EBC44E80ull },
+    { 0xC987434744AC874Eull, 0xA327FFB266B56220ull }, { 0xFBE9141915D7A922ull, 0x4BF1FF9F0062BAA8ull },
+    { 0x9D71AC8FADA6C9B5ull, 0x6F773FC3603DB4A9ull }, { 0xC4CE17B399107C22ull, 0xCB550FB4384D21D3ull },
+    { 0xF6019DA07F549B2Bull, 0x7E2A53A146606A48ull }, { 0x99C102844F94E0FBull, 0x2EDA7444CBFC426Dull },
+    { 0xC0314325637A1939ull, 0xFA911155FEFB5308ull }, { 0xF03D93EEBC589F88ull, 0x793555AB7EBA27CAull },
+    { 0x96267C7535B763B5ull, 0x4BC1558B2F3458DEull }, { 0xBBB01B9283253CA2ull, 0x9EB1AAEDFB016F16ull },
+    { 0xEA9C227723EE8BCBull, 0x465E15A979C1CADCull }, { 0x92A1958A7675175Full, 0x0BFACD89EC191EC9ull },
+    { 0xB749FAED14125D36ull, 0xCEF980EC671F667Bull }, { 0xE51C79A85916F484ull, 0x82B7E12780E7401Aull },
+    { 0x8F31CC0937AE58D2ull, 0xD1B2ECB8B0908810ull }, { 0xB2FE3F0B8599EF07ull, 0x861FA7E6DCB4AA15ull },
+    { 0xDFBDCECE67006AC9ull, 0x67A791E093E1D49Aull }, { 0x8BD6A141006042BDull, 0xE0C8BB2C5C6D24E0ull },
+    { 0xAECC49914078536Dull, 0x58FAE9F773886E18ull }, { 0xDA7F5BF590966848ull, 0xAF39A475506A899Eull },
+    { 0x888F99797A5E012Dull, 0x6D8406C952429603ull }, { 0xAAB37FD7D8F58178ull, 0xC8E5087BA6D33B83ull },
+    { 0xD5605FCDCF32E1D6ull, 0xFB1E4A9A90880A64ull }, { 0x855C3BE0A17FCD26ull, 0x5CF2EEA09A55067Full },
+    { 0xA6B34AD8C9DFC06Full, 0xF42FAA48C0EA481Eull }, { 0xD0601D8EFC57B08Bull, 0xF13B94DAF124DA26ull },
+    { 0x823C12795DB6CE57ull, 0x76C53D08D6B70858ull }, { 0xA2CB1717B52481EDull, 0x54768C4B0C64CA6Eull },
+    { 0xCB7DDCDDA26DA268ull, 0xA9942F5DCF7DFD09ull }, { 0xFE5D54150B090B02ull, 0xD3F93B35435D7C4Cull },
+    { 0x9EFA548D26E5A6E1ull, 0xC47BC5014A1A6DAFull }, { 0xC6B8E9B0709F109Aull, 0x359AB6419CA1091Bull },
+    { 0xF867241C8CC6D4C0ull, 0xC30163D203C94B62ull }, { 0x9B407691D7FC44F8ull, 0x79E0DE63425DCF1Dull },
+    { 0xC21094364DFB5636ull, 0x985915FC12F542E4ull }, { 0xF294B943E17A2BC4ull, 0x3E6F5B7B17B2939Dull },
+    { 0x979CF3CA6CEC5B5Aull, 0xA705992CEECF9C42ull }, { 0xBD8430BD08277231ull, 0x50C6FF782A838353ull },
+    { 0xECE53CEC4A314EBDull, 0xA4F8BF5635246428ull }, { 0x940F4613AE5ED136ull, 0x871B7795E136BE99ull },
+    { 0xB913179899F68584ull, 0x28E2557B59846E3Full }, { 0xE757DD7EC07426E5ull, 0x331AEADA2FE589CFull },
+    { 0x9096EA6F3848984Full, 0x3FF0D2C85DEF7621ull }, { 0xB4BCA50B065ABE63ull, 0x0FED077A756B53A9ull },
+    { 0xE1EBCE4DC7F16DFBull, 0xD3E8495912C62894ull }, { 0x8D3360F09CF6E4BDull, 0x64712DD7ABBBD95Cull },
+    { 0xB080392CC4349DECull, 0xBD8D794D96AACFB3ull }, { 0xDCA04777F541C567ull, 0xECF0D7A0FC5583A0ull },
+    { 0x89E42CAAF9491B60ull, 0xF41686C49DB57244ull }, { 0xAC5D37D5B79B6239ull, 0x311C2875C522CED5ull },
+    { 0xD77485CB25823AC7ull, 0x7D633293366B828Bull }, { 0x86A8D39EF77164BCull, 0xAE5DFF9C02033197ull },
+    { 0xA8530886B54DBDEBull, 0xD9F57F830283FDFCull }, { 0xD267CAA862A12D66ull, 0xD072DF63C324FD7Bull },
+    { 0x8380DEA93DA4BC60ull, 0x4247CB9E59F71E6Dull }, { 0xA46116538D0DEB78ull, 0x52D9BE85F074E608ull },
+    { 0xCD795BE870516656ull, 0x67902E276C921F8Bull }, { 0x806BD9714632DFF6ull, 0x00BA1CD8A3DB53B6ull },
+    { 0xA086CFCD97BF97F3ull, 0x80E8A40ECCD228A4ull }, { 0xC8A883C0FDAF7DF0ull, 0x6122CD128006B2CDull },
+    { 0xFAD2A4B13D1B5D6Cull, 0x796B805720085F81ull }, { 0x9CC3A6EEC6311A63ull, 0xCBE3303674053BB0ull },
+    { 0xC3F490AA77BD60FCull, 0xBEDBFC4411068A9Cull }, { 0xF4F1B4D515ACB93Bull, 0xEE92FB5515482D44ull },
+    { 0x991711052D8BF3C5ull, 0x751BDD152D4D1C4Aull }, { 0xBF5CD54678EEF0B6ull, 0xD262D45A78A0635Dull },
+    { 0xEF340A98172AACE4ull, 0x86FB897116C87C34ull }, { 0x9580869F0E7AAC0Eull, 0xD45D35E6AE3D4DA0ull },
+    { 0xBAE0A846D2195712ull, 0x8974836059CCA109ull }, { 0xE998D258869FACD7ull, 0x2BD1A438703FC94Bull },
+    { 0x91FF83775423CC06ull, 0x7B6306A34627DDCFull }, { 0xB67F6455292CBF08ull, 0x1A3BC84C17B1D542ull },
+    { 0xE41F3D6A7377EECAull, 0x20CABA5F1D9E4A93ull }, { 0x8E938662882AF53Eull, 0x547EB47B7282EE9Cull },
+    { 0xB23867FB2A35B28Dull, 0xE99E619A4F23AA43ull }, { 0xDEC681F9F4C31F31ull, 0x6405FA00E2EC94D4ull },
+    { 0x8B3C113C38F9F37Eull, 0xDE83BC408DD3DD04ull }, { 0xAE0B158B4738705Eull, 0x9624AB50B148D445ull },
+    { 0xD98DDAEE19068C76ull, 0x3BADD624DD9B0957ull }, { 0x87F8A8D4CFA417C9ull, 0xE54CA5D70A80E5D6ull },
+    { 0xA9F6D30A038D1DBCull, 0x5E9FCF4CCD211F4Cull }, { 0xD47487CC8470652Bull, 0x7647C3200069671Full },
+    { 0x84C8D4DFD2C63F3Bull, 0x29ECD9F40041E073ull }, { 0xA5FB0A17C777CF09ull, 0xF468107100525890ull },
+    { 0xCF79CC9DB955C2CCull, 0x7182148D4066EEB4ull }, { 0x81AC1FE293D599BFull, 0xC6F14CD848405530ull },
+    { 0xA21727DB38CB002Full, 0xB8ADA00E5A506A7Cull }, { 0xCA9CF1D206FDC03Bull, 0xA6D90811F0E4851Cull },
+    { 0xFD442E4688BD304Aull, 0x908F4A166D1DA663ull }, { 0x9E4A9CEC15763E2Eull, 0x9A598E4E043287FEull },
+    { 0xC5DD44271AD3CDBAull, 0x40EFF1E1853F29FDull }, { 0xF7549530E188C128ull, 0xD12BEE59E68EF47Cull },
+    { 0x9A94DD3E8CF578B9ull, 0x82BB74F8301958CEull }, { 0xC13A148E3032D6E7ull, 0xE36A52363C1FAF01ull },
+    { 0xF18899B1BC3F8CA1ull, 0xDC44E6C3CB279AC1ull }, { 0x96F5600F15A7B7E5ull, 0x29AB103A5EF8C0B9ull },
+    { 0xBCB2B812DB11A5DEull, 0x7415D448F6B6F0E7ull }, { 0xEBDF661791D60F56ull, 0x111B495B3464AD21ull },
+    { 0x936B9FCEBB25C995ull, 0xCAB10DD900BEEC34ull }, { 0xB84687C269EF3BFBull, 0x3D5D514F40EEA742ull },
+    { 0xE65829B3046B0AFAull, 0x0CB4A5A3112A5112ull }, { 0x8FF71A0FE2C2E6DCull, 0x47F0E785EABA72ABull },
+    { 0xB3F4E093DB73A093ull, 0x59ED216765690F56ull }, { 0xE0F218B8D25088B8ull, 0x306869C13EC3532Cull },
+    { 0x8C974F7383725573ull, 0x1E414218C73A13FBull }, { 0xAFBD2350644EEACFull, 0xE5D1929EF90898FAull },
+    { 0xDBAC6C247D62A583ull, 0xDF45F746B74ABF39ull }, { 0x894BC396CE5DA772ull, 0x6B8BBA8C328EB783ull },
+    { 0xAB9EB47C81F5114Full, 0x066EA92F3F326564ull }, { 0xD686619BA27255A2ull, 0xC80A537B0EFEFEBDull },
+    { 0x8613FD0145877585ull, 0xBD06742CE95F5F36ull }, { 0xA798FC4196E952E7ull, 0x2C48113823B73704ull },
+    { 0xD17F3B51FCA3A7A0ull, 0xF75A15862CA504C5ull }, { 0x82EF85133DE648C4ull, 0x9A984D73DBE722FBull },
+    { 0xA3AB66580D5FDAF5ull, 0xC13E60D0D2E0EBBAull }, { 0xCC963FEE10B7D1B3ull, 0x318DF905079926A8ull },
+    { 0xFFBBCFE994E5C61Full, 0xFDF17746497F7052ull }, { 0x9FD561F1FD0F9BD3ull, 0xFEB6EA8BEDEFA633ull },
+    { 0xC7CABA6E7C5382C8ull, 0xFE64A52EE96B8FC0ull }, { 0xF9BD690A1B68637Bull, 0x3DFDCE7AA3C673B0ull },
+    { 0x9C1661A651213E2Dull, 0x06BEA10CA65C084Eull }, { 0xC31BFA0FE5698DB8ull, 0x486E494FCFF30A62ull },
+    { 0xF3E2F893DEC3F126ull, 0x5A89DBA3C3EFCCFAull }, { 0x986DDB5C6B3A76B7ull, 0xF89629465A75E01Cull },
+    { 0xBE89523386091465ull, 0xF6BBB397F1135823ull }, { 0xEE2BA6C0678B597Full, 0x746AA07DED582E2Cull },
+    { 0x94DB483840B717EFull, 0xA8C2A44EB4571CDCull }, { 0xBA121A4650E4DDEBull, 0x92F34D62616CE413ull },
+    { 0xE896A0D7E51E1566ull, 0x77B020BAF9C81D17ull }, { 0x915E2486EF32CD60ull, 0x0ACE1474DC1D122Eull },
+    { 0xB5B5ADA8AAFF80B8ull, 0x0D819992132456BAull }, { 0xE3231912D5BF60E6ull, 0x10E1FFF697ED6C69ull },
+    { 0x8DF5EFABC5979C8Full, 0xCA8D3FFA1EF463C1ull }, { 0xB1736B96B6FD83B3ull, 0xBD308FF8A6B17CB2ull },
+    { 0xDDD0467C64BCE4A0ull, 0xAC7CB3F6D05DDBDEull }, { 0x8AA22C0DBEF60EE4ull, 0x6BCDF07A423AA96Bull },
+    { 0xAD4AB7112EB3929Dull, 0x86C16C98D2C953C6ull }, { 0xD89D64D57A607744ull, 0xE871C7BF077BA8B7ull },
+    { 0x87625F056C7C4A8Bull, 0x11471CD764AD4972ull }, { 0xA93AF6C6C79B5D2Dull, 0xD598E40D3DD89BCFull },
+    { 0xD389B47879823479ull, 0x4AFF1D108D4EC2C3ull }, { 0x843610CB4BF160CBull, 0xCEDF722A585139BAull },
+    { 0xA54394FE1EEDB8FEull, 0xC2974EB4EE658828ull }, { 0xCE947A3DA6A9273Eull, 0x733D226229FEEA32ull },
+    { 0x811CCC668829B887ull, 0x0806357D5A3F525Full }, { 0xA163FF802A3426A8ull, 0xCA07C2DCB0CF26F7ull },
+    { 0xC9BCFF6034C13052ull, 0xFC89B393DD02F0B5ull }, { 0xFC2C3F3841F17C67ull, 0xBBAC2078D443ACE2ull },
+    { 0x9D9BA7832936EDC0ull, 0xD54B944B84AA4C0Dull }, { 0xC5029163F384A931ull, 0x0A9E795E65D4DF11ull },
+    { 0xF64335BCF065D37Dull, 0x4D4617B5FF4A16D5ull }, { 0x99EA0196163FA42Eull, 0x504BCED1BF8E4E45ull },
+    { 0xC06481FB9BCF8D39ull, 0xE45EC2862F71E1D6ull }, { 0xF07DA27A82C37088ull, 0x5D767327BB4E5A4Cull },
+    { 0x964E858C91BA2655ull, 0x3A6A07F8D510F86Full }, { 0xBBE226EFB628AFEAull, 0x890489F70A55368Bull },
+    { 0xEADAB0ABA3B2DBE5ull, 0x2B45AC74CCEA842Eull }, { 0x92C8AE6B464FC96Full, 0x3B0B8BC90012929Dull },
+    { 0xB77ADA0617E3BBCBull, 0x09CE6EBB40173744ull }, { 0xE55990879DDCAABDull, 0xCC420A6A101D0515ull },
+    { 0x8F57FA54C2A9EAB6ull, 0x9FA946824A12232Dull }, { 0xB32DF8E9F3546564ull, 0x47939822DC96ABF9ull },
+    { 0xDFF9772470297EBDull, 0x59787E2B93BC56F7ull }, { 0x8BFBEA76C619EF36ull, 0x57EB4EDB3C55B65Aull },
+    { 0xAEFAE51477A06B03ull, 0xEDE622920B6B23F1ull }, { 0xDAB99E59958885C4ull, 0xE95FAB368E45ECEDull },
+    { 0x88B402F7FD75539Bull, 0x11DBCB0218EBB414ull }, { 0xAAE103B5FCD2A881ull, 0xD652BDC29F26A119ull },
+    { 0xD59944A37C0752A2ull, 0x4BE76D3346F0495Full }, { 0x857FCAE62D8493A5ull, 0x6F70A4400C562DDBull },
+    { 0xA6DFBD9FB8E5B88Eull, 0xCB4CCD500F6BB952ull }, { 0xD097AD07A71F26B2ull, 0x7E2000A41346A7A7ull },
+    { 0x825ECC24C873782Full, 0x8ED400668C0C28C8ull }, { 0xA2F67F2DFA90563Bull, 0x728900802F0F32FAull },
+    { 0xCBB41EF979346BCAull, 0x4F2B40A03AD2FFB9ull }, { 0xFEA126B7D78186BCull, 0xE2F610C84987BFA8ull },
+    { 0x9F24B832E6B0F436ull, 0x0DD9CA7D2DF4D7C9ull }, { 0xC6EDE63FA05D3143ull, 0x91503D1C79720DBBull },
+    { 0xF8A95FCF88747D94ull, 0x75A44C6397CE912Aull }, { 0x9B69DBE1B548CE7Cull, 0xC986AFBE3EE11ABAull },
+    { 0xC24452DA229B021Bull, 0xFBE85BADCE996168ull }, { 0xF2D56790AB41C2A2ull, 0xFAE27299423FB9C3ull },
+    { 0x97C560BA6B0919A5ull, 0xDCCD879FC967D41Aull }, { 0xBDB6B8E905CB600Full, 0x5400E987BBC1C920ull },
+    { 0xED246723473E3813ull, 0x290123E9AAB23B68ull }, { 0x9436C0760C86E30Bull, 0xF9A0B6720AAF6521ull },
+    { 0xB94470938FA89BCEull, 0xF808E40E8D5B3E69ull }, { 0xE7958CB87392C2C2ull, 0xB60B1D1230B20E04ull },
+    { 0x90BD77F3483BB9B9ull, 0xB1C6F22B5E6F48C2ull }, { 0xB4ECD5F01A4AA828ull, 0x1E38AEB6360B1AF3ull },
+    { 0xE2280B6C20DD5232ull, 0x25C6DA63C38DE1B0ull }, { 0x8D590723948A535Full, 0x579C487E5A38AD0Eull },
+    { 0xB0AF48EC79ACE837ull, 0x2D835A9DF0C6D851ull }, { 0xDCDB1B2798182244ull, 0xF8E431456CF88E65ull },
+    { 0x8A08F0F8BF0F156Bull, 0x1B8E9ECB641B58FFull }, { 0xAC8B2D36EED2DAC5ull, 0xE272467E3D222F3Full },
+    { 0xD7ADF884AA879177ull, 0x5B0ED81DCC6ABB0Full }, { 0x86CCBB52EA94BAEAull, 0x98E947129FC2B4E9ull },
+    { 0xA87FEA27A539E9A5ull, 0x3F2398D747B36224ull }, { 0xD29FE4B18E88640Eull, 0x8EEC7F0D19A03AADull },
+    { 0x83A3EEEEF9153E89ull, 0x1953CF68300424ACull }, { 0xA48CEAAAB75A8E2Bull, 0x5FA8C3423C052DD7ull },
+    { 0xCDB02555653131B6ull, 0x3792F412CB06794Dull }, { 0x808E17555F3EBF11ull, 0xE2BBD88BBEE40BD0ull },
+    { 0xA0B19D2AB70E6ED6ull, 0x5B6ACEAEAE9D0EC4ull }, { 0xC8DE047564D20A8Bull, 0xF245825A5A445275ull },
+    { 0xFB158592BE068D2Eull, 0xEED6E2F0F0D56712ull }, { 0x9CED737BB6C4183Dull, 0x55464DD69685606Bull },
+    { 0xC428D05AA4751E4Cull, 0xAA97E14C3C26B886ull }, { 0xF53304714D9265DFull, 0xD53DD99F4B3066A8ull },
+    { 0x993FE2C6D07B7FABull, 0xE546A8038EFE4029ull }, { 0xBF8FDB78849A5F96ull, 0xDE98520472BDD033ull },
+    { 0xEF73D256A5C0F77Cull, 0x963E66858F6D4440ull }, { 0x95A8637627989AADull, 0xDDE7001379A44AA8ull },
+    { 0xBB127C53B17EC159ull, 0x5560C018580D5D52ull }, { 0xE9D71B689DDE71AFull, 0xAAB8F01E6E10B4A6ull },
+    { 0x9226712162AB070Dull, 0xCAB3961304CA70E8ull }, { 0xB6B00D69BB55C8D1ull, 0x3D607B97C5FD0D22ull },
+    { 0xE45C10C42A2B3B05ull, 0x8CB89A7DB77C506Aull }, { 0x8EB98A7A9A5B04E3ull, 0x77F3608E92ADB242ull },
+    { 0xB267ED1940F1C61Cull, 0x55F038B237591ED3ull }, { 0xDF01E85F912E37A3ull, 0x6B6C46DEC52F6688ull },
+    { 0x8B61313BBABCE2C6ull, 0x2323AC4B3B3DA015ull }, { 0xAE397D8AA96C1B77ull, 0xABEC975E0A0D081Aull },
+    { 0xD9C7DCED53C72255ull, 0x96E7BD358C904A21ull }, { 0x881CEA14545C7575ull, 0x7E50D64177DA2E54ull },
+    { 0xAA242499697392D2ull, 0xDDE50BD1D5D0B9E9ull }, { 0xD4AD2DBFC3D07787ull, 0x955E4EC64B44E864ull },
+    { 0x84EC3C97DA624AB4ull, 0xBD5AF13BEF0B113Eull }, { 0xA6274BBDD0FADD61ull, 0xECB1AD8AEACDD58Eull },
+    { 0xCFB11EAD453994BAull, 0x67DE18EDA5814AF2ull }, { 0x81CEB32C4B43FCF4ull, 0x80EACF948770CED7ull },
+    { 0xA2425FF75E14FC31ull, 0xA1258379A94D028Dull }, { 0xCAD2F7F5359A3B3Eull, 0x096EE45813A04330ull },
+    { 0xFD87B5F28300CA0Dull, 0x8BCA9D6E188853FCull }, { 0x9E74D1B791E07E48ull, 0x775EA264CF55347Eull },
+    { 0xC612062576589DDAull, 0x95364AFE032A819Eull }, { 0xF79687AED3EEC551ull, 0x3A83DDBD83F52205ull },
+    { 0x9ABE14CD44753B52ull, 0xC4926A9672793543ull }, { 0xC16D9A0095928A27ull, 0x75B7053C0F178294ull },
+    { 0xF1C90080BAF72CB1ull, 0x5324C68B12DD6339ull }, { 0x971DA05074DA7BEEull, 0xD3F6FC16EBCA5E04ull },
+    { 0xBCE5086492111AEAull, 0x88F4BB1CA6BCF585ull }, { 0xEC1E4A7DB69561A5ull, 0x2B31E9E3D06C32E6ull },
+    { 0x9392EE8E921D5D07ull, 0x3AFF322E62439FD0ull }, { 0xB877AA3236A4B449ull, 0x09BEFEB9FAD487C3ull },
+    { 0xE69594BEC44DE15Bull, 0x4C2EBE687989A9B4ull }, { 0x901D7CF73AB0ACD9ull, 0x0F9D37014BF60A11ull },
+    { 0xB424DC35095CD80Full, 0x538484C19EF38C95ull }, { 0xE12E13424BB40E13ull, 0x2865A5F206B06FBAull },
+    { 0x8CBCCC096F5088CBull, 0xF93F87B7442E45D4ull }, { 0xAFEBFF0BCB24AAFEull, 0xF78F69A51539D749ull },
+    { 0xDBE6FECEBDEDD5BEull, 0xB573440E5A884D1Cull }, { 0x89705F4136B4A597ull, 0x31680A88F8953031ull },
+    { 0xABCC77118461CEFCull, 0xFDC20D2B36BA7C3Eull }, { 0xD6BF94D5E57A42BCull, 0x3D32907604691B4Dull },
+    { 0x8637BD05AF6C69B5ull, 0xA63F9A49C2C1B110ull }, { 0xA7C5AC471B478423ull, 0x0FCF80DC33721D54ull },
+    { 0xD1B71758E219652Bull, 0xD3C36113404EA4A9ull }, { 0x83126E978D4FDF3Bull, 0x645A1CAC083126EAull },
+    { 0xA3D70A3D70A3D70Aull, 0x3D70A3D70A3D70A4ull }, { 0xCCCCCCCCCCCCCCCCull, 0xCCCCCCCCCCCCCCCDull },
+    { 0x8000000000000000ull, 0x0000000000000000ull }, { 0xA000000000000000ull, 0x0000000000000000ull },
+    { 0xC800000000000000ull, 0x0000000000000000ull }, { 0xFA00000000000000ull, 0x0000000000000000ull },
+    { 0x9C40000000000000ull, 0x0000000000000000ull }, { 0xC350000000000000ull, 0x0000000000000000ull },
+    { 0xF424000000000000ull, 0x0000000000000000ull }, { 0x9896800000000000ull, 0x0000000000000000ull },
+    { 0xBEBC200000000000ull, 0x0000000000000000ull }, { 0xEE6B280000000000ull, 0x0000000000000000ull },
+    { 0x9502F90000000000ull, 0x0000000000000000ull }, { 0xBA43B74000000000ull, 0x0000000000000000ull },
+    { 0xE8D4A51000000000ull, 0x0000000000000000ull }, { 0x9184E72A00000000ull, 0x0000000000000000ull },
+    { 0xB5E620F480000000ull, 0x0000000000000000ull }, { 0xE35FA931A0000000ull, 0x0000000000000000ull },
+    { 0x8E1BC9BF04000000ull, 0x0000000000000000ull }, { 0xB1A2BC2EC5000000ull, 0x0000000000000000ull },
+    { 0xDE0B6B3A76400000ull, 0x0000000000000000ull }, { 0x8AC7230489E80000ull, 0x0000000000000000ull },
+    { 0xAD78EBC5AC620000ull, 0x0000000000000000ull }, { 0xD8D726B7177A8000ull, 0x0000000000000000ull },
+    { 0x878678326EAC9000ull, 0x0000000000000000ull }, { 0xA968163F0A57B400ull, 0x0000000000000000ull },
+    { 0xD3C21BCECCEDA100ull, 0x0000000000000000ull }, { 0x84595161401484A0ull, 0x0000000000000000ull },
+    { 0xA56FA5B99019A5C8ull, 0x0000000000000000ull }, { 0xCECB8F27F4200F3Aull, 0x0000000000000000ull },
+    { 0x813F3978F8940984ull, 0x4000000000000000ull }, { 0xA18F07D736B90BE5ull, 0x5000000000000000ull },
+    { 0xC9F2C9CD04674EDEull, 0xA400000000000000ull }, { 0xFC6F7C4045812296ull, 0x4D00000000000000ull },
+    { 0x9DC5ADA82B70B59Dull, 0xF020000000000000ull }, { 0xC5371912364CE305ull, 0x6C28000000000000ull },
+    { 0xF684DF56C3E01BC6ull, 0xC732000000000000ull }, { 0x9A130B963A6C115Cull, 0x3C7F400000000000ull },
+    { 0xC097CE7BC90715B3ull, 0x4B9F100000000000ull }, { 0xF0BDC21ABB48DB20ull, 0x1E86D40000000000ull },
+    { 0x96769950B50D88F4ull, 0x1314448000000000ull }, { 0xBC143FA4E250EB31ull, 0x17D955A000000000ull },
+    { 0xEB194F8E1AE525FDull, 0x5DCFAB0800000000ull }, { 0x92EFD1B8D0CF37BEull, 0x5AA1CAE500000000ull },
+    { 0xB7ABC627050305ADull, 0xF14A3D9E40000000ull }, { 0xE596B7B0C643C719ull, 0x6D9CCD05D0000000ull },
+    { 0x8F7E32CE7BEA5C6Full, 0xE4820023A2000000ull }, { 0xB35DBF821AE4F38Bull, 0xDDA2802C8A800000ull },
+    { 0xE0352F62A19E306Eull, 0xD50B2037AD200000ull }, { 0x8C213D9DA502DE45ull, 0x4526F422CC340000ull },
+    { 0xAF298D050E4395D6ull, 0x9670B12B7F410000ull }, { 0xDAF3F04651D47B4Cull, 0x3C0CDD765F114000ull },
+    { 0x88D8762BF324CD0Full, 0xA5880A69FB6AC800ull }, { 0xAB0E93B6EFEE0053ull, 0x8EEA0D047A457A00ull },
+    { 0xD5D238A4ABE98068ull, 0x72A4904598D6D880ull }, { 0x85A36366EB71F041ull, 0x47A6DA2B7F864750ull },
+    { 0xA70C3C40A64E6C51ull, 0x999090B65F67D924ull }, { 0xD0CF4B50CFE20765ull, 0xFFF4B4E3F741CF6Dull },
+    { 0x82818F1281ED449Full, 0xBFF8F10E7A8921A4ull }, { 0xA321F2D7226895C7ull, 0xAFF72D52192B6A0Dull },
+    { 0xCBEA6F8CEB02BB39ull, 0x9BF4F8A69F764490ull }, { 0xFEE50B7025C36A08ull, 0x02F236D04753D5B4ull },
+    { 0x9F4F2726179A2245ull, 0x01D762422C946590ull }, { 0xC722F0EF9D80AAD6ull, 0x424D3AD2B7B97EF5ull },
+    { 0xF8EBAD2B84E0D58Bull, 0xD2E0898765A7DEB2ull }, { 0x9B934C3B330C8577ull, 0x63CC55F49F88EB2Full },
+    { 0xC2781F49FFCFA6D5ull, 0x3CBF6B71C76B25FBull }, { 0xF316271C7FC3908Aull, 0x8BEF464E3945EF7Aull },
+    { 0x97EDD871CFDA3A56ull, 0x97758BF0E3CBB5ACull }, { 0xBDE94E8E43D0C8ECull, 0x3D52EEED1CBEA317ull },
+    { 0xED63A231D4C4FB27ull, 0x4CA7AAA863EE4BDDull }, { 0x945E455F24FB1CF8ull, 0x8FE8CAA93E74EF6Aull },
+    { 0xB975D6B6EE39E436ull, 0xB3E2FD538E122B44ull }, { 0xE7D34C64A9C85D44ull, 0x60DBBCA87196B616ull },
+    { 0x90E40FBEEA1D3A4Aull, 0xBC8955E946FE31CDull }, { 0xB51D13AEA4A488DDull, 0x6BABAB6398BDBE41ull },
+    { 0xE264589A4DCDAB14ull, 0xC696963C7EED2DD1ull }, { 0x8D7EB76070A08AECull, 0xFC1E1DE5CF543CA2ull },
+    { 0xB0DE65388CC8ADA8ull, 0x3B25A55F43294BCBull }, { 0xDD15FE86AFFAD912ull, 0x49EF0EB713F39EBEull },
+    { 0x8A2DBF142DFCC7ABull, 0x6E3569326C784337ull }, { 0xACB92ED9397BF996ull, 0x49C2C37F07965404ull },
+    { 0xD7E77A8F87DAF7FBull, 0xDC33745EC97BE906ull }, { 0x86F0AC99B4E8DAFDull, 0x69A028BB3DED71A3ull },
+    { 0xA8ACD7C0222311BCull, 0xC40832EA0D68CE0Cull }, { 0xD2D80DB02AABD62Bull, 0xF50A3FA490C30190ull },
+    { 0x83C7088E1AAB65DBull, 0x792667C6DA79E0FAull }, { 0xA4B8CAB1A1563F52ull, 0x577001B891185938ull },
+    { 0xCDE6FD5E09ABCF26ull, 0xED4C0226B55E6F86ull }, { 0x80B05E5AC60B6178ull, 0x544F8158315B05B4ull },
+    { 0xA0DC75F1778E39D6ull, 0x696361AE3DB1C721ull }, { 0xC913936DD571C84Cull, 0x03BC3A19CD1E38E9ull },
+    { 0xFB5878494ACE3A5Full, 0x04AB48A04065C723ull }, { 0x9D174B2DCEC0E47Bull, 0x62EB0D64283F9C76ull },
+    { 0xC45D1DF942711D9Aull, 0x3BA5D0BD324F8394ull }, { 0xF5746577930D6500ull, 0xCA8F44EC7EE36479ull },
+    { 0x9968BF6ABBE85F20ull, 0x7E998B13CF4E1ECBull }, { 0xBFC2EF456AE276E8ull, 0x9E3FEDD8C321A67Eull },
+    { 0xEFB3AB16C59B14A2ull, 0xC5CFE94EF3EA101Eull }, { 0x95D04AEE3B80ECE5ull, 0xBBA1F1D158724A12ull },
+    { 0xBB445DA9CA61281Full, 0x2A8A6E45AE8EDC97ull }, { 0xEA1575143CF97226ull, 0xF52D09D71A3293BDull },
+    { 0x924D692CA61BE758ull, 0x593C2626705F9C56ull }, { 0xB6E0C377CFA2E12Eull, 0x6F8B2FB00C77836Cull },
+    { 0xE498F455C38B997Aull, 0x0B6DFB9C0F956447ull }, { 0x8EDF98B59A373FECull, 0x4724BD4189BD5EACull },
+    { 0xB2977EE300C50FE7ull, 0x58EDEC91EC2CB657ull }, { 0xDF3D5E9BC0F653E1ull, 0x2F2967B66737E3EDull },
+    { 0x8B865B215899F46Cull, 0xBD79E0D20082EE74ull }, { 0xAE67F1E9AEC07187ull, 0xECD8590680A3AA11ull },
+    { 0xDA01EE641A708DE9ull, 0xE80E6F4820CC9495ull }, { 0x884134FE908658B2ull, 0x3109058D147FDCDDull },
+    { 0xAA51823E34A7EEDEull, 0xBD4B46F0599FD415ull }, { 0xD4E5E2CDC1D1EA96ull, 0x6C9E18AC7007C91Aull },
+    { 0x850FADC09923329Eull, 0x03E2CF6BC604DDB0ull }, { 0xA6539930BF6BFF45ull, 0x84DB8346B786151Cull },
+    { 0xCFE87F7CEF46FF16ull, 0xE612641865679A63ull }, { 0x81F14FAE158C5F6Eull, 0x4FCB7E8F3F60C07Eull },
+    { 0xA26DA3999AEF7749ull, 0xE3BE5E330F38F09Dull }, { 0xCB090C8001AB551Cull, 0x5CADF5BFD3072CC5ull },
+    { 0xFDCB4FA002162A63ull, 0x73D9732FC7C8F7F6ull }, { 0x9E9F11C4014DDA7Eull, 0x2867E7FDDCDD9AFAull },
+    { 0xC646D63501A1511Dull, 0xB281E1FD541501B8ull }, { 0xF7D88BC24209A565ull, 0x1F225A7CA91A4226ull },
+    { 0x9AE757596946075Full, 0x3375788DE9B06958ull }, { 0xC1A12D2FC3978937ull, 0x0052D6B1641C83AEull },
+    { 0xF209787BB47D6B84ull, 0xC0678C5DBD23A49Aull }, { 0x9745EB4D50CE6332ull, 0xF840B7BA963646E0ull },
+    { 0xBD176620A501FBFFull, 0xB650E5A93BC3D898ull }, { 0xEC5D3FA8CE427AFFull, 0xA3E51F138AB4CEBEull },
+    { 0x93BA47C980E98CDFull, 0xC66F336C36B10137ull }, { 0xB8A8D9BBE123F017ull, 0xB80B0047445D4184ull },
+    { 0xE6D3102AD96CEC1Dull, 0xA60DC059157491E5ull }, { 0x9043EA1AC7E41392ull, 0x87C89837AD68DB2Full },
+    { 0xB454E4A179DD1877ull, 0x29BABE4598C311FBull }, { 0xE16A1DC9D8545E94ull, 0xF4296DD6FEF3D67Aull },
+    { 0x8CE2529E2734BB1Dull, 0x1899E4A65F58660Cull }, { 0xB01AE745B101E9E4ull, 0x5EC05DCFF72E7F8Full },
+    { 0xDC21A1171D42645Dull, 0x76707543F4FA1F73ull }, { 0x899504AE72497EBAull, 0x6A06494A791C53A8ull },
+    { 0xABFA45DA0EDBDE69ull, 0x0487DB9D17636892ull }, { 0xD6F8D7509292D603ull, 0x45A9D2845D3C42B6ull },
+    { 0x865B86925B9BC5C2ull, 0x0B8A2392BA45A9B2ull }, { 0xA7F26836F282B732ull, 0x8E6CAC7768D7141Eull },
+    { 0xD1EF0244AF2364FFull, 0x3207D795430CD926ull }, { 0x8335616AED761F1Full, 0x7F44E6BD49E807B8ull },
+    { 0xA402B9C5A8D3A6E7ull, 0x5F16206C9C6209A6ull }, { 0xCD036837130890A1ull, 0x36DBA887C37A8C0Full },
+    { 0x802221226BE55A64ull, 0xC2494954DA2C9789ull }, { 0xA02AA96B06DEB0FDull, 0xF2DB9BAA10B7BD6Cull },
+    { 0xC83553C5C8965D3Dull, 0x6F92829494E5ACC7ull }, { 0xFA42A8B73ABBF48Cull, 0xCB772339BA1F17F9ull },
+    { 0x9C69A97284B578D7ull, 0xFF2A760414536EFBull }, { 0xC38413CF25E2D70Dull, 0xFEF5138519684ABAull },
+    { 0xF46518C2EF5B8CD1ull, 0x7EB258665FC25D69ull }, { 0x98BF2F79D5993802ull, 0xEF2F773FFBD97A61ull },
+    { 0xBEEEFB584AFF8603ull, 0xAAFB550FFACFD8FAull }, { 0xEEAABA2E5DBF6784ull, 0x95BA2A53F983CF38ull },
+    { 0x952AB45CFA97A0B2ull, 0xDD945A747BF26183ull }, { 0xBA756174393D88DFull, 0x94F971119AEEF9E4ull },
+    { 0xE912B9D1478CEB17ull, 0x7A37CD5601AAB85Dull }, { 0x91ABB422CCB812EEull, 0xAC62E055C10AB33Aull },
+    { 0xB616A12B7FE617AAull, 0x577B986B314D6009ull }, { 0xE39C49765FDF9D94ull, 0xED5A7E85FDA0B80Bull },
+    { 0x8E41ADE9FBEBC27Dull, 0x14588F13BE847307ull }, { 0xB1D219647AE6B31Cull, 0x596EB2D8AE258FC8ull },
+    { 0xDE469FBD99A05FE3ull, 0x6FCA5F8ED9AEF3BBull }, { 0x8AEC23D680043BEEull, 0x25DE7BB9480D5854ull },
+    { 0xADA72CCC20054AE9ull, 0xAF561AA79A10AE6Aull }, { 0xD910F7FF28069DA4ull, 0x1B2BA1518094DA04ull },
+    { 0x87AA9AFF79042286ull, 0x90FB44D2F05D0842ull }, { 0xA99541BF57452B28ull, 0x353A1607AC744A53ull },
+    { 0xD3FA922F2D1675F2ull, 0x42889B8997915CE8ull }, { 0x847C9B5D7C2E09B7ull, 0x69956135FEBADA11ull },
+    { 0xA59BC234DB398C25ull, 0x43FAB9837E699095ull }, { 0xCF02B2C21207EF2Eull, 0x94F967E45E03F4BBull },
+    { 0x8161AFB94B44F57Dull, 0x1D1BE0EEBAC278F5ull }, { 0xA1BA1BA79E1632DCull, 0x6462D92A69731732ull },
+    { 0xCA28A291859BBF93ull, 0x7D7B8F7503CFDCFEull }, { 0xFCB2CB35E702AF78ull, 0x5CDA735244C3D43Eull },
+    { 0x9DEFBF01B061ADABull, 0x3A0888136AFA64A7ull }, { 0xC56BAEC21C7A1916ull, 0x088AAA1845B8FDD0ull },
+    { 0xF6C69A72A3989F5Bull, 0x8AAD549E57273D45ull }, { 0x9A3C2087A63F6399ull, 0x36AC54E2F678864Bull },
+    { 0xC0CB28A98FCF3C7Full, 0x84576A1BB416A7DDull }, { 0xF0FDF2D3F3C30B9Full, 0x656D44A2A11C51D5ull },
+    { 0x969EB7C47859E743ull, 0x9F644AE5A4B1B325ull }, { 0xBC4665B596706114ull, 0x873D5D9F0DDE1FEEull },
+    { 0xEB57FF22FC0C7959ull, 0xA90CB506D155A7EAull }, { 0x9316FF75DD87CBD8ull, 0x09A7F12442D588F2ull },
+    { 0xB7DCBF5354E9BECEull, 0x0C11ED6D538AEB2Full }, { 0xE5D3EF282A242E81ull, 0x8F1668C8A86DA5FAull },
+    { 0x8FA475791A569D10ull, 0xF96E017D694487BCull }, { 0xB38D92D760EC4455ull, 0x37C981DCC395A9ACull },
+    { 0xE070F78D3927556Aull, 0x85BBE253F47B1417ull }, { 0x8C469AB843B89562ull, 0x93956D7478CCEC8Eull },
+    { 0xAF58416654A6BABBull, 0x387AC8D1970027B2ull }, { 0xDB2E51BFE9D0696Aull, 0x06997B05FCC0319Eull },
+    { 0x88FCF317F22241E2ull, 0x441FECE3BDF81F03ull }, { 0xAB3C2FDDEEAAD25Aull, 0xD527E81CAD7626C3ull },
+    { 0xD60B3BD56A5586F1ull, 0x8A71E223D8D3B074ull }, { 0x85C7056562757456ull, 0xF6872D5667844E49ull },
+    { 0xA738C6BEBB12D16Cull, 0xB428F8AC016561DBull }, { 0xD106F86E69D785C7ull, 0xE13336D701BEBA52ull },
+    { 0x82A45B450226B39Cull, 0xECC0024661173473ull }, { 0xA34D721642B06084ull, 0x27F002D7F95D0190ull },
+    { 0xCC20CE9BD35C78A5ull, 0x31EC038DF7B441F4ull }, { 0xFF290242C83396CEull, 0x7E67047175A15271ull },
+    { 0x9F79A169BD203E41ull, 0x0F0062C6E984D386ull }, { 0xC75809C42C684DD1ull, 0x52C07B78A3E60868ull },
+    { 0xF92E0C3537826145ull, 0xA7709A56CCDF8A82ull }, { 0x9BBCC7A142B17CCBull, 0x88A66076400BB691ull },
+    { 0xC2ABF989935DDBFEull, 0x6ACFF893D00EA435ull }, { 0xF356F7EBF83552FEull, 0x0583F6B8C4124D43ull },
+    { 0x98165AF37B2153DEull, 0xC3727A337A8B704Aull }, { 0xBE1BF1B059E9A8D6ull, 0x744F18C0592E4C5Cull },
+    { 0xEDA2EE1C7064130Cull, 0x1162DEF06F79DF73ull }, { 0x9485D4D1C63E8BE7ull, 0x8ADDCB5645AC2BA8ull },
+    { 0xB9A74A0637CE2EE1ull, 0x6D953E2BD7173692ull }, { 0xE8111C87C5C1BA99ull, 0xC8FA8DB6CCDD0437ull },
+    { 0x910AB1D4DB9914A0ull, 0x1D9C9892400A22A2ull }, { 0xB54D5E4A127F59C8ull, 0x2503BEB6D00CAB4Bull },
+    { 0xE2A0B5DC971F303Aull, 0x2E44AE64840FD61Dull }, { 0x8DA471A9DE737E24ull, 0x5CEAECFED289E5D2ull },
+    { 0xB10D8E1456105DADull, 0x7425A83E872C5F47ull }, { 0xDD50F1996B947518ull, 0xD12F124E28F77719ull },
+    { 0x8A5296FFE33CC92Full, 0x82BD6B70D99AAA6Full }, { 0xACE73CBFDC0BFB7Bull, 0x636CC64D1001550Bull },
+    { 0xD8210BEFD30EFA5Aull, 0x3C47F7E05401AA4Eull }, { 0x8714A775E3E95C78ull, 0x65ACFAEC34810A71ull },
+    { 0xA8D9D1535CE3B396ull, 0x7F1839A741A14D0Dull }, { 0xD31045A8341CA07Cull, 0x1EDE48111209A050ull },
+    { 0x83EA2B892091E44Dull, 0x934AED0AAB460432ull }, { 0xA4E4B66B68B65D60ull, 0xF81DA84D5617853Full },
+    { 0xCE1DE40642E3F4B9ull, 0x36251260AB9D668Eull }, { 0x80D2AE83E9CE78F3ull, 0xC1D72B7C6B426019ull },
+    { 0xA1075A24E4421730ull, 0xB24CF65B8612F81Full }, { 0xC94930AE1D529CFCull, 0xDEE033F26797B627ull },
+    { 0xFB9B7CD9A4A7443Cull, 0x169840EF017DA3B1ull }, { 0x9D412E0806E88AA5ull, 0x8E1F289560EE864Eull },
+    { 0xC491798A08A2AD4Eull, 0xF1A6F2BAB92A27E2ull }, { 0xF5B5D7EC8ACB58A2ull, 0xAE10AF696774B1DBull },
+    { 0x9991A6F3D6BF1765ull, 0xACCA6DA1E0A8EF29ull }, { 0xBFF610B0CC6EDD3Full, 0x17FD090A58D32AF3ull },
+    { 0xEFF394DCFF8A948Eull, 0xDDFC4B4CEF07F5B0ull }, { 0x95F83D0A1FB69CD9ull, 0x4ABDAF101564F98Eull },
+    { 0xBB764C4CA7A4440Full, 0x9D6D1AD41ABE37F1ull }, { 0xEA53DF5FD18D5513ull, 0x84C86189216DC5EDull },
+    { 0x92746B9BE2F8552Cull, 0x32FD3CF5B4E49BB4ull }, { 0xB7118682DBB66A77ull, 0x3FBC8C33221DC2A1ull },
+    { 0xE4D5E82392A40515ull, 0x0FABAF3FEAA5334Aull }, { 0x8F05B1163BA6832Dull, 0x29CB4D87F2A7400Eull },
+    { 0xB2C71D5BCA9023F8ull, 0x743E20E9EF511012ull }, { 0xDF78E4B2BD342CF6ull, 0x914DA9246B255416ull },
+    { 0x8BAB8EEFB6409C1Aull, 0x1AD089B6C2F7548Eull }, { 0xAE9672ABA3D0C320ull, 0xA184AC2473B529B1ull },
+    { 0xDA3C0F568CC4F3E8ull, 0xC9E5D72D90A2741Eull }, { 0x8865899617FB1871ull, 0x7E2FA67C7A658892ull },
+    { 0xAA7EEBFB9DF9DE8Dull, 0xDDBB901B98FEEAB7ull }, { 0xD51EA6FA85785631ull, 0x552A74227F3EA565ull },
+    { 0x8533285C936B35DEull, 0xD53A88958F87275Full }, { 0xA67FF273B8460356ull, 0x8A892ABAF368F137ull },
+    { 0xD01FEF10A657842Cull, 0x2D2B7569B0432D85ull }, { 0x8213F56A67F6B29Bull, 0x9C3B29620E29FC73ull },
+    { 0xA298F2C501F45F42ull, 0x8349F3BA91B47B8Full }, { 0xCB3F2F7642717713ull, 0x241C70A936219A73ull },
+    { 0xFE0EFB53D30DD4D7ull, 0xED238CD383AA0110ull }, { 0x9EC95D1463E8A506ull, 0xF4363804324A40AAull },
+    { 0xC67BB4597CE2CE48ull, 0xB143C6053EDCD0D5ull }, { 0xF81AA16FDC1B81DAull, 0xDD94B7868E94050Aull },
+    { 0x9B10A4E5E9913128ull, 0xCA7CF2B4191C8326ull }, { 0xC1D4CE1F63F57D72ull, 0xFD1C2F611F63A3F0ull },
+    { 0xF24A01A73CF2DCCFull, 0xBC633B39673C8CECull }, { 0x976E41088617CA01ull, 0xD5BE0503E085D813ull },
+    { 0xBD49D14AA79DBC82ull, 0x4B2D8644D8A74E18ull }, { 0xEC9C459D51852BA2ull, 0xDDF8E7D60ED1219Eull },
+    { 0x93E1AB8252F33B45ull, 0xCABB90E5C942B503ull }, { 0xB8DA1662E7B00A17ull, 0x3D6A751F3B936243ull },
+    { 0xE7109BFBA19C0C9Dull, 0x0CC512670A783AD4ull }, { 0x906A617D450187E2ull, 0x27FB2B80668B24C5ull },
+    { 0xB484F9DC9641E9DAull, 0xB1F9F660802DEDF6ull }, { 0xE1A63853BBD26451ull, 0x5E7873F8A0396973ull },
+    { 0x8D07E33455637EB2ull, 0xDB0B487B6423E1E8ull }, { 0xB049DC016ABC5E5Full, 0x91CE1A9A3D2CDA62ull },
+    { 0xDC5C5301C56B75F7ull, 0x7641A140CC7810FBull }, { 0x89B9B3E11B6329BAull, 0xA9E904C87FCB0A9Dull },
+    { 0xAC2820D9623BF429ull, 0x546345FA9FBDCD44ull }, { 0xD732290FBACAF133ull, 0xA97C177947AD4095ull },
+    { 0x867F59A9D4BED6C0ull, 0x49ED8EABCCCC485Dull }, { 0xA81F301449EE8C70ull, 0x5C68F256BFFF5A74ull },
+    { 0xD226FC195C6A2F8Cull, 0x73832EEC6FFF3111ull }, { 0x83585D8FD9C25DB7ull, 0xC831FD53C5FF7EABull },
+    { 0xA42E74F3D032F525ull, 0xBA3E7CA8B77F5E55ull }, { 0xCD3A1230C43FB26Full, 0x28CE1BD2E55F35EBull },
+    { 0x80444B5E7AA7CF85ull, 0x7980D163CF5B81B3ull }, { 0xA0555E361951C366ull, 0xD7E105BCC332621Full },
+    { 0xC86AB5C39FA63440ull, 0x8DD9472BF3FEFAA7ull }, { 0xFA856334878FC150ull, 0xB14F98F6F0FEB951ull },
+    { 0x9C935E00D4B9D8D2ull, 0x6ED1BF9A569F33D3ull }, { 0xC3B8358109E84F07ull, 0x0A862F80EC4700C8ull },
+    { 0xF4A642E14C6262C8ull, 0xCD27BB612758C0FAull }, { 0x98E7E9CCCFBD7DBDull, 0x8038D51CB897789Cull },
+    { 0xBF21E44003ACDD2Cull, 0xE0470A63E6BD56C3ull }, { 0xEEEA5D5004981478ull, 0x1858CCFCE06CAC74ull },
+    { 0x95527A5202DF0CCBull, 0x0F37801E0C43EBC8ull }, { 0xBAA718E68396CFFDull, 0xD30560258F54E6BAull },
+    { 0xE950DF20247C83FDull, 0x47C6B82EF32A2069ull }, { 0x91D28B7416CDD27Eull, 0x4CDC331D57FA5441ull },
+    { 0xB6472E511C81471Dull, 0xE0133FE4ADF8E952ull }, { 0xE3D8F9E563A198E5ull, 0x58180FDDD97723A6ull },
+    { 0x8E679C2F5E44FF8Full, 0x570F09EAA7EA7648ull },
+};
+
+// @NOTE(Roman): Bits of the double nearest to w * 10^q, w is not 0.
+static u64 DecimalToDouble(u64 w, s64 q)
+{
+    if (q < DOUBLE_MIN_POW10) return 0;
+    if (q > DOUBLE_MAX_POW10) return 0x7FF0000000000000ull;
+
+    u32 leading_zeros = 63 - HighestBit64(w);
+    w <<= leading_zeros;
+
+    // @NOTE(Roman): The low half of the power matters only if the bits below the 55 we keep are all ones.
+    const u64 *power = gPow5Decimal[q - DOUBLE_MIN_POW10];
+    u64        low   = w, high = power[0];
+    Multiply128(&low, &high);
+
+    if ((high & 0x1FF) == 0x1FF)
+    {
+        u64 low2 = w, high2 = power[1];
+        Multiply128(&low2, &high2);
+
+        low += high2;
+        if (high2 > low) ++high;
+    }
+
+    u32 upper_bit = static_cast<u32>(high >> 63);
+    u32 shift     = upper_bit + 64 - DOUBLE_MANTISSA_BITS - 3;
+    u64 mantissa  = high >> shift;
+
+    // @NOTE(Roman): floor(log2(10^q)) + 63 is (217706 * q) >> 16.
+    s64 power2 = ((217706 * q) >> 16) + 63 + upper_bit - leading_zeros + DOUBLE_BIAS;
+
+    if (power2 <= 0)
+    {
+        if (-power2 + 1 >= 64) return 0;
+
+        mantissa >>= -power2 + 1;
+        mantissa  += mantissa & 1;
+        mantissa >>= 1;
+
+        // @NOTE(Roman): Rounding up can make it the smallest normal number.
+        power2 = mantissa < (1ull << DOUBLE_MANTISSA_BITS) ? 0 : 1;
+        return mantissa | static_cast<u64>(power2) << DOUBLE_MANTISSA_BITS;
+    }
+
+    // @NOTE(Roman): Exactly halfway between two doubles is possible only for small q, it rounds to the even one.
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == high)
+    {
+        mantissa &= ~1ull;
+    }
+
+    mantissa  += mantissa & 1;
+    mantissa >>= 1;
+
+    if (mantissa >= (2ull << DOUBLE_MANTISSA_BITS))
+    {
+        mantissa = 1ull << DOUBLE_MANTISSA_BITS;
+        ++power2;
+    }
+
+    mantissa &= ~(1ull << DOUBLE_MANTISSA_BITS);
+
+    if (power2 >= (1 << DOUBLE_EXPONENT_BITS) - 1) return 0x7FF0000000000000ull;
+    return mantissa | static_cast<u64>(power2) << DOUBLE_MANTISSA_BITS;
+}
+
+static double StrtodC(const char *cstring)
+{
+#ifdef _MSC_VER
+    static _locale_t c_locale = _create_locale(LC_NUMERIC, "C");
+    return _strtod_l(cstring, 0, c_locale);
+#else
+    static locale_t c_locale = newlocale(LC_NUMERIC_MASK, "C", 0);
+    return strtod_l(cstring, 0, c_locale);
+#endif
+}
+
+// @NOTE(Roman): inf, infinity and nan in any case.
+static const char *ParseSpecialDouble(const char *at, const char *end, double *value)
+{
+    static const char infinity[] = "infinity";
+
+    u64 i = 0;
+    for (; at + i < end && i < 8 && (at[i] | 0x20) == infinity[i]; ++i) {}
+
+    if (i >= 3)
+    {
+        *value = HUGE_VAL;
+        return at + (i == 8 ? 8 : 3);
+    }
+
+    if (end - at >= 3 && (at[0] | 0x20) == 'n' && (at[1] | 0x20) == 'a' && (at[2] | 0x20) == 'n')
+    {
+        *value = NAN;
+        return at + 3;
+    }
+
+    return 0;
+}
+
+u64 StringView::ParseUInt(u64 *value) const
+{
+    const char *at  = mData;
+    const char *end = mData + mLength;
+
+    if (at < end && *at == '+') ++at;
+
+    const char *stop = ParseUInt64(at, end, value);
+    return stop ? stop - mData : 0;
+}
+
+u64 StringView::ParseInt(s64 *value) const
+{
+    const char *at       = mData;
+    const char *end      = mData + mLength;
+    bool        negative = false;
+
+    if (at < end && (*at == '-' || *at == '+')) negative = *at++ == '-';
+
+    u64         magnitude;
+    const char *stop = ParseUInt64(at, end, &magnitude);
+    if (!stop || magnitude > (1ull << 63) - !negative) return 0;
+
+    *value = static_cast<s64>(negative ? 0 - magnitude : magnitude);
+    return stop - mData;
+}
+
+u64 StringView::ParseDouble(double *value) const
+{
+    const char *at       = mData;
+    const char *end      = mData + mLength;
+    bool        negative = false;
+    double      result;
+
+    if (at < end && (*at == '-' || *at == '+')) negative = *at++ == '-';
+
+    u64         w          = 0;
+    const char *int_start  = at;
+    const char *int_end    = ParseDigits(int_start, end, &w);
+    const char *frac_start = int_end;
+    const char *frac_end   = int_end;
+
+    if (int_end < end && *int_end == '.')
+    {
+        frac_start = int_end + 1;
+        frac_end   = ParseDigits(frac_start, end, &w);
+    }
+
+    u64 digits = (int_end - int_start) + (frac_end - frac_start);
+    if (!digits)
+    {
+        const char *stop = ParseSpecialDouble(at, end, &result);
+        if (!stop) return 0;
+
+        *value = negative ? -result : result;
+        return stop - mData;
+    }
+
+    // @NOTE(Roman): An exponent without digits is not a part of the number. Huge ones are clamped,
+    //               they give 0 or inf anyway.
+    s64 exponent = 0;
+    at = frac_end;
+
+    if (at < end && (*at | 0x20) == 'e')
+    {
+        const char *next              = at + 1;
+        bool        negative_exponent = false;
+
+        if (next < end && (*next == '-' || *next == '+')) negative_exponent = *next++ == '-';
+
+        if (next < end && IsDigit(*next))
+        {
+            for (; next < end && IsDigit(*next); ++next)
+            {
+                if (exponent < 100000) exponent = exponent * 10 + (*next - '0');
+            }
+            if (negative_exponent) exponent = -exponent;
+            at = next;
+        }
+    }
+
+    u64  consumed  = at - mData;
+    s64  q         = exponent - (frac_end - frac_start);
+    bool truncated = false;
+
+    // @NOTE(Roman): w wrapped, so it's taken again from the first 19 significant digits.
+    if (digits > 19)
+    {
+        const char *first = int_start;
+        for (; first < int_end && *first == '0'; ++first) {}
+        if (first == int_end) for (first = frac_start; first < frac_end && *first == '0'; ++first) {}
+
+        u64 significant = first < int_end ? (int_end - first) + (frac_end - frac_start) : frac_end - first;
+        if (significant > 19)
+        {
+            const char *digit = first;
+            truncated = true;
+            w         = 0;
+
+            for (u32 taken = 0; taken < 19; ++taken, ++digit)
+            {
+                if (digit == int_end) digit = frac_start;
+                w = w * 10 + (*digit - '0');
+            }
+
+            q = digit <= int_end ? exponent + (int_end - digit) : exponent - (digit - frac_start);
+        }
+    }
+
+    if (!w)
+    {
+        result = 0;
+    }
+    else if (!truncated && w <= (1ull << 53) && q >= -22 && q <= 22)
+    {
+        // @NOTE(Roman): Clinger's fast path, w and the power of 10 are exact doubles, so there's a single rounding.
+        result = q < 0 ? static_cast<double>(w) / gPow10Double[-q] : static_cast<double>(w) * gPow10Double[q];
+    }
+    else
+    {
+        u64 bits = DecimalToDouble(w, q);
+
+        // @NOTE(Roman): The exact value is between w and w + 1, if they round differently the dropped digits decide.
+        if (truncated && DecimalToDouble(w + 1, q) != bits)
+        {
+            char  stack_copy[128];
+            char *copy = consumed < sizeof(stack_copy) ? stack_copy : static_cast<char *>(malloc(consumed + 1));
+            Check(copy);
+
+            memcpy(copy, mData, consumed);
+            copy[consumed] = '\0';
+            *value = StrtodC(copy);
+
+            if (copy != stack_copy) free(copy);
+            return consumed;
+        }
+
+        memcpy(&result, &bits, sizeof(result));
+    }
+
+    *value = negative ? -result : result;
+    return consumed;
+}
+
+//
+// String
+//
+
+// @NOTE(Roman): mSmall is cleared and moved with fixed-size memset/memcpy, which compile to a few moves.
+//               The dispatched kernels are an indirect call, which costs more than the whole short string.
+String::String()
+    : mAllocator(0)
+{
+    memset(mSmall, '\0', sizeof(mSmall));
+    InvalidateHash();
+}
+
+String::String(u64 capacity)
+    : String()
+{
+    Reserve(capacity);
+}
+
+String::String(char symbol, u64 count)
+    : String()
+{
+    vmemset(Resize(count), symbol, count);
+}
+
+String::String(const char *cstring)
+    : String()
+{
+    u64 length = strlen(cstring);
+    vmemcpy(Resize(length), const_cast<char *>(cstring), length);
+}
+
+String::String(const char *cstring, u64 length)
+    : String()
+{
+    vmemcpy(Resize(length), const_cast<char *>(cstring), length);
+}
+
+String::String(const String& other)
+    : String()
+{
+    mAllocator = other.mAllocator;
+
+    u64 length = other.Length();
+    vmemcpy(Resize(length), const_cast<char *>(other.Data()), length);
+}
+
+String::String(StringView view)
+    : String()
+{
+    vmemcpy(Resize(view.Length()), const_cast<char *>(view.Data()), view.Length());
+}
+
+String::String(Allocator& allocator)
+    : String()
+{
+    mAllocator = &allocator;
+}
+
+String::String(const char *cstring, Allocator& allocator)
+    : String(allocator)
+{
+    u64 length = strlen(cstring);
+    vmemcpy(Resize(length), cstring, length);
+}
+
+String::String(const char *cstring, u64 length, Allocator& allocator)
+    : String(allocator)
+{
+    vmemcpy(Resize(length), cstring, length);
+}
+
+String::String(StringView view, Allocator& allocator)
+    : String(allocator)
+{
+    vmemcpy(Resize(view.Length()), view.Data(), view.Length());
+}
+
+String::String(String&& other) noexcept
+    : mAllocator(other.mAllocator)
+{
+    memcpy(mSmall, other.mSmall, sizeof(mSmall));
+    memset(other.mSmall, '\0', sizeof(other.mSmall));
+    TakeHash(other);
+}
+
+String::~String()
+{
+    if (!IsSmall())
+    {
+        Free(mAllocator, mHeap.data, Capacity());
+    }
+}
+
+char *String::Resize(u64 length)
+{
+    if (length + 1 > Capacity())
+    {
+        Grow(length + 1);
+    }
+    SetLength(length);
+    return Data();
+}
+
+char *String::Grow(u64 capacity)
+{
+    capacity = Align(capacity);
+
+    if (IsSmall())
+    {
+        u64   length = static_cast<u8>(mSmall[SmallTag]);
+        char *data   = static_cast<char *>(Allocate(mAllocator, capacity));
+        vmemcpy(data, mSmall, length + 1);
+
+        mHeap.data     = data;
+        mHeap.length   = length;
+        mHeap.capacity = capacity | HeapFlag;
+    }
+    else if (capacity > Capacity())
+    {
+        mHeap.data     = static_cast<char *>(Reallocate(mAllocator, mHeap.data, Capacity(), capacity));
+        mHeap.capacity = capacity | HeapFlag;
+    }
+
+    return mHeap.data;
+}
+
+NOINLINE char *String::Expand(u64 capacity)
+{
+    u64 old_capacity = Capacity();
+    u64 step         = old_capacity * (STRING_GROWTH_NUMERATOR - STRING_GROWTH_DENOMINATOR) / STRING_GROWTH_DENOMINATOR;
+
+    if (STRING_GROWTH_MAX_STEP && step > STRING_GROWTH_MAX_STEP)
+    {
+        step = STRING_GROWTH_MAX_STEP;
+    }
+
+    if (capacity < old_capacity + step)
+    {
+        capacity = old_capacity + step;
+    }
+
+    return Grow(capacity);
+}
+
+String& String::Clear()
+{
+    vmemset(Data(), '\0', Capacity());
+    SetLength(0);
+    return *this;
+}
+
+String& String::Reserve(u64 bytes)
+{
+    if (bytes > Capacity())
+    {
+        Grow(bytes);
+    }
+    return *this;
+}
+
+String& String::ToLower()
+{
+    FlipCase(Data(), Length(), 'A');
+    return *this;
+}
+
+String& String::ToUpper()
+{
+    FlipCase(Data(), Length(), 'a');
+    return *this;
+}
+
+u64 String::Hash() const
+{
+#ifdef STRING_CACHED_HASH
+    if (!mHash) mHash = View().Hash();
+    return mHash;
+#else
+    return View().Hash();
+#endif
+}
+
+s8 String::Compare(const String& other) const
+{
+    return Compare(other.Data(), other.Length());
+}
+
+s8 String::Compare(const char *cstring) const
+{
+    return Compare(cstring, strlen(cstring));
+}
+
+s8 String::Compare(const char *cstring, u64 cstring_length) const
+{
+    return CompareBytes(Data(), Length(), cstring, cstring_length);
+}
+
+String& String::Insert(u64 where, const String& other)
+{
+    return Insert(where, other.Data(), other.Length());
+}
+
+String& String::Insert(u64 where, char symbol)
+{
+    return Insert(where, &symbol, 1);
+}
+
+String& String::Insert(u64 where, const char *cstring)
+{
+    return Insert(where, cstring, strlen(cstring));
+}
+
+String& String::Insert(u64 where, const char *cstring, u64 cstring_length)
+{
+    u64 old_length = Length();
+
+    Check(where <= old_length);
+
+    char *data = Data();
+
+    if (cstring >= data && cstring < data + old_length)
+    {
+        String copy(cstring, cstring_length);
+        return Insert(where, copy.Data(), cstring_length);
+    }
+
+    if (old_length + cstring_length >= Capacity())
+    {
+        data = Expand(old_length + cstring_length + 1);
+    }
+
+    if (where < old_length)
+    {
+        memmove(data + where + cstring_length, data + where, old_length - where);
+    }
+    vmemcpy(data + where, const_cast<char *>(cstring), cstring_length);
+    SetLength(old_length + cstring_length);
+
+    return *this;
+}
+
+String& String::Erase(u64 from, u64 to)
+{
+    u64 old_length = Length();
+
+    Check(to > from);
+    Check(to <= old_length);
+
+    char *data = Data();
+
+    memmove(data + from, data + to, old_length - to);
+    SetLength(old_length - (to - from));
+
+    return *this;
+}
+
+String& String::Replace(u64 from, u64 to, StringView with)
+{
+    u64 old_length = Length();
+
+    Check(from <= to);
+    Check(to <= old_length);
+
+    char *data       = Data();
+    u64   new_length = old_length - (to - from) + with.Length();
+
+    if (with.Data() >= data && with.Data() < data + old_length)
+    {
+        String copy(with.Data(), with.Length());
+        return Replace(from, to, copy);
+    }
+
+    if (new_length >= Capacity())
+    {
+        data = Expand(new_length + 1);
+    }
+
+    if (to - from != with.Length())
+    {
+        memmove(data + from + with.Length(), data + to, old_length - to);
+    }
+    vmemcpy(data + from, with.Data(), with.Length());
+    SetLength(new_length);
+
+    return *this;
+}
+
+String& String::ReplaceAll(StringView needle, StringView replacement)
+{
+    if (!needle.Length()) return *this;
+
+    u64         old_length = Length();
+    const char *old_data   = View().Data();
+
+    if ((needle.Data()      >= old_data && needle.Data()      < old_data + old_length)
+    ||  (replacement.Data() >= old_data && replacement.Data() < old_data + old_length))
+    {
+        String needle_copy(needle.Data(), needle.Length());
+        String replacement_copy(replacement.Data(), replacement.Length());
+        return ReplaceAll(needle_copy, replacement_copy);
+    }
+
+    StringView view(old_data, old_length);
+    u64        match = view.FindIndex(needle);
+
+    if (match == NotFound) return *this;
+
+    // @NOTE(Roman): Written part never gets ahead of the read one, so the rest is still searched as it was.
+    if (replacement.Length() <= needle.Length())
+    {
+        char *data  = Data();
+        u64   write = match;
+        u64   read  = match;
+
+        for (; match != NotFound; match = view.FindIndex(needle, read))
+        {
+            if (write != read) memmove(data + write, data + read, match - read);
+            write += match - read;
+
+            vmemcpy(data + write, replacement.Data(), replacement.Length());
+            write += replacement.Length();
+            read   = match + needle.Length();
+        }
+
+        if (write != read) memmove(data + write, data + read, old_length - read);
+        SetLength(write + old_length - read);
+
+        return *this;
+    }
+
+    u64  stack_matches[64];
+    u64 *matches  = stack_matches;
+    u64  count    = 0;
+    u64  capacity = sizeof(stack_matches) / sizeof(stack_matches[0]);
+
+    for (; match != NotFound; match = view.FindIndex(needle, match + needle.Length()))
+    {
+        if (count == capacity)
+        {
+            u64 *grown = static_cast<u64 *>(malloc(2 * capacity * sizeof(u64)));
+            Check(grown);
+
+            vmemcpy(grown, matches, count * sizeof(u64));
+            if (matches != stack_matches) free(matches);
+
+            matches   = grown;
+            capacity *= 2;
+        }
+        matches[count++] = match;
+    }
+
+    u64 new_length = old_length + count * (replacement.Length() - needle.Length());
+
+    if (new_length < Capacity())
+    {
+        // @NOTE(Roman): Back to front, so every byte is moved once and nothing unread is overwritten.
+        char *data  = Data();
+        u64   read  = old_length;
+        u64   write = new_length;
+
+        for (u64 i = count; i--;)
+        {
+            u64 after = matches[i] + needle.Length();
+
+            write -= read - after;
+            memmove(data + write, data + after, read - after);
+
+            write -= replacement.Length();
+            vmemcpy(data + write, replacement.Data(), replacement.Length());
+
+            read = matches[i];
+        }
+
+        SetLength(new_length);
+    }
+    else
+    {
+        String result;
+        result.mAllocator = mAllocator;
+
+        char *write = result.Resize(new_length);
+        u64   read  = 0;
+
+        for (u64 i = 0; i < count; ++i)
+        {
+            vmemcpy(write, old_data + read, matches[i] - read);
+            write += matches[i] - read;
+
+            vmemcpy(write, replacement.Data(), replacement.Length());
+            write += replacement.Length();
+
+            read = matches[i] + needle.Length();
+        }
+        vmemcpy(write, old_data + read, old_length - read);
+
+        *this = std::move(result);
+    }
+
+    if (matches != stack_matches) free(matches);
+
+    return *this;
+}
+
+String& String::ReplaceAll(char symbol, char replacement)
+{
+    StringView view  = View();
+    u64        index = view.FindIndex(symbol);
+
+    if (index != NotFound)
+    {
+        char *data = Data();
+
+        for (; index != NotFound; index = view.FindIndex(symbol, index + 1))
+        {
+            data[index] = replacement;
+        }
+    }
+
+    return *this;
+}
+
+String& String::AppendInt(s64 value)
+{
+    u64 length = Length();
+    if (length + MaxNumberLength >= Capacity()) Expand(length + MaxNumberLength + 1);
+    SetLength(length + FormatInt(Data() + length, value));
+    return *this;
+}
+
+String& String::AppendUInt(u64 value)
+{
+    u64 length = Length();
+    if (length + MaxNumberLength >= Capacity()) Expand(length + MaxNumberLength + 1);
+    SetLength(length + FormatUInt(Data() + length, value));
+    return *this;
+}
+
+String& String::AppendDouble(double value)
+{
+    u64 length = Length();
+    if (length + MaxNumberLength >= Capacity()) Expand(length + MaxNumberLength + 1);
+    SetLength(length + FormatDouble(Data() + length, value));
+    return *this;
+}
+
+String& String::AppendHex(u64 value, u32 min_digits, bool uppercase)
+{
+    u64 length = Length();
+    u64 bound  = min_digits > MaxNumberLength ? min_digits : MaxNumberLength;
+    if (length + bound >= Capacity()) Expand(length + bound + 1);
+    SetLength(length + FormatHex(Data() + length, value, min_digits, uppercase));
+    return *this;
+}
+
+u64 String::Utf8LengthOfUtf16(const u16 *in, u64 in_length)
+{
+    return Utf16Utf8Length(in, in_length);
+}
+
+u64 String::Utf8LengthOfLatin1(const char *in, u64 in_length)
+{
+    return in_length + CountBytesAtLeast(in, in_length, 0x80);
+}
+
+String& String::AppendUtf16(const u16 *in, u64 in_length, u64 *error_index)
+{
+    u64 length   = Length();
+    u64 required = length + Utf8LengthOfUtf16(in, in_length);
+    if (required >= Capacity()) Expand(required + 1);
+
+    u64 error;
+    SetLength(length + Utf16ToUtf8(in, in_length, Data() + length, &error));
+
+    if (error_index) *error_index = error;
+    return *this;
+}
+
+String& String::AppendLatin1(const char *in, u64 in_length)
+{
+    u64 length   = Length();
+    u64 required = length + Utf8LengthOfLatin1(in, in_length);
+    if (required >= Capacity()) Expand(required + 1);
+
+    SetLength(length + Latin1ToUtf8(in, in_length, Data() + length));
+    return *this;
+}
+
+String& String::AppendFormatItems(const char *text, const StringFormatItem *items, u32 item_count, u64 literal_length,
+                                  const StringFormatArgument *arguments, u32 argument_count)
+{
+    typedef StringFormatArgument::Kind Kind;
+
+    u64 bound = literal_length;
+
+    for (u32 i = 0; i < argument_count; ++i)
+    {
+        Kind kind = arguments[i].mKind;
+
+        if      (kind == Kind::Text) bound += arguments[i].mLength;
+        else if (kind == Kind::Bool) bound += 5;
+        else if (kind == Kind::Char) bound += 1;
+        else                         bound += MaxNumberLength;
+    }
+
+    u64 length = Length();
+
+    if (length + bound >= Capacity())
+    {
+        // @NOTE(Roman): Expand moves the buffer, so if an argument views this string,
+        //               the output is formatted into a copy while the arguments stay valid.
+        const char *data = Data();
+
+        for (u32 i = 0; i < argument_count; ++i)
+        {
+            if (arguments[i].mKind == Kind::Text && arguments[i].mText >= data && arguments[i].mText < data + length)
+            {
+                String copy(*this);
+                copy.AppendFormatItems(text, items, item_count, literal_length, arguments, argument_count);
+                return *this = std::move(copy);
+            }
+        }
+
+        Expand(length + bound + 1);
+    }
+
+    char *start = Data() + length;
+    char *out   = start;
+
+    for (u32 i = 0; i < item_count; ++i)
+    {
+        if (items[i].length != StringFormatItem::Argument)
+        {
+            memcpy(out, text + items[i].offset, items[i].length);
+            out += items[i].length;
+            continue;
+        }
+
+        const StringFormatArgument& argument = *arguments++;
+        Kind                        kind     = argument.mKind;
+
+        if (kind == Kind::Text)
+        {
+            memcpy(out, argument.mText, argument.mLength);
+            out += argument.mLength;
+        }
+        else if (kind == Kind::Bool)
+        {
+            u64 bool_length = argument.mUInt ? 4 : 5;
+            memcpy(out, argument.mUInt ? "true" : "false", bool_length);
+            out += bool_length;
+        }
+        else if (kind == Kind::Char)   *out++ = static_cast<char>(argument.mUInt);
+        else if (kind == Kind::Int)    out   += FormatInt(out, argument.mInt);
+        else if (kind == Kind::UInt)   out   += FormatUInt(out, argument.mUInt);
+        else                           out   += FormatDouble(out, argument.mDouble);
+    }
+
+    SetLength(length + (out - start));
+    return *this;
+}
+
+String String::Concat(const String& left, const String& right)
+{
+    return Concat(left.mAllocator, left.Data(), left.Length(), right.Data(), right.Length());
+}
+
+String String::Concat(const String& left, String&& right)
+{
+    // @NOTE(Roman): Reusing right's buffer would hand the result right's allocator.
+    if (left.mAllocator != right.mAllocator) return Concat(left, static_cast<const String&>(right));
+
+    return std::move(right.PushFront(left));
+}
+
+String String::Concat(const String& left, char right)
+{
+    return Concat(left.mAllocator, left.Data(), left.Length(), &right, 1);
+}
+
+String String::Concat(const String& left, const char *right)
+{
+    return Concat(left.mAllocator, left.Data(), left.Length(), right, strlen(right));
+}
+
+String String::Concat(const String& left, const char *right, u64 right_length)
+{
+    return Concat(left.mAllocator, left.Data(), left.Length(), right, right_length);
+}
+
+String String::Concat(String&& left, const String& right)
+{
+    return std::move(left.PushBack(right));
+}
+
+String String::Concat(String&& left, char right)
+{
+    return std::move(left.PushBack(right));
+}
+
+String String::Concat(String&& left, const char *right)
+{
+    return std::move(left.PushBack(right));
+}
+
+String String::Concat(String&& left, const char *right, u64 right_length)
+{
+    return std::move(left.PushBack(right, right_length));
+}
+
+String String::Concat(char left, const String& right)
+{
+    return Concat(right.mAllocator, &left, 1, right.Data(), right.Length());
+}
+
+String String::Concat(char left, String&& right)
+{
+    return std::move(right.PushFront(left));
+}
+
+String String::Concat(char left, char right)
+{
+    return Concat(&left, 1, &right, 1);
+}
+
+String String::Concat(char left, const char *right)
+{
+    return Concat(&left, 1, right, strlen(right));
+}
+
+String String::Concat(char left, const char *right, u64 right_length)
+{
+    return Concat(&left, 1, right, right_length);
+}
+
+String String::Concat(const char *left, const String& right)
+{
+    return Concat(right.mAllocator, left, strlen(left), right.Data(), right.Length());
+}
+
+String String::Concat(const char *left, String&& right)
+{
+    return std::move(right.PushFront(left));
+}
+
+String String::Concat(const char *left, char right)
+{
+    return Concat(left, strlen(left), &right, 1);
+}
+
+String String::Concat(const char *left, const char *right)
+{
+    return Concat(left, strlen(left), right, strlen(right));
+}
+
+String String::Concat(const char *left, const char *right, u64 right_length)
+{
+    return Concat(left, strlen(left), right, right_length);
+}
+
+String String::Concat(const char *left, u64 left_length, const String& right)
+{
+    return Concat(right.mAllocator, left, left_length, right.Data(), right.Length());
+}
+
+String String::Concat(const char *left, u64 left_length, String&& right)
+{
+    return std::move(right.PushFront(left, left_length));
+}
+
+String String::Concat(const char *left, u64 left_length, char right)
+{
+    return Concat(left, left_length, &right, 1);
+}
+
+String String::Concat(const char *left, u64 left_length, const char *right)
+{
+    return Concat(left, left_length, right, strlen(right));
+}
+
+String String::Concat(const char *left, u64 left_length, const char *right, u64 right_length)
+{
+    return Concat(0, left, left_length, right, right_length);
+}
+
+String String::Concat(Allocator *allocator, const char *left, u64 left_length, const char *right, u64 right_length)
+{
+    String result;
+    result.mAllocator = allocator;
+
+    char *data = result.Resize(left_length + right_length);
+    vmemcpy(data,               const_cast<char *>(left),  left_length);
+    vmemcpy(data + left_length, const_cast<char *>(right), right_length);
+    return result;
+}
+
+String String::SubString(u64 from, u64 to) const &
+{
+    if (mAllocator) return String(Data() + from, to - from, *mAllocator);
+    return String(Data() + from, to - from);
+}
+
+String String::SubString(u64 from, u64 to) &&
+{
+    u64   sub_len = to - from;
+    char *data    = Data();
+    memmove(data, data + from, sub_len);
+    SetLength(sub_len);
+    return std::move(*this);
+}
+
+String String::SubStringCodePoints(u64 from, u64 to) const &
+{
+    StringView view  = View().SubStringCodePoints(from, to);
+    u64        begin = view.Data() - Data();
+    return SubString(begin, begin + view.Length());
+}
+
+String String::SubStringCodePoints(u64 from, u64 to) &&
+{
+    StringView view  = View().SubStringCodePoints(from, to);
+    u64        begin = view.Data() - Data();
+    return std::move(*this).SubString(begin, begin + view.Length());
+}
+
+String String::SubString(const char *cstring, u64 from, u64 to)
+{
+    return String(cstring + from, to - from);
+}
+
+String String::Find(const String& string) const &
+{
+    return Find(string.Data(), string.Length());
+}
+
+String String::Find(const String& string) &&
+{
+    return std::move(*this).Find(string.Data(), string.Length());
+}
+
+char String::Find(char symbol) const
+{
+    return FindByte(Data(), Length(), symbol) != NotFound ? symbol : '\0';
+}
+
+String String::Find(const char *cstring) const &
+{
+    return Find(cstring, static_cast<u64>(strlen(cstring)));
+}
+
+String String::Find(const char *cstring) &&
+{
+    return std::move(*this).Find(cstring, static_cast<u64>(strlen(cstring)));
+}
+
+String String::Find(const char *cstring, u64 cstring_length) const &
+{
+    u64 index = FindBytes(Data(), Length(), cstring, cstring_length);
+    if (index == NotFound) return String();
+    if (mAllocator)        return String(Data() + index, cstring_length, *mAllocator);
+    return String(Data() + index, cstring_length);
+}
+
+String String::Find(const char *cstring, u64 cstring_length) &&
+{
+    u64 index = FindBytes(Data(), Length(), cstring, cstring_length);
+    if (index == NotFound) return String();
+
+    char *data = Data();
+    memmove(data, data + index, cstring_length);
+    SetLength(cstring_length);
+    return std::move(*this);
+}
+
+String String::Find(const char *in_cstring, const String& string)
+{
+    return Find(in_cstring, strlen(in_cstring), string.Data(), string.Length());
+}
+
+char String::Find(const char *in_cstring, char symbol)
+{
+    return Find(in_cstring, strlen(in_cstring), symbol);
+}
+
+String String::Find(const char *in_cstring, const char *cstring)
+{
+    return Find(in_cstring, strlen(in_cstring), cstring, strlen(cstring));
+}
+
+String String::Find(const char *in_cstring, const char *cstring, u64 cstring_length)
+{
+    return Find(in_cstring, strlen(in_cstring), cstring, cstring_length);
+}
+
+String String::Find(const char *in_cstring, u64 in_cstring_length, const String& string)
+{
+    return Find(in_cstring, in_cstring_length, string.Data(), string.Length());
+}
+
+char String::Find(const char *in_cstring, u64 in_cstring_length, char symbol)
+{
+    return FindByte(in_cstring, in_cstring_length, symbol) != NotFound ? symbol : '\0';
+}
+
+String String::Find(const char *in_cstring, u64 in_cstring_length, const char *cstring)
+{
+    return Find(in_cstring, in_cstring_length, cstring, strlen(cstring));
+}
+
+String String::Find(const char *in_cstring, u64 in_cstring_length, const char *cstring, u64 cstring_length)
+{
+    u64 index = FindBytes(in_cstring, in_cstring_length, cstring, cstring_length);
+    if (index == NotFound) return String();
+    return String(in_cstring + index, cstring_length);
+}
+
+const String& String::WriteToFile(int unix_file, bool binary) const
+{
+    u64 length = Length();
+
+    if (binary)
+    {
+        DebugResult(_write(unix_file, &length, sizeof(u64)) != -1);
+    }
+    DebugResult(_write(unix_file, Data(), static_cast<int>(length)) != -1);
+    return *this;
+}
+
+const String& String::WriteToFile(void *win_file, bool binary) const
+{
+#ifdef _WIN32
+    u64 length = Length();
+
+    if (binary)
+    {
+        DebugResult(WriteFile(win_file, &length, sizeof(u64), 0, 0) != -1);
+    }
+    DebugResult(WriteFile(win_file, Data(), static_cast<int>(length), 0, 0));
+#endif
+    return *this;
+}
+
+const String& String::WriteToFile(FILE *crt_file, bool binary) const
+{
+    u64 length = Length();
+
+    if (binary)
+    {
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    fwrite(Data(), length, 1, crt_file);
+    return *this;
+}
+
+const String& String::WriteToFile(const char *filename, bool binary) const
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+    if (binary)
+    {
+        crt_file = fopen(filename, "wb");
+        Check(crt_file);
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        crt_file = fopen(filename, "wt");
+        Check(crt_file);
+    }
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+    return *this;
+}
+
+const String& String::WriteToFile(const String& filename, bool binary) const
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+    if (binary)
+    {
+        crt_file = fopen(filename.Data(), "wb");
+        Check(crt_file);
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        crt_file = fopen(filename.Data(), "wt");
+        Check(crt_file);
+    }
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+    return *this;
+}
+
+String& String::WriteToFile(int unix_file, bool binary)
+{
+    u64 length = Length();
+
+    if (binary)
+    {
+        DebugResult(_write(unix_file, &length, sizeof(u64)) != -1);
+    }
+    DebugResult(_write(unix_file, Data(), static_cast<int>(length)) != -1);
+    return *this;
+}
+
+String& String::WriteToFile(void *win_file, bool binary)
+{
+#ifdef _WIN32
+    u64 length = Length();
+
+    if (binary)
+    {
+        DebugResult(WriteFile(win_file, &length, sizeof(u64), 0, 0) != -1);
+    }
+    DebugResult(WriteFile(win_file, Data(), static_cast<int>(length), 0, 0));
+#endif
+    return *this;
+}
+
+String& String::WriteToFile(FILE *crt_file, bool binary)
+{
+    u64 length = Length();
+
+    if (binary)
+    {
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    fwrite(Data(), length, 1, crt_file);
+    return *this;
+}
+
+String& String::WriteToFile(const char *filename, bool binary)
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+    if (binary)
+    {
+        crt_file = fopen(filename, "wb");
+        Check(crt_file);
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        crt_file = fopen(filename, "wt");
+        Check(crt_file);
+    }
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+    return *this;
+}
+
+String& String::WriteToFile(const String& filename, bool binary)
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+    if (binary)
+    {
+        crt_file = fopen(filename.Data(), "wb");
+        Check(crt_file);
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        crt_file = fopen(filename.Data(), "wt");
+        Check(crt_file);
+    }
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+    return *this;
+}
+
+String& String::ReadFromFile(int unix_file, u64 num_chars_to_read, bool binary)
+{
+    u64 length = num_chars_to_read;
+
+    if (binary)
+    {
+        DebugResult(_read(unix_file, &length, sizeof(u64)) != -1);
+    }
+
+    DebugResult(_read(unix_file, Resize(length), static_cast<int>(length)) != -1);
+
+    return *this;
+}
+
+String& String::ReadFromFile(void *win_file, u64 num_chars_to_read, bool binary)
+{
+#ifdef _WIN32
+    u64 length = num_chars_to_read;
+
+    if (binary)
+    {
+        DebugResult(ReadFile(win_file, &length, sizeof(u64), 0, 0));
+    }
+
+    DebugResult(ReadFile(win_file, Resize(length), static_cast<int>(length), 0, 0));
+#endif
+    return *this;
+}
+
+String& String::ReadFromFile(FILE *crt_file, u64 num_chars_to_read, bool binary)
+{
+    u64 length = num_chars_to_read;
+
+    if (binary)
+    {
+        fread(&length, sizeof(u64), 1, crt_file);
+    }
+
+    fread(Resize(length), length, 1, crt_file);
+
+    return *this;
+}
+
+String& String::ReadFromFile(const char *filename, u64 num_chars_to_read, bool binary)
+{
+    FILE *crt_file = 0;
+    u64   length   = num_chars_to_read;
+
+    if (binary)
+    {
+        DebugResult(crt_file = fopen(filename, "rb"));
+        fread(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        DebugResult(crt_file = fopen(filename, "rt"));
+    }
+
+    fread(Resize(length), length, 1, crt_file);
+    fclose(crt_file);
+    return *this;
+}
+
+String& String::ReadFromFile(const String& filename, u64 num_chars_to_read, bool binary)
+{
+    return ReadFromFile(filename.Data(), num_chars_to_read, binary);
+}
+
+const String& String::AppendToFile(const char *filename, bool binary) const
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+
+    if (binary)
+    {
+        DebugResult(crt_file = fopen(filename, "ab"));
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        DebugResult(crt_file = fopen(filename, "at"));
+    }
+
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+
+    return *this;
+}
+
+const String& String::AppendToFile(const String& filename, bool binary) const
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+
+    if (binary)
+    {
+        DebugResult(crt_file = fopen(filename.Data(), "ab"));
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        DebugResult(crt_file = fopen(filename.Data(), "at"));
+    }
+
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+
+    return *this;
+}
+
+String& String::AppendToFile(const char *filename, bool binary)
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+
+    if (binary)
+    {
+        DebugResult(crt_file = fopen(filename, "ab"));
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        DebugResult(crt_file = fopen(filename, "at"));
+    }
+
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+
+    return *this;
+}
+
+String& String::AppendToFile(const String& filename, bool binary)
+{
+    FILE *crt_file = 0;
+    u64   length   = Length();
+
+    if (binary)
+    {
+        DebugResult(crt_file = fopen(filename.Data(), "ab"));
+        fwrite(&length, sizeof(u64), 1, crt_file);
+    }
+    else
+    {
+        DebugResult(crt_file = fopen(filename.Data(), "at"));
+    }
+
+    fwrite(Data(), length, 1, crt_file);
+    fclose(crt_file);
+
+    return *this;
+}
+
+
+char String::operator[](u64 index) const
+{
+    Check(index < Length());
+    return Data()[index];
+}
+
+char& String::operator[](u64 index)
+{
+    Check(index < Length());
+    return Data()[index];
+}
+
+String& String::operator=(const String& other)
+{
+    if (&other != this)
+    {
+        u64 length = other.Length();
+        vmemcpy(Resize(length), const_cast<char *>(other.Data()), length);
+    }
+    return *this;
+}
+
+String& String::operator=(String&& other) noexcept
+{
+    if (&other != this)
+    {
+        if (!IsSmall()) Free(mAllocator, mHeap.data, Capacity());
+
+        memcpy(mSmall, other.mSmall, sizeof(mSmall));
+        mAllocator = other.mAllocator;
+        memset(other.mSmall, '\0', sizeof(other.mSmall));
+        TakeHash(other);
+    }
+    return *this;
+}
+
+String& String::operator=(char symbol)
+{
+    *Resize(1) = symbol;
+    return *this;
+}
+
+String& String::operator=(const char *cstring)
+{
+    u64 length = strlen(cstring);
+    vmemcpy(Resize(length), const_cast<char *>(cstring), length);
+    return *this;
+}
+
+//
+// MappedString
+//
+
+MappedString::MappedString()
+    : mData(0),
+      mLength(0),
+      mMode(Mode::ReadOnly),
+      mMapped(false)
+#ifdef _WIN32
+    , mFile(INVALID_HANDLE_VALUE),
+      mMapping(0)
+#endif
+{
+}
+
+MappedString::MappedString(const char *filename, Mode mode, Access access)
+    : MappedString()
+{
+    Map(filename, mode, access);
+}
+
+MappedString::MappedString(MappedString&& other) noexcept
+    : MappedString()
+{
+    *this = std::move(other);
+}
+
+MappedString::~MappedString()
+{
+    Unmap();
+}
+
+bool MappedString::Map(const char *filename, Mode mode, Access access)
+{
+    Unmap();
+
+    mMode = mode;
 
-    for (u64 i = 0; i < mLength; ++i)
-    {
-        if (mLength - i < cstring_length)
-        {
-            return std::move(String());
-        }
+#ifdef _WIN32
+    DWORD desired_access = mode == Mode::Shared ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    DWORD flags          = FILE_ATTRIBUTE_NORMAL;
 
-        if (mData[i] == *cstring)
-        {
-            const char *this_start   = mData + i;
-            const char *string_start = cstring;
+    if      (access == Access::Sequential) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    else if (access == Access::Random)     flags |= FILE_FLAG_RANDOM_ACCESS;
 
-            while (*this_start++ == *string_start++)
-            {
-            }
+    mFile = CreateFileA(filename, desired_access, FILE_SHARE_READ, 0, OPEN_EXISTING, flags, 0);
+    if (mFile == INVALID_HANDLE_VALUE) return false;
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = this_start - mData - offset;
-                break;
-            }
-        }
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(mFile, &file_size))
+    {
+        Unmap();
+        return false;
     }
 
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, mData + offset, result.mLength);
-    return result;
-}
-
-String String::Find(const char *cstring, u64 cstring_length) &&
-{
-    u64 offset = 0;
-    u64 length = 0;
+    mLength = static_cast<u64>(file_size.QuadPart);
 
-    for (u64 i = 0; i < mLength; ++i)
+    // @NOTE(Roman): Empty files can't be mapped, but they are valid empty strings.
+    if (mLength)
     {
-        if (mLength - i < cstring_length)
+        DWORD protection = PAGE_READONLY;
+        DWORD view       = FILE_MAP_READ;
+
+        if      (mode == Mode::Private) { protection = PAGE_WRITECOPY; view = FILE_MAP_COPY;  }
+        else if (mode == Mode::Shared)  { protection = PAGE_READWRITE; view = FILE_MAP_WRITE; }
+
+        mMapping = CreateFileMappingA(mFile, 0, protection, 0, 0, 0);
+        if (!mMapping)
         {
-            return std::move(String());
+            Unmap();
+            return false;
         }
 
-        if (mData[i] == *cstring)
+        mData = static_cast<char *>(MapViewOfFile(mMapping, view, 0, 0, 0));
+        if (!mData)
         {
-            const char *this_start   = mData + i;
-            const char *string_start = cstring;
-
-            while (*this_start++ == *string_start++)
-            {
-            }
-
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = this_start - mData - offset;
-                break;
-            }
+            Unmap();
+            return false;
         }
     }
+#else
+    int fd = open(filename, mode == Mode::Shared ? O_RDWR : O_RDONLY);
+    if (fd == -1) return false;
 
-    mLength = length;
-    vmemcpy(mData, mData + offset, mLength);
-    return std::move(*this);
-}
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1)
+    {
+        close(fd);
+        return false;
+    }
 
-String String::Find(const char *in_cstring, const String& string)
-{
-    u64 in_cstring_length = strlen(in_cstring);
-    u64 offset            = 0;
-    u64 length            = 0;
+    mLength = static_cast<u64>(file_stat.st_size);
 
-    for (u64 i = 0; i < in_cstring_length; ++i)
+    if (mLength)
     {
-        if (in_cstring_length - i < string.mLength)
+        int protection = mode == Mode::ReadOnly ? PROT_READ   : PROT_READ | PROT_WRITE;
+        int flags      = mode == Mode::Shared   ? MAP_SHARED  : MAP_PRIVATE;
+
+        void *memory = mmap(0, mLength, protection, flags, fd, 0);
+        if (memory == MAP_FAILED)
         {
-            return std::move(String());
+            close(fd);
+            mLength = 0;
+            return false;
         }
 
-        if (in_cstring[i] == *string.mData)
-        {
-            const char *in_string_start = in_cstring + i;
-            const char *string_start    = string.mData;
+        mData = static_cast<char *>(memory);
+    }
 
-            while (*in_string_start++ == *string_start++)
-            {
-            }
+    // @NOTE(Roman): Mapping holds its own reference to the file.
+    close(fd);
+#endif
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = in_string_start - in_cstring - offset;
-                break;
-            }
-        }
-    }
+    mMapped = true;
 
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(in_cstring) + offset, result.mLength);
-    return result;
+    if (access != Access::Normal) Advise(access);
+
+    return true;
 }
 
-char String::Find(const char *in_cstring, char symbol)
+void MappedString::Unmap()
 {
-    const char *start = in_cstring;
-    while (*start && *start != symbol)
-    {
-        ++start;
-    }
-    return *start;
+#ifdef _WIN32
+    if (mData)                         UnmapViewOfFile(mData);
+    if (mMapping)                      CloseHandle(mMapping);
+    if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+
+    mMapping = 0;
+    mFile    = INVALID_HANDLE_VALUE;
+#else
+    if (mData) munmap(mData, mLength);
+#endif
+
+    mData   = 0;
+    mLength = 0;
+    mMapped = false;
 }
 
-String String::Find(const char *in_cstring, const char *cstring)
+void MappedString::Advise(Access access)
 {
-    u64 in_cstring_length = strlen(in_cstring);
-    u64 cstring_length    = strlen(cstring);
-    u64 offset            = 0;
-    u64 length            = 0;
+    if (!mData) return;
 
-    for (u64 i = 0; i < in_cstring_length; ++i)
-    {
-        if (in_cstring_length - i < cstring_length)
+#ifdef _WIN32
+    // @NOTE(Roman): Sequential and random hints were given to CreateFile,
+    //               the only one Windows can take after mapping is a prefetch.
+    #if _WIN32_WINNT >= 0x0602
+        if (access == Access::WillNeed)
         {
-            return std::move(String());
+            WIN32_MEMORY_RANGE_ENTRY range = { mData, mLength };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
         }
+    #else
+        (void)access;
+    #endif
+#else
+    int advice = MADV_NORMAL;
 
-        if (in_cstring[i] == *cstring)
-        {
-            const char *in_string_start = in_cstring + i;
-            const char *string_start    = cstring;
-
-            while (*in_string_start++ == *string_start++)
-            {
-            }
-
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = in_string_start - in_cstring - offset;
-                break;
-            }
-        }
-    }
+    if      (access == Access::Sequential) advice = MADV_SEQUENTIAL;
+    else if (access == Access::Random)     advice = MADV_RANDOM;
+    else if (access == Access::WillNeed)   advice = MADV_WILLNEED;
 
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(in_cstring) + offset, result.mLength);
-    return result;
+    madvise(mData, mLength, advice);
+#endif
 }
 
-String String::Find(const char *in_cstring, const char *cstring, u64 cstring_length)
+char *MappedString::Data()
 {
-    u64 in_cstring_length = strlen(in_cstring);
-    u64 offset            = 0;
-    u64 length            = 0;
+    Check(mMode != Mode::ReadOnly);
+    return mData;
+}
 
-    for (u64 i = 0; i < in_cstring_length; ++i)
+MappedString& MappedString::operator=(MappedString&& other) noexcept
+{
+    if (&other != this)
     {
-        if (in_cstring_length - i < cstring_length)
-        {
-            return std::move(String());
-        }
+        Unmap();
 
-        if (in_cstring[i] == *cstring)
-        {
-            const char *in_string_start = in_cstring + i;
-            const char *string_start    = cstring;
-
-            while (*in_string_start++ == *string_start++)
-            {
-            }
+        mData   = other.mData;
+        mLength = other.mLength;
+        mMode   = other.mMode;
+        mMapped = other.mMapped;
+#ifdef _WIN32
+        mFile    = other.mFile;
+        mMapping = other.mMapping;
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = in_string_start - in_cstring - offset;
-                break;
-            }
-        }
+        other.mFile    = INVALID_HANDLE_VALUE;
+        other.mMapping = 0;
+#endif
+        other.mData   = 0;
+        other.mLength = 0;
+        other.mMapped = false;
     }
-
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(in_cstring) + offset, result.mLength);
-    return result;
+    return *this;
 }
 
-String String::Find(const char *in_cstring, u64 in_cstring_length, const String& string)
+//
+// StringBuilder
+//
+
+StringBuilder::StringBuilder(u64 chunk_size)
+    : mHead(0),
+      mTail(0),
+      mLength(0),
+      mChunkSize(chunk_size ? chunk_size : DefaultChunkSize),
+      mAllocator(0)
 {
-    u64 offset = 0;
-    u64 length = 0;
+}
 
-    for (u64 i = 0; i < in_cstring_length; ++i)
-    {
-        if (in_cstring_length - i < string.mLength)
-        {
-            return std::move(String());
-        }
+StringBuilder::StringBuilder(Allocator& allocator, u64 chunk_size)
+    : StringBuilder(chunk_size)
+{
+    mAllocator = &allocator;
+}
 
-        if (in_cstring[i] == *string.mData)
-        {
-            const char *in_string_start = in_cstring + i;
-            const char *string_start    = string.mData;
+StringBuilder::StringBuilder(StringBuilder&& other) noexcept
+    : StringBuilder(other.mChunkSize)
+{
+    *this = std::move(other);
+}
 
-            while (*in_string_start++ == *string_start++)
-            {
-            }
+StringBuilder::~StringBuilder()
+{
+    FreeChunks(mHead);
+}
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = in_string_start - in_cstring - offset;
-                break;
-            }
-        }
+void StringBuilder::FreeChunks(Chunk *chunk)
+{
+    while (chunk)
+    {
+        Chunk *next = chunk->next;
+        Free(mAllocator, chunk, sizeof(Chunk) + chunk->size);
+        chunk = next;
     }
-
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(in_cstring) + offset, result.mLength);
-    return result;
 }
 
-char String::Find(const char *in_cstring, u64 in_cstring_length, char symbol)
+StringBuilder& StringBuilder::Clear()
 {
-    const char *start = in_cstring;
-    const char *end   = in_cstring + in_cstring_length;
-    while (start < end && *start != symbol)
+    if (mHead)
     {
-        ++start;
+        FreeChunks(mHead->next);
+
+        mHead->next = 0;
+        mHead->used = 0;
+        mTail       = mHead;
     }
-    return *start;
+    mLength = 0;
+    return *this;
 }
 
-String String::Find(const char *in_cstring, u64 in_cstring_length, const char *cstring)
+// @NOTE(Roman): Returns room for length bytes at the end, they must be filled by the caller.
+//               A piece that doesn't fit into the tail chunk goes whole into a new one,
+//               so every piece is contiguous and chunks are never reallocated.
+char *StringBuilder::Append(u64 length)
 {
-    u64 cstring_length = strlen(cstring);
-    u64 offset         = 0;
-    u64 length         = 0;
-
-    for (u64 i = 0; i < in_cstring_length; ++i)
+    if (!mTail || mTail->used + length > mTail->size)
     {
-        if (in_cstring_length - i < cstring_length)
-        {
-            return std::move(String());
-        }
+        u64 size = mTail ? mTail->size * 2 : mChunkSize;
+        if (size > MaxChunkSize) size = MaxChunkSize;
+        if (size < length)       size = length;
 
-        if (in_cstring[i] == *cstring)
-        {
-            const char *in_string_start = in_cstring + i;
-            const char *string_start    = cstring;
+        Chunk *chunk = static_cast<Chunk *>(Allocate(mAllocator, sizeof(Chunk) + size));
+        Check(chunk);
 
-            while (*in_string_start++ == *string_start++)
-            {
-            }
+        chunk->next = 0;
+        chunk->size = size;
+        chunk->used = 0;
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = in_string_start - in_cstring - offset;
-                break;
-            }
-        }
+        if (mTail) mTail->next = chunk;
+        else       mHead       = chunk;
+        mTail = chunk;
     }
 
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(in_cstring) + offset, result.mLength);
+    char *result = mTail->Data() + mTail->used;
+    mTail->used += length;
+    mLength     += length;
     return result;
 }
 
-String String::Find(const char *in_cstring, u64 in_cstring_length, const char *cstring, u64 cstring_length)
+StringBuilder& StringBuilder::PushBack(char symbol)
 {
-    u64 offset = 0;
-    u64 length = 0;
+    *Append(1) = symbol;
+    return *this;
+}
 
-    for (u64 i = 0; i < in_cstring_length; ++i)
+StringBuilder& StringBuilder::PushBack(const char *cstring, u64 cstring_length)
+{
+    if (cstring_length)
     {
-        if (in_cstring_length - i < cstring_length)
-        {
-            return std::move(String());
-        }
-
-        if (in_cstring[i] == *cstring)
-        {
-            const char *in_string_start = in_cstring + i;
-            const char *string_start    = cstring;
+        vmemcpy(Append(cstring_length), cstring, cstring_length);
+    }
+    return *this;
+}
 
-            while (*in_string_start++ == *string_start++)
-            {
-            }
+String StringBuilder::ToString() const
+{
+    String result = mAllocator ? String(*mAllocator) : String();
+    result.Reserve(mLength + 1);
 
-            if (string_start == '\0')
-            {
-                offset = i;
-                length = in_string_start - in_cstring - offset;
-                break;
-            }
-        }
+    for (Chunk *chunk = mHead; chunk; chunk = chunk->next)
+    {
+        result.PushBack(chunk->Data(), chunk->used);
     }
 
-    String result;
-    result.mLength   = length;
-    result.mCapacity = Align(result.mLength + 1);
-    result.mData     = static_cast<char *>(calloc(1, result.mCapacity));
-    vmemcpy(result.mData, const_cast<char *>(in_cstring) + offset, result.mLength);
     return result;
 }
 
-const String& String::WriteToFile(int unix_file, bool binary) const
+const StringBuilder& StringBuilder::WriteToFile(int unix_file, bool binary) const
 {
     if (binary)
     {
         DebugResult(_write(unix_file, &mLength, sizeof(u64)) != -1);
     }
-    DebugResult(_write(unix_file, mData, static_cast<int>(mLength)) != -1);
+    for (Chunk *chunk = mHead; chunk; chunk = chunk->next)
+    {
+        DebugResult(_write(unix_file, chunk->Data(), static_cast<int>(chunk->used)) != -1);
+    }
     return *this;
 }
 
-const String& String::WriteToFile(void *win_file, bool binary) const
+const StringBuilder& StringBuilder::WriteToFile(void *win_file, bool binary) const
 {
 #ifdef _WIN32
     if (binary)
     {
-        DebugResult(WriteFile(win_file, &mLength, sizeof(u64), 0, 0) != -1);
+        DebugResult(WriteFile(win_file, &mLength, sizeof(u64), 0, 0));
+    }
+    for (Chunk *chunk = mHead; chunk; chunk = chunk->next)
+    {
+        DebugResult(WriteFile(win_file, chunk->Data(), static_cast<int>(chunk->used), 0, 0));
     }
-    DebugResult(WriteFile(win_file, mData, static_cast<int>(mLength), 0, 0));
 #endif
     return *this;
 }
 
-const String& String::WriteToFile(FILE *crt_file, bool binary) const
+const StringBuilder& StringBuilder::WriteToFile(FILE *crt_file, bool binary) const
 {
     if (binary)
     {
         fwrite(&mLength, sizeof(u64), 1, crt_file);
     }
-    fwrite(mData, mLength, 1, crt_file);
+    for (Chunk *chunk = mHead; chunk; chunk = chunk->next)
+    {
+        fwrite(chunk->Data(), chunk->used, 1, crt_file);
+    }
     return *this;
 }
 
-const String& String::WriteToFile(const char *filename, bool binary) const
+const StringBuilder& StringBuilder::WriteToFile(const char *filename, bool binary) const
 {
     FILE *crt_file = 0;
-    if (binary)
+    DebugResult(crt_file = fopen(filename, binary ? "wb" : "wt"));
+    WriteToFile(crt_file, binary);
+    fclose(crt_file);
+    return *this;
+}
+
+const StringBuilder& StringBuilder::WriteToFile(const String& filename, bool binary) const
+{
+    return WriteToFile(filename.Data(), binary);
+}
+
+StringBuilder& StringBuilder::operator=(StringBuilder&& other) noexcept
+{
+    if (&other != this)
     {
-        crt_file = fopen(filename, "wb");
-        Check(crt_file);
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
+        FreeChunks(mHead);
+
+        mHead      = other.mHead;
+        mTail      = other.mTail;
+        mLength    = other.mLength;
+        mChunkSize = other.mChunkSize;
+        mAllocator = other.mAllocator;
+
+        other.mHead   = 0;
+        other.mTail   = 0;
+        other.mLength = 0;
     }
-    else
+    return *this;
+}
+
+//
+// Intern table
+//
+// @NOTE(Roman): Entries are appended to blocks that are never moved or freed, and are found by id
+//               through pages of entry pointers. Page k holds 1024 << k ids, so pages are never moved either.
+//               Strings are found by hash in an open addressing table of (high hash bits, id) slots.
+//               Writers hold gInternMutex. Readers take no locks: they see an id in a slot only after
+//               its entry and page are published, and a grown table only after it's filled.
+//               Old tables are kept alive because readers may still be probing them.
+//
+
+struct InternEntry
+{
+    u64  hash;
+    u64  length;
+    char data[1];
+};
+
+struct InternTable
+{
+    InternTable      *retired;
+    u64               mask;
+    std::atomic<u64>  slots[1];
+};
+
+#define INTERN_FIRST_PAGE_BITS 10
+#define INTERN_PAGE_COUNT      (32 - INTERN_FIRST_PAGE_BITS + 1)
+#define INTERN_FIRST_SLOTS     1024
+#define INTERN_BLOCK_SIZE      (64 * 1024)
+
+static std::mutex                   gInternMutex;
+static std::atomic<InternTable *>   gInternTable;
+static std::atomic<InternEntry **>  gInternPages[INTERN_PAGE_COUNT];
+static u64                          gInternCount;
+static char                        *gInternBlock;
+static u64                          gInternBlockLeft;
+
+// @NOTE(Roman): Splits id - 1 into its page and the index inside the page.
+static InternEntry **InternSlot(u32 id, bool allocate)
+{
+    u64 index  = static_cast<u64>(id) - 1 + (1ull << INTERN_FIRST_PAGE_BITS);
+    u32 page   = HighestBit64(index) - INTERN_FIRST_PAGE_BITS;
+    u64 offset = index - (1ull << (page + INTERN_FIRST_PAGE_BITS));
+
+    InternEntry **entries = gInternPages[page].load(std::memory_order_acquire);
+    if (!entries && allocate)
     {
-        crt_file = fopen(filename, "wt");
-        Check(crt_file);
+        u64 count = 1ull << (page + INTERN_FIRST_PAGE_BITS);
+        entries   = static_cast<InternEntry **>(calloc(count, sizeof(InternEntry *)));
+        Check(entries);
+        gInternPages[page].store(entries, std::memory_order_release);
     }
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
-    return *this;
+
+    return entries + offset;
 }
 
-const String& String::WriteToFile(const String& filename, bool binary) const
+static InternEntry *InternEntryOf(u32 id)
 {
-    FILE *crt_file = 0;
-    if (binary)
+    return *InternSlot(id, false);
+}
+
+static InternTable *NewInternTable(u64 slot_count)
+{
+    InternTable *table = static_cast<InternTable *>(calloc(1, sizeof(InternTable) + (slot_count - 1) * sizeof(std::atomic<u64>)));
+    Check(table);
+    table->mask = slot_count - 1;
+    return table;
+}
+
+static u32 InternFind(InternTable *table, StringView string, u64 hash)
+{
+    if (!table) return 0;
+
+    u64 tag = hash >> 32;
+
+    for (u64 i = hash & table->mask;; i = (i + 1) & table->mask)
     {
-        crt_file = fopen(filename.mData, "wb");
-        Check(crt_file);
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
+        u64 slot = table->slots[i].load(std::memory_order_acquire);
+        if (!slot) return 0;
+
+        if ((slot >> 32) == tag)
+        {
+            u32          id    = static_cast<u32>(slot);
+            InternEntry *entry = InternEntryOf(id);
+
+            if (entry->length == string.Length() && !memcmp(entry->data, string.Data(), string.Length()))
+            {
+                return id;
+            }
+        }
     }
-    else
+}
+
+static void InternInsert(InternTable *table, u64 hash, u32 id)
+{
+    u64 i = hash & table->mask;
+    while (table->slots[i].load(std::memory_order_relaxed)) i = (i + 1) & table->mask;
+    table->slots[i].store(((hash >> 32) << 32) | id, std::memory_order_release);
+}
+
+static InternEntry *NewInternEntry(StringView string, u64 hash)
+{
+    u64 bytes = AlignAllocation(offsetof(InternEntry, data) + string.Length() + 1);
+
+    if (bytes > gInternBlockLeft)
     {
-        crt_file = fopen(filename.mData, "wt");
-        Check(crt_file);
+        u64 block_size   = bytes > INTERN_BLOCK_SIZE ? bytes : INTERN_BLOCK_SIZE;
+        gInternBlock     = static_cast<char *>(malloc(block_size));
+        gInternBlockLeft = block_size;
+        Check(gInternBlock);
     }
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
-    return *this;
+
+    InternEntry *entry = reinterpret_cast<InternEntry *>(gInternBlock);
+    gInternBlock     += bytes;
+    gInternBlockLeft -= bytes;
+
+    entry->hash   = hash;
+    entry->length = string.Length();
+    vmemcpy(entry->data, string.Data(), string.Length());
+    entry->data[string.Length()] = '\0';
+
+    return entry;
+}
+
+Symbol String::Intern(StringView string)
+{
+    if (string.Empty()) return Symbol();
+
+    u64 hash = string.Hash();
+
+    if (u32 id = InternFind(gInternTable.load(std::memory_order_acquire), string, hash))
+    {
+        return Symbol(id);
+    }
+
+    std::lock_guard<std::mutex> lock(gInternMutex);
+
+    // @NOTE(Roman): Someone could intern it while we were waiting for the lock.
+    InternTable *table = gInternTable.load(std::memory_order_relaxed);
+    if (u32 id = InternFind(table, string, hash))
+    {
+        return Symbol(id);
+    }
+
+    Check(gInternCount < 0xFFFFFFFF);
+    u32 id = static_cast<u32>(++gInternCount);
+
+    InternEntry **slot = InternSlot(id, true);
+    *slot = NewInternEntry(string, hash);
+
+    // @NOTE(Roman): Grow at half load, so probe sequences stay short.
+    if (!table || 2 * gInternCount > table->mask + 1)
+    {
+        InternTable *grown = NewInternTable(table ? 2 * (table->mask + 1) : INTERN_FIRST_SLOTS);
+
+        for (u32 old_id = 1; old_id < id; ++old_id)
+        {
+            InternInsert(grown, InternEntryOf(old_id)->hash, old_id);
+        }
+
+        grown->retired = table;
+        table          = grown;
+    }
+
+    InternInsert(table, hash, id);
+    gInternTable.store(table, std::memory_order_release);
+
+    return Symbol(id);
 }
 
-String& String::WriteToFile(int unix_file, bool binary)
+StringView Symbol::View() const
 {
-    if (binary)
-    {
-        DebugResult(_write(unix_file, &mLength, sizeof(u64)) != -1);
-    }
-    DebugResult(_write(unix_file, mData, static_cast<int>(mLength)) != -1);
-    return *this;
+    if (!mId) return StringView("", 0);
+
+    InternEntry *entry = InternEntryOf(mId);
+    return StringView(entry->data, entry->length);
 }
 
-String& String::WriteToFile(void *win_file, bool binary)
+//
+// PatternSet
+//
+
+PatternSet::PatternSet()
+    : mPatterns(0),
+      mCount(0),
+      mCapacity(0),
+      mMaxLength(0),
+      mEngine(Engine::Auto),
+      mTeddyTables{},
+      mBucketStart{},
+      mBucketPatterns(0),
+      mClasses{},
+      mClassCount(0),
+      mStateCount(0),
+      mStart(0),
+      mMatchLimit(0),
+      mTransitions(0),
+      mOutputHeads(0),
+      mOutputs(0)
 {
-#ifdef _WIN32
-    if (binary)
-    {
-        DebugResult(WriteFile(win_file, &mLength, sizeof(u64), 0, 0) != -1);
-    }
-    DebugResult(WriteFile(win_file, mData, static_cast<int>(mLength), 0, 0));
-#endif
-    return *this;
 }
 
-String& String::WriteToFile(FILE *crt_file, bool binary)
+PatternSet::PatternSet(PatternSet&& other) noexcept
+    : PatternSet()
 {
-    if (binary)
-    {
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
-    }
-    fwrite(mData, mLength, 1, crt_file);
-    return *this;
+    *this = std::move(other);
 }
 
-String& String::WriteToFile(const char *filename, bool binary)
+PatternSet::~PatternSet()
 {
-    FILE *crt_file = 0;
-    if (binary)
-    {
-        crt_file = fopen(filename, "wb");
-        Check(crt_file);
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
-    }
-    else
-    {
-        crt_file = fopen(filename, "wt");
-        Check(crt_file);
-    }
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
-    return *this;
+    FreeCompiled();
+    free(mPatterns);
 }
 
-String& String::WriteToFile(const String& filename, bool binary)
+PatternSet& PatternSet::operator=(PatternSet&& other) noexcept
 {
-    FILE *crt_file = 0;
-    if (binary)
-    {
-        crt_file = fopen(filename.mData, "wb");
-        Check(crt_file);
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
-    }
-    else
+    if (&other != this)
     {
-        crt_file = fopen(filename.mData, "wt");
-        Check(crt_file);
+        FreeCompiled();
+        free(mPatterns);
+
+        mBytes          = std::move(other.mBytes);
+        mPatterns       = other.mPatterns;
+        mCount          = other.mCount;
+        mCapacity       = other.mCapacity;
+        mMaxLength      = other.mMaxLength;
+        mEngine         = other.mEngine;
+        mBucketPatterns = other.mBucketPatterns;
+        mClassCount     = other.mClassCount;
+        mStateCount     = other.mStateCount;
+        mStart          = other.mStart;
+        mMatchLimit     = other.mMatchLimit;
+        mTransitions    = other.mTransitions;
+        mOutputHeads    = other.mOutputHeads;
+        mOutputs        = other.mOutputs;
+
+        vmemcpy(mTeddyTables, other.mTeddyTables, sizeof(mTeddyTables));
+        vmemcpy(mBucketStart, other.mBucketStart, sizeof(mBucketStart));
+        vmemcpy(mClasses,     other.mClasses,     sizeof(mClasses));
+
+        other.mPatterns       = 0;
+        other.mCount          = 0;
+        other.mCapacity       = 0;
+        other.mMaxLength      = 0;
+        other.mEngine         = Engine::Auto;
+        other.mBucketPatterns = 0;
+        other.mTransitions    = 0;
+        other.mOutputHeads    = 0;
+        other.mOutputs        = 0;
     }
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
     return *this;
 }
 
-String& String::ReadFromFile(int unix_file, u64 num_chars_to_read, bool binary)
+u32 PatternSet::Add(StringView pattern)
 {
-    u64 old_len = mLength;
+    Check(pattern.Length() && pattern.Length() <= 0xFFFFFFFF);
 
-    if (binary)
-    {
-        DebugResult(_read(unix_file, &mLength, sizeof(u64)) != -1);
-    }
-    else
-    {
-        mLength = num_chars_to_read;
-    }
+    FreeCompiled();
 
-    if (mLength >= mCapacity)
+    if (mCount == mCapacity)
     {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
-    }
-    else if (mLength < old_len)
-    {
-        vmemset(mData + mLength, '\0', old_len - mLength);
+        mCapacity = mCapacity ? 2 * mCapacity : 16;
+        mPatterns = static_cast<Entry *>(realloc(mPatterns, mCapacity * sizeof(Entry)));
+        Check(mPatterns);
     }
 
-    DebugResult(_read(unix_file, mData, static_cast<int>(mLength)) != -1);
+    Entry *entry  = mPatterns + mCount;
+    entry->offset = mBytes.Length();
+    entry->length = static_cast<u32>(pattern.Length());
 
-    return *this;
+    mBytes.PushBack(pattern.Data(), pattern.Length());
+
+    if (mMaxLength < entry->length) mMaxLength = entry->length;
+
+    return mCount++;
 }
 
-String& String::ReadFromFile(void *win_file, u64 num_chars_to_read, bool binary)
+void PatternSet::Clear()
 {
-    u64 old_len = mLength;
+    FreeCompiled();
+    mBytes.Clear();
+    mCount     = 0;
+    mMaxLength = 0;
+}
 
-    if (binary)
-    {
-        DebugResult(ReadFile(win_file, &mLength, sizeof(u64), 0, 0));
-    }
-    else
-    {
-        mLength = num_chars_to_read;
-    }
+StringView PatternSet::Pattern(u32 id) const
+{
+    Check(id < mCount);
+    return StringView(mBytes.Data() + mPatterns[id].offset, mPatterns[id].length);
+}
 
-    if (mLength >= mCapacity)
-    {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
-    }
-    else if (mLength < old_len)
+void PatternSet::FreeCompiled()
+{
+    free(mBucketPatterns);
+    free(mTransitions);
+    free(mOutputHeads);
+    free(mOutputs);
+
+    mBucketPatterns = 0;
+    mTransitions    = 0;
+    mOutputHeads    = 0;
+    mOutputs        = 0;
+    mEngine         = Engine::Auto;
+}
+
+void PatternSet::Compile(Engine engine)
+{
+    FreeCompiled();
+
+    if (engine == Engine::Auto)
     {
-        vmemset(mData + mLength, '\0', old_len - mLength);
+        // @NOTE(Roman): Without byte shuffles Teddy's filter costs more per byte than walking the automaton.
+        bool shuffles = GetKernels().teddy_mask != TeddyMaskScalar;
+        engine = mCount <= TeddyMaxPatterns && shuffles ? Engine::Teddy : Engine::AhoCorasick;
     }
 
-    DebugResult(ReadFile(win_file, mData, static_cast<int>(mLength), 0, 0));
+    if (engine == Engine::Teddy) CompileTeddy();
+    else                         CompileAhoCorasick();
 
-    return *this;
+    mEngine = engine;
 }
 
-String& String::ReadFromFile(FILE *crt_file, u64 num_chars_to_read, bool binary)
+void PatternSet::CompileTeddy()
 {
-    u64 old_len = mLength;
+    const u8 *bytes       = reinterpret_cast<const u8 *>(mBytes.Data());
+    u32       fingerprint = 3;
 
-    if (binary)
-    {
-        fread(&mLength, sizeof(u64), 1, crt_file);
-    }
-    else
+    for (u32 id = 0; id < mCount; ++id)
     {
-        mLength = num_chars_to_read;
+        if (mPatterns[id].length < fingerprint) fingerprint = mPatterns[id].length;
     }
 
-    if (mLength >= mCapacity)
+    mBucketPatterns = static_cast<u32 *>(malloc((mCount ? mCount : 1) * sizeof(u32)));
+    Check(mBucketPatterns);
+
+    // @NOTE(Roman): Sorted by the fingerprinted bytes, so patterns that start alike share buckets
+    //               and each bucket's masks stay sparse.
+    for (u32 i = 0; i < mCount; ++i)
     {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
+        const u8 *data = bytes + mPatterns[i].offset;
+        u32       j    = i;
+
+        for (; j && memcmp(bytes + mPatterns[mBucketPatterns[j - 1]].offset, data, fingerprint) > 0; --j)
+        {
+            mBucketPatterns[j] = mBucketPatterns[j - 1];
+        }
+        mBucketPatterns[j] = i;
     }
-    else if (mLength < old_len)
+
+    for (u32 bucket = 0; bucket <= 8; ++bucket)
     {
-        vmemset(mData + mLength, '\0', old_len - mLength);
+        mBucketStart[bucket] = static_cast<u32>(static_cast<u64>(mCount) * bucket / 8);
     }
 
-    fread(mData, mLength, 1, crt_file);
+    // @NOTE(Roman): Bytes past the fingerprint match every bucket.
+    vmemset(mTeddyTables, '\0', sizeof(mTeddyTables));
+    vmemset(mTeddyTables + 32 * fingerprint, static_cast<char>(0xFF), 32 * (3 - fingerprint));
 
-    return *this;
+    for (u32 bucket = 0; bucket < 8; ++bucket)
+    {
+        for (u32 i = mBucketStart[bucket]; i < mBucketStart[bucket + 1]; ++i)
+        {
+            const u8 *data = bytes + mPatterns[mBucketPatterns[i]].offset;
+
+            for (u32 k = 0; k < fingerprint; ++k)
+            {
+                mTeddyTables[32 * k + (data[k] & 0x0F)]    |= 1 << bucket;
+                mTeddyTables[32 * k + 16 + (data[k] >> 4)] |= 1 << bucket;
+            }
+        }
+    }
 }
 
-String& String::ReadFromFile(const char *filename, u64 num_chars_to_read, bool binary)
+// @NOTE(Roman): Bytes that no pattern has share class 0, so rows stay as short as the patterns' alphabet.
+//               The trie is turned into a full transition table in breadth-first order, missing edges
+//               take the edge of the failure link. Each state's outputs continue with the outputs
+//               of its failure link. Then states with outputs are moved to the front,
+//               so the search loop tells them apart with a single compare.
+void PatternSet::CompileAhoCorasick()
 {
-    FILE *crt_file = 0;
-    u64   old_len  = mLength;
+    const u8 *bytes      = reinterpret_cast<const u8 *>(mBytes.Data());
+    bool      used[256]  = {};
+    u32       used_count = 0;
 
-    if (binary)
-    {
-        DebugResult(crt_file = fopen(filename, "rb"));
-        fread(&mLength, sizeof(u64), 1, crt_file);
-    }
-    else
+    for (u64 i = 0; i < mBytes.Length(); ++i)
     {
-        DebugResult(crt_file = fopen(filename, "rt"));
-        mLength = num_chars_to_read;
+        used_count += !used[bytes[i]];
+        used[bytes[i]] = true;
     }
 
-    if (mLength >= mCapacity)
-    {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
-    }
-    else if (mLength < old_len)
+    u32 next_class = used_count == 256 ? 0 : 1;
+    for (u32 byte = 0; byte < 256; ++byte)
     {
-        vmemset(mData + mLength, '\0', old_len - mLength);
+        mClasses[byte] = used[byte] ? static_cast<u8>(next_class++) : 0;
     }
+    mClassCount = next_class;
 
-    fread(mData, mLength, 1, crt_file);
-    fclose(crt_file);
-    return *this;
-}
+    u64 max_states = mBytes.Length() + 1;
+    u32 classes    = mClassCount;
 
-String& String::ReadFromFile(const String& filename, u64 num_chars_to_read, bool binary)
-{
-    FILE *crt_file = 0;
-    u64   old_len  = mLength;
+    Check(max_states * classes <= 0xFFFFFFFF);
 
-    if (binary)
+    u32 *trie  = static_cast<u32 *>(calloc(max_states * classes, sizeof(u32)));
+    u32 *heads = static_cast<u32 *>(calloc(max_states, sizeof(u32)));
+    u32 *tails = static_cast<u32 *>(malloc(max_states * sizeof(u32)));
+    mOutputs   = static_cast<Output *>(malloc((mCount ? mCount : 1) * sizeof(Output)));
+    Check(trie && heads && tails && mOutputs);
+
+    // @NOTE(Roman): In the trie 0 is a missing edge, root is never a child. Output i + 1 is pattern i.
+    u32 state_count = 1;
+
+    for (u32 id = 0; id < mCount; ++id)
     {
-        DebugResult(crt_file = fopen(filename.mData, "rb"));
-        fread(&mLength, sizeof(u64), 1, crt_file);
+        const u8 *data  = bytes + mPatterns[id].offset;
+        u32       state = 0;
+
+        for (u32 i = 0; i < mPatterns[id].length; ++i)
+        {
+            u32 *edge = trie + state * classes + mClasses[data[i]];
+            if (!*edge) *edge = state_count++;
+            state = *edge;
+        }
+
+        mOutputs[id].pattern = id;
+        mOutputs[id].next    = heads[state];
+
+        if (!heads[state]) tails[state] = id;
+        heads[state] = id + 1;
     }
-    else
+
+    u32 *links       = static_cast<u32 *>(malloc(state_count * sizeof(u32)));
+    u32 *queue       = static_cast<u32 *>(malloc(state_count * sizeof(u32)));
+    u32  queue_begin = 0;
+    u32  queue_end   = 0;
+    Check(links && queue);
+
+    for (u32 c = 0; c < classes; ++c)
     {
-        DebugResult(crt_file = fopen(filename.mData, "rt"));
-        mLength = num_chars_to_read;
+        if (u32 child = trie[c])
+        {
+            links[child]       = 0;
+            queue[queue_end++] = child;
+        }
     }
 
-    if (mLength >= mCapacity)
+    while (queue_begin < queue_end)
     {
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
+        u32  state = queue[queue_begin++];
+        u32  link  = links[state];
+        u32 *row   = trie + state * classes;
+
+        if (heads[link])
+        {
+            if (heads[state]) mOutputs[tails[state]].next = heads[link];
+            else              heads[state]                = heads[link];
+        }
+
+        for (u32 c = 0; c < classes; ++c)
+        {
+            if (row[c])
+            {
+                links[row[c]]      = trie[link * classes + c];
+                queue[queue_end++] = row[c];
+            }
+            else
+            {
+                row[c] = trie[link * classes + c];
+            }
+        }
     }
-    else if (mLength < old_len)
+
+    u32 match_count = 0;
+    for (u32 state = 0; state < state_count; ++state)
     {
-        vmemset(mData + mLength, '\0', old_len - mLength);
+        match_count += heads[state] != 0;
     }
 
-    fread(mData, mLength, 1, crt_file);
-    fclose(crt_file);
-    return *this;
-}
-
-const String& String::AppendToFile(const char *filename, bool binary) const
-{
-    FILE *crt_file = 0;
+    u32 *order      = queue;
+    u32  next_match = 0;
+    u32  next_other = match_count;
 
-    if (binary)
+    for (u32 state = 0; state < state_count; ++state)
     {
-        DebugResult(crt_file = fopen(filename, "ab"));
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
+        order[state] = heads[state] ? next_match++ : next_other++;
     }
-    else
+
+    mTransitions = static_cast<u32 *>(malloc(static_cast<u64>(state_count) * classes * sizeof(u32)));
+    mOutputHeads = static_cast<u32 *>(malloc(match_count ? match_count * sizeof(u32) : sizeof(u32)));
+    Check(mTransitions && mOutputHeads);
+
+    for (u32 state = 0; state < state_count; ++state)
     {
-        DebugResult(crt_file = fopen(filename, "at"));
+        const u32 *from = trie + state * classes;
+        u32       *to   = mTransitions + order[state] * classes;
+
+        for (u32 c = 0; c < classes; ++c)
+        {
+            to[c] = order[from[c]] * classes;
+        }
+
+        if (heads[state]) mOutputHeads[order[state]] = heads[state];
     }
 
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
+    mStateCount = state_count;
+    mStart      = order[0] * classes;
+    mMatchLimit = match_count * classes;
 
-    return *this;
+    free(trie);
+    free(heads);
+    free(tails);
+    free(links);
+    free(queue);
 }
 
-const String& String::AppendToFile(const String& filename, bool binary) const
+u64 PatternSet::FindTeddy(const char *text, u64 length, Callback callback, void *user_data, bool leftmost) const
 {
-    FILE *crt_file = 0;
+    const char *bytes    = mBytes.Data();
+    char        tail[64 + 2];
+    u8          buckets[64];
+    u64         reported = 0;
 
-    if (binary)
+    for (u64 block = 0; block < length; block += 64)
     {
-        DebugResult(crt_file = fopen(filename.mData, "ab"));
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
-    }
-    else
-    {
-        DebugResult(crt_file = fopen(filename.mData, "at"));
-    }
+        const char *data = text + block;
+        u64         left = length - block;
 
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
+        if (left < sizeof(tail))
+        {
+            vmemset(tail, '\0', sizeof(tail));
+            vmemcpy(tail, data, left);
+            data = tail;
+        }
 
-    return *this;
-}
+        u64 mask = TeddyMask(data, mTeddyTables, buckets);
+        if (left < 64) mask &= (1ull << left) - 1;
 
-String& String::AppendToFile(const char *filename, bool binary)
-{
-    FILE *crt_file = 0;
+        while (mask)
+        {
+            u64 offset   = CountTrailingZeros64(mask);
+            u64 position = block + offset;
+            u32 bits     = buckets[offset];
+            u64 before   = reported;
 
-    if (binary)
-    {
-        DebugResult(crt_file = fopen(filename, "ab"));
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
+            mask &= mask - 1;
+
+            while (bits)
+            {
+                u32 bucket = CountTrailingZeros(bits);
+                bits &= bits - 1;
+
+                for (u32 i = mBucketStart[bucket]; i < mBucketStart[bucket + 1]; ++i)
+                {
+                    u32          id      = mBucketPatterns[i];
+                    const Entry& pattern = mPatterns[id];
+
+                    if (pattern.length <= length - position && !memcmp(text + position, bytes + pattern.offset, pattern.length))
+                    {
+                        Match match = { position, pattern.length, id };
+                        ++reported;
+                        if (!callback(match, user_data)) return reported;
+                    }
+                }
+            }
+
+            // @NOTE(Roman): Candidates come in order of offset, nothing after this one can start further left.
+            if (leftmost && reported != before) return reported;
+        }
     }
-    else
+
+    return reported;
+}
+
+// @NOTE(Roman): Reports outputs of the match state that ends at end. With limit, also lowers it past which
+//               no match can start at or before the ones reported. Returns false if the callback stopped the search.
+bool PatternSet::ReportOutputs(u32 state, u64 end, Callback callback, void *user_data, u64 *reported, u64 *limit) const
+{
+    for (u32 output = mOutputHeads[state / mClassCount]; output; output = mOutputs[output - 1].next)
     {
-        DebugResult(crt_file = fopen(filename, "at"));
-    }
+        u32   id    = mOutputs[output - 1].pattern;
+        Match match = { end + 1 - mPatterns[id].length, mPatterns[id].length, id };
 
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
+        ++*reported;
+        if (!callback(match, user_data)) return false;
 
-    return *this;
+        if (limit && *limit > match.offset + mMaxLength) *limit = match.offset + mMaxLength;
+    }
+    return true;
 }
 
-String& String::AppendToFile(const String& filename, bool binary)
+// @NOTE(Roman): Every step is a load that depends on the previous one, so long texts are split in two halves
+//               walked in the same loop, which keeps two loads in flight. The second walk starts
+//               mMaxLength - 1 bytes early to pick up matches that cross the middle, but reports only
+//               the ones that end in its half. Leftmost search walks the text once, in order of match ends,
+//               so it can stop as soon as nothing else can start further left.
+u64 PatternSet::FindAhoCorasick(const char *text, u64 length, Callback callback, void *user_data, bool leftmost) const
 {
-    FILE *crt_file = 0;
-
-    if (binary)
+    const u32 *transitions = mTransitions;
+    const u8  *classes     = mClasses;
+    u32        match_limit = mMatchLimit;
+    u64        reported    = 0;
+    u64        i           = 0;
+    u32        state       = mStart;
+
+    if (!leftmost && length >= 4 * static_cast<u64>(mMaxLength) && length >= 256)
     {
-        DebugResult(crt_file = fopen(filename.mData, "ab"));
-        fwrite(&mLength, sizeof(u64), 1, crt_file);
+        u64 half   = length / 2;
+        u64 j      = half - (mMaxLength - 1);
+        u32 second = mStart;
+
+        for (; i < half; ++i, ++j)
+        {
+            state  = transitions[state  + classes[static_cast<u8>(text[i])]];
+            second = transitions[second + classes[static_cast<u8>(text[j])]];
+
+            if (state < match_limit || second < match_limit)
+            {
+                if (state  < match_limit &&             !ReportOutputs(state,  i, callback, user_data, &reported, 0)) return reported;
+                if (second < match_limit && j >= half && !ReportOutputs(second, j, callback, user_data, &reported, 0)) return reported;
+            }
+        }
+
+        i     = j;
+        state = second;
     }
-    else
+
+    u64  limit     = length;
+    u64 *limit_ptr = leftmost ? &limit : 0;
+
+    for (; i < limit; ++i)
     {
-        DebugResult(crt_file = fopen(filename.mData, "at"));
+        state = transitions[state + classes[static_cast<u8>(text[i])]];
+
+        if (state < match_limit && !ReportOutputs(state, i, callback, user_data, &reported, limit_ptr)) return reported;
     }
 
-    fwrite(mData, mLength, 1, crt_file);
-    fclose(crt_file);
+    return reported;
+}
 
-    return *this;
+u64 PatternSet::Find(const char *text, u64 length, Callback callback, void *user_data, bool leftmost) const
+{
+    if (!mCount || !length) return 0;
+
+    Check(mEngine != Engine::Auto);
+
+    return mEngine == Engine::Teddy
+         ? FindTeddy(text, length, callback, user_data, leftmost)
+         : FindAhoCorasick(text, length, callback, user_data, leftmost);
 }
 
-char String::operator[](u64 index) const
+u64 PatternSet::FindAll(StringView text, Callback callback, void *user_data) const
 {
-    Check(index < mLength);
-    return static_cast<char *>(mData)[index];
+    return Find(text.Data(), text.Length(), callback, user_data, false);
 }
 
-char& String::operator[](u64 index)
+struct PatternMatches
+{
+    PatternSet::Match *matches;
+    u64                max_matches;
+    u64                count;
+};
+
+static bool CollectMatch(const PatternSet::Match& match, void *user_data)
 {
-    Check(index < mLength);
-    return static_cast<char *>(mData)[index];
+    PatternMatches *matches = static_cast<PatternMatches *>(user_data);
+
+    if (matches->count < matches->max_matches) matches->matches[matches->count] = match;
+    ++matches->count;
+    return true;
 }
 
-String& String::operator=(const String& other)
+u64 PatternSet::FindAll(StringView text, Match *matches, u64 max_matches) const
 {
-    if (&other != this)
-    {
-        if (other.mLength < mCapacity)
-        {
-            if (mLength > other.mLength)
-            {
-                vmemset(mData + other.mLength + 1, '\0', mLength - (other.mLength + 1));
-            }
-            vmemcpy(mData, other.mData, other.mLength);
-            mLength = other.mLength;
-        }
-        else
-        {
-            mLength   = other.mLength;
-            mCapacity = Align(mLength + 1);
-            mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
-            vmemcpy(mData, other.mData, other.mLength);
-        }
-    }
-    return *this;
+    PatternMatches collected = { matches, max_matches, 0 };
+    Find(text.Data(), text.Length(), CollectMatch, &collected, false);
+    return collected.count;
 }
 
-String& String::operator=(String&& other) noexcept
+struct LeftmostMatch
 {
-    if (&other != this)
-    {
-        if (mData) free(mData);
+    PatternSet::Match match;
+    bool              found;
+};
 
-        mData     = other.mData;
-        mLength   = other.mLength;
-        mCapacity = other.mCapacity;
+static bool KeepLeftmost(const PatternSet::Match& match, void *user_data)
+{
+    LeftmostMatch *leftmost = static_cast<LeftmostMatch *>(user_data);
 
-        other.mData = 0;
+    if (!leftmost->found
+    ||  match.offset < leftmost->match.offset
+    ||  (match.offset == leftmost->match.offset && match.pattern < leftmost->match.pattern))
+    {
+        leftmost->match = match;
+        leftmost->found = true;
     }
-    return *this;
+    return true;
 }
 
-String& String::operator=(char symbol)
+static bool StopAtFirst(const PatternSet::Match&, void *)
 {
-    if (mData)
-    {
-        mData[0] = symbol;
-        vmemset(mData + 1, '\0', mLength - 1);
-        mLength  = 1;
-    }
-    else
-    {
-        mLength   = 1;
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(calloc(1, mCapacity));
-        mData[0]  = symbol;
-    }
-    return *this;
+    return false;
 }
 
-String& String::operator=(const char *cstring)
+bool PatternSet::FindAny(StringView text, Match *first) const
 {
-    u64 cstring_length = strlen(cstring);
-    if (cstring_length < mCapacity)
-    {
-        if (mLength > cstring_length)
-        {
-            vmemset(mData + cstring_length + 1, '\0', mLength - (cstring_length + 1));
-        }
-        vmemcpy(mData, const_cast<char *>(cstring), cstring_length);
-        mLength = cstring_length;
-    }
-    else
-    {
-        mLength   = cstring_length;
-        mCapacity = Align(mLength + 1);
-        mData     = static_cast<char *>(_recalloc(mData, 1, mCapacity));
-        vmemcpy(mData, const_cast<char *>(cstring), mLength);
-    }
-    return *this;
+    if (!first) return Find(text.Data(), text.Length(), StopAtFirst, 0, false) != 0;
+
+    LeftmostMatch leftmost = {};
+    Find(text.Data(), text.Length(), KeepLeftmost, &leftmost, true);
+
+    if (leftmost.found) *first = leftmost.match;
+    return leftmost.found;
 }
@@ -4,12 +4,395 @@
 
 #pragma once
 
+#include <functional>
 #include <type_traits>
 #include <stdio.h>
+#include <string.h>
 
 typedef signed char        s8;
+typedef unsigned char      u8;
+typedef unsigned short     u16;
+typedef unsigned int       u32;
+typedef signed long long   s64;
 typedef unsigned long long u64;
 
+// @NOTE(Roman): LengthFirst orders shorter strings first and strings of equal length by their bytes,
+//               it's the cheapest order and the one comparison operators use.
+//               Lexicographic is dictionary order of unsigned bytes, same as memcmp and std::string,
+//               use it for sorted indexes and range scans.
+enum class CompareMode : u8
+{
+    LengthFirst,
+    Lexicographic,
+};
+
+class CharSet;
+class StringSplit;
+class StringFormatArgument;
+struct StringFormatItem;
+
+// @NOTE(Roman): Non-owning pointer + length pair. It's never null terminated,
+//               and it's valid only while the memory it points to is alive and unchanged.
+class StringView
+{
+public:
+    static constexpr u64 NotFound = ~0ull;
+
+    StringView()                             : mData(0),       mLength(0)               {}
+    StringView(const char *cstring)          : mData(cstring), mLength(strlen(cstring)) {}
+    StringView(const char *data, u64 length) : mData(data),    mLength(length)          {}
+
+    const char *Data()   const { return mData;    }
+    u64         Length() const { return mLength;  }
+    bool        Empty()  const { return !mLength; }
+
+    // @NOTE(Roman): Same ordering as String::Compare.
+    s8   Compare(StringView other, CompareMode mode = CompareMode::LengthFirst) const;
+    bool Equals(StringView other) const { return !Compare(other); }
+
+    bool StartsWith(StringView prefix) const;
+    bool EndsWith(StringView suffix)   const;
+
+    // @NOTE(Roman): Number of leading bytes both views share.
+    u64 CommonPrefixLength(StringView other) const;
+
+    // @NOTE(Roman): ASCII letters only, other bytes must match exactly. Nothing is copied,
+    //               case is folded inside the vector compare.
+    s8         CompareIgnoreCase(StringView other, CompareMode mode = CompareMode::LengthFirst) const;
+    bool       EqualsIgnoreCase(StringView other)                                               const;
+    StringView FindIgnoreCase(StringView string)                                                const;
+    u64        FindIndexIgnoreCase(StringView string, u64 from = 0)                             const;
+
+    // @NOTE(Roman): Returns the part of this view that matches the string,
+    //               or an empty view with null data if there is no match.
+    StringView Find(StringView string) const;
+
+    // @NOTE(Roman): Offset of the first match at or after from, NotFound if there is none.
+    //               A set matches any of its bytes.
+    u64 FindIndex(StringView     string, u64 from = 0) const;
+    u64 FindIndex(char           symbol, u64 from = 0) const;
+    u64 FindIndex(const CharSet& set,    u64 from = 0) const;
+
+    // @NOTE(Roman): Offset of the first byte at or after from that isn't in the set, NotFound if there is none,
+    //               like skipping leading whitespace before FindIndex looks for the end of a field.
+    u64 FindIndexNotIn(const CharSet& set, u64 from = 0) const;
+
+    // @NOTE(Roman): Offset of the last match that ends at or before to, NotFound if there is none.
+    //               Scans backward from to, so a match near the end costs only the bytes after it.
+    u64 FindLastIndex(StringView     string, u64 to = NotFound) const;
+    u64 FindLastIndex(char           symbol, u64 to = NotFound) const;
+    u64 FindLastIndex(const CharSet& set,    u64 to = NotFound) const;
+
+    // @NOTE(Roman): Same as Find, but the last match.
+    StringView FindLast(StringView string) const;
+
+    // @NOTE(Roman): Parts after and before the last match, the whole view if there is none,
+    //               like "dir/file.tar.gz" gives "gz" after the last '.' and "dir" before the last '/'.
+    StringView AfterLast(char           symbol) const;
+    StringView AfterLast(StringView     string) const;
+    StringView AfterLast(const CharSet& set)    const;
+    StringView BeforeLast(char           symbol) const;
+    StringView BeforeLast(StringView     string) const;
+    StringView BeforeLast(const CharSet& set)    const;
+
+    // @NOTE(Roman): Offsets of all matches in order, overlapping ones too. Writes the first max_offsets of them,
+    //               returns the number of all matches. Views of STRING_PARALLEL_THRESHOLD bytes and more
+    //               are searched in parts by a pool of worker threads.
+    u64 FindAll(StringView string, u64 *offsets, u64 max_offsets) const;
+    u64 Count(StringView string) const;
+
+    // @NOTE(Roman): Number of bytes equal to the symbol or in the set, like Count('\n') for lines.
+    u64 Count(char           symbol) const;
+    u64 Count(const CharSet& set)    const;
+
+    StringView SubString(u64 from, u64 to) const;
+
+    // @NOTE(Roman): Valid UTF-8 has no overlong forms, surrogates or code points above U+10FFFF.
+    //               FindInvalidUtf8Index is the offset of the first byte of the first bad sequence, NotFound if there's none.
+    bool IsValidUtf8()          const;
+    u64  FindInvalidUtf8Index() const;
+
+    // @NOTE(Roman): These expect valid UTF-8, code points are counted by their first bytes.
+    //               CodePointOffset is the byte offset of the code point with that index, Length() for the count
+    //               of code points, NotFound past it. CodePointStart moves a byte offset back to the start of
+    //               its code point, so cutting there never splits a sequence.
+    //               CodePointAt decodes the code point at a byte offset and its length, U+FFFD and 1 for a bad sequence.
+    u64        CountCodePoints()                        const;
+    u64        CodePointOffset(u64 index)               const;
+    u64        CodePointStart(u64 offset)               const;
+    u32        CodePointAt(u64 offset, u32 *length = 0) const;
+    StringView SubStringCodePoints(u64 from, u64 to)    const;
+
+    // @NOTE(Roman): UTF-8 to UTF-16LE and Latin-1. Utf16Length and Latin1Length are exact output sizes for valid input.
+    //               ToUtf16 and ToLatin1 return how many units they wrote and stop at the first sequence that's invalid
+    //               or, for Latin-1, above U+00FF. Its offset goes to error_index, NotFound if everything was converted.
+    u64 Utf16Length()                             const;
+    u64 Latin1Length()                            const;
+    u64 ToUtf16(u16 *out, u64 *error_index = 0)   const;
+    u64 ToLatin1(char *out, u64 *error_index = 0) const;
+
+    // @NOTE(Roman): Number at the very start of the view, returns how many bytes it takes, 0 if there's none
+    //               or the integer doesn't fit, value is left unchanged then. Decimal digits only,
+    //               the separator is '.' whatever the locale. Doubles take exponents, inf, infinity and nan,
+    //               are rounded to nearest and overflow to inf, like "-12.5e3,x" gives -12500 and 8.
+    u64 ParseInt(s64 *value)       const;
+    u64 ParseUInt(u64 *value)      const;
+    u64 ParseDouble(double *value) const;
+
+    // @NOTE(Roman): 64-bit hash of the bytes. Equal views hash equally whatever memory they point to,
+    //               and String::Hash gives the same value. It's never 0.
+    u64 Hash(u64 seed = 0) const;
+
+    // @NOTE(Roman): Lazy range of the pieces between delimiters, nothing is allocated or copied.
+    //               Delimiter is a byte, a byte sequence or any byte of a set.
+    //               Empty pieces are produced too unless skip_empty is set, like "a,,b" gives "a", "" and "b".
+    //               An empty delimiter matches nothing, the whole view is the only piece.
+    StringSplit Split(char           delimiter,  bool skip_empty = false) const;
+    StringSplit Split(StringView     delimiter,  bool skip_empty = false) const;
+    StringSplit Split(const CharSet& delimiters, bool skip_empty = false) const;
+
+    char operator[](u64 index) const { return mData[index]; }
+
+private:
+    const char *mData;
+    u64         mLength;
+};
+
+// @NOTE(Roman): Set of bytes kept as two 16-entry nibble tables, so vector code tests a whole block
+//               with two shuffles: entry [low nibble] has bit (high nibble) set for every member,
+//               the first table covers high nibbles 0-7, the second 8-15.
+class CharSet
+{
+public:
+    CharSet() { memset(mTables, 0, sizeof(mTables)); }
+    explicit CharSet(StringView symbols) : CharSet() { Add(symbols); }
+
+    CharSet& Add(char symbol)
+    {
+        u8 byte = static_cast<u8>(symbol);
+        mTables[(byte >> 7) * 16 + (byte & 0x0F)] |= static_cast<u8>(1 << ((byte >> 4) & 7));
+        return *this;
+    }
+
+    CharSet& Add(StringView symbols)
+    {
+        for (u64 i = 0; i < symbols.Length(); ++i) Add(symbols[i]);
+        return *this;
+    }
+
+    bool Contains(char symbol) const
+    {
+        u8 byte = static_cast<u8>(symbol);
+        return (mTables[(byte >> 7) * 16 + (byte & 0x0F)] >> ((byte >> 4) & 7)) & 1;
+    }
+
+    const u8 *Tables() const { return mTables; }
+
+private:
+    u8 mTables[32];
+};
+
+// @NOTE(Roman): Byte and set delimiters are matched 64 bytes at a time into a bitmask,
+//               which is unpacked into offsets, so moving to the next short piece is a single load
+//               and only a new block costs a call. Byte sequences are searched with FindIndex.
+class StringSplit
+{
+public:
+    class Iterator
+    {
+    public:
+        StringView        operator*()  const { return mPiece;  }
+        const StringView *operator->() const { return &mPiece; }
+
+        Iterator& operator++() { Advance(); return *this; }
+
+        bool operator==(const Iterator& other) const { return mDone == other.mDone && (mDone || mNext == other.mNext); }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        explicit Iterator(const StringSplit *split);
+
+        void Advance();
+        u64  NextDelimiter();
+
+        // @NOTE(Roman): mNext is where the piece after the current one starts, past the end if there is none.
+        //               mOffsets[mIndex..mCount) are delimiters of the 64-byte block at mBlock not consumed yet.
+        const StringSplit *mSplit;
+        StringView         mPiece;
+        u64                mNext;
+        u64                mBlock;
+        u32                mIndex;
+        u32                mCount;
+        bool               mDone;
+        u8                 mOffsets[64];
+
+        friend class StringSplit;
+    };
+
+    Iterator begin() const { return Iterator(this); }
+    Iterator end()   const { return Iterator(0);    }
+
+private:
+    enum class Kind : u8
+    {
+        Byte,
+        Bytes,
+        Set,
+    };
+
+    StringSplit(StringView string, Kind kind, bool skip_empty) : mString(string), mKind(kind), mSkipEmpty(skip_empty), mByte(0) {}
+
+    StringView mString;
+    Kind       mKind;
+    bool       mSkipEmpty;
+    char       mByte;
+    StringView mDelimiter;
+    CharSet    mSet;
+
+    friend class StringView;
+};
+
+// @NOTE(Roman): Inline, so iterating short pieces costs no call except when a new block is scanned.
+inline void StringSplit::Iterator::Advance()
+{
+    if (mDone) return;
+
+    const StringView& string           = mSplit->mString;
+    u64               delimiter_length = mSplit->mKind == Kind::Bytes ? mSplit->mDelimiter.Length() : 1;
+
+    for (;;)
+    {
+        if (mNext > string.Length())
+        {
+            mDone = true;
+            return;
+        }
+
+        u64 start = mNext;
+        u64 end   = mIndex < mCount ? mBlock + mOffsets[mIndex++] : NextDelimiter();
+
+        if (end == StringView::NotFound)
+        {
+            end   = string.Length();
+            mNext = end + 1;
+        }
+        else
+        {
+            mNext = end + delimiter_length;
+        }
+
+        mPiece = StringView(string.Data() + start, end - start);
+
+        if (!mSplit->mSkipEmpty || end > start) return;
+    }
+}
+
+// @NOTE(Roman): Where String's heap buffers come from. Strings without an allocator use malloc/realloc/free.
+//               Results of Concat, SubString and Find use the allocator of their String operand,
+//               the left one when both are Strings, even if the right one is an rvalue whose buffer could be reused.
+//               Insert and friends grow the buffer with the string's own allocator.
+//               bytes passed to Reallocate and Free are always the sizes the memory was allocated with.
+class Allocator
+{
+public:
+    virtual ~Allocator() {}
+
+    virtual void *Allocate(u64 bytes)                                    = 0;
+    virtual void *Reallocate(void *memory, u64 old_bytes, u64 new_bytes) = 0;
+    virtual void  Free(void *memory, u64 bytes)                          = 0;
+};
+
+// @NOTE(Roman): Monotonic arena. Allocations bump a pointer in the current block, Free and Reallocate
+//               reuse memory only for the latest allocation. Reset releases everything at once,
+//               strings that still use the arena must not be touched after that (destroying them is fine).
+//               Not thread safe.
+class ArenaAllocator : public Allocator
+{
+public:
+    ArenaAllocator(u64 block_size = 64 * 1024);
+    ~ArenaAllocator();
+
+    void *Allocate(u64 bytes)                                    override;
+    void *Reallocate(void *memory, u64 old_bytes, u64 new_bytes) override;
+    void  Free(void *memory, u64 bytes)                          override;
+
+    void Reset();
+
+private:
+    struct Block
+    {
+        Block *next;
+        u64    size;
+        u64    used;
+    };
+
+    Block *mBlocks;
+    char  *mLast;
+    u64    mBlockSize;
+};
+
+// @NOTE(Roman): Pool of fixed-size chunks with a free list. Requests larger than a chunk go to malloc.
+//               Not thread safe.
+class PoolAllocator : public Allocator
+{
+public:
+    PoolAllocator(u64 chunk_size, u64 chunks_per_block = 256);
+    ~PoolAllocator();
+
+    void *Allocate(u64 bytes)                                    override;
+    void *Reallocate(void *memory, u64 old_bytes, u64 new_bytes) override;
+    void  Free(void *memory, u64 bytes)                          override;
+
+private:
+    struct Chunk
+    {
+        Chunk *next;
+    };
+
+    struct Block
+    {
+        Block *next;
+    };
+
+    Block *mBlocks;
+    Chunk *mFreeList;
+    u64    mChunkSize;
+    u64    mChunksPerBlock;
+};
+
+// @NOTE(Roman): Handle of a string in the process-wide intern table, see String::Intern.
+//               Equal strings get equal handles, so comparing and hashing symbols
+//               is a single integer operation. Interned strings live until the process exits,
+//               they are null terminated. Default symbol is the empty string.
+//               operator< orders by interning order, not by content.
+class Symbol
+{
+public:
+    Symbol() : mId(0) {}
+
+    u32  Id()    const { return mId;  }
+    bool Empty() const { return !mId; }
+
+    StringView  View()   const;
+    const char *Data()   const { return View().Data();   }
+    u64         Length() const { return View().Length(); }
+
+    operator StringView() const { return View(); }
+
+    u64 Hash() const { return mId * 0x9E3779B97F4A7C15ull; }
+
+    bool operator==(Symbol other) const { return mId == other.mId; }
+    bool operator!=(Symbol other) const { return mId != other.mId; }
+    bool operator< (Symbol other) const { return mId <  other.mId; }
+
+private:
+    explicit Symbol(u32 id) : mId(id) {}
+
+    u32 mId;
+
+    friend class String;
+};
+
 class String
 {
 public:
@@ -20,6 +403,12 @@ public:
     String(const char *cstring, u64 length);
     String(const String& other);
     String(String&& other) noexcept;
+    explicit String(StringView view);
+
+    explicit String(Allocator& allocator);
+    String(const char *cstring,             Allocator& allocator);
+    String(const char *cstring, u64 length, Allocator& allocator);
+    String(StringView   view,               Allocator& allocator);
 
     ~String();
 
@@ -27,11 +416,36 @@ public:
 
     String& Reserve(u64 bytes);
 
-    operator const char *() const { return static_cast<const char *>(mData); }
-    operator       char *()       { return mData;                            }
+    operator const char *() const { return Data(); }
+    operator       char *()       { return Data(); }
+
+    operator StringView() const { return StringView(Data(), Length()); }
+
+    // @NOTE(Roman): Strings shorter than SmallCapacity are stored inside the object itself,
+    //               longer ones live on the heap. Capacity always includes the null terminator.
+    static constexpr u64 SmallCapacity = sizeof(char *) + 2 * sizeof(u64) - 1;
+
+    // @NOTE(Roman): Instruction set the bulk kernels run on: scalar, sse, avx2 or avx512.
+    //               It's detected once, STRING_ISA environment variable can lower it.
+    static const char *KernelISA();
 
-    u64 Length()   const { return mLength;   }
-    u64 Capacity() const { return mCapacity; }
+    // @NOTE(Roman): Returns the symbol of the string, adding it to the intern table the first time.
+    //               Safe to call from any number of threads, lookups of already interned strings take no locks.
+    static Symbol Intern(StringView string);
+           Symbol Intern() const { return Intern(View()); }
+
+    const char *Data() const { return IsSmall() ? mSmall : mHeap.data; }
+          char *Data()
+    {
+        InvalidateHash();
+        return IsSmall() ? mSmall : mHeap.data;
+    }
+
+    // @NOTE(Roman): 0 means malloc/realloc/free.
+    Allocator *GetAllocator() const { return mAllocator; }
+
+    u64 Length()   const { return IsSmall() ? static_cast<u8>(mSmall[SmallTag]) : mHeap.length;            }
+    u64 Capacity() const { return IsSmall() ? SmallCapacity                     : mHeap.capacity & ~HeapFlag; }
 
     // @NOTE(Roman): -1 - less
     //                0 - equals
@@ -39,10 +453,39 @@ public:
     s8 Compare(const String& other) const;
     s8 Compare(const char *cstring) const;
     s8 Compare(const char *cstring, u64 cstring_length) const;
+    s8 Compare(StringView   view, CompareMode mode = CompareMode::LengthFirst) const { return View().Compare(view, mode); }
 
     bool Equals(const String& other)                     const { return !Compare(other);                   }
     bool Equals(const char *cstring)                     const { return !Compare(cstring);                 }
     bool Equals(const char *cstring, u64 cstring_length) const { return !Compare(cstring, cstring_length); }
+    bool Equals(StringView   view)                       const { return !Compare(view);                    }
+
+    bool StartsWith(StringView prefix) const { return View().StartsWith(prefix); }
+    bool EndsWith(StringView suffix)   const { return View().EndsWith(suffix);   }
+
+    u64 CommonPrefixLength(StringView other) const { return View().CommonPrefixLength(other); }
+
+    // @NOTE(Roman): Pieces point into the string, so it has to outlive them and stay unchanged.
+    StringSplit Split(char           delimiter,  bool skip_empty = false) const { return View().Split(delimiter,  skip_empty); }
+    StringSplit Split(StringView     delimiter,  bool skip_empty = false) const { return View().Split(delimiter,  skip_empty); }
+    StringSplit Split(const CharSet& delimiters, bool skip_empty = false) const { return View().Split(delimiters, skip_empty); }
+
+    s8         CompareIgnoreCase(StringView other, CompareMode mode = CompareMode::LengthFirst) const { return View().CompareIgnoreCase(other, mode);   }
+    bool       EqualsIgnoreCase(StringView other)                                               const { return View().EqualsIgnoreCase(other);          }
+    StringView FindIgnoreCase(StringView string)                                                const { return View().FindIgnoreCase(string);           }
+    u64        FindIndexIgnoreCase(StringView string, u64 from = 0)                             const { return View().FindIndexIgnoreCase(string, from); }
+
+    // @NOTE(Roman): In place, ASCII letters only.
+    String& ToLower();
+    String& ToUpper();
+
+    // @NOTE(Roman): Same as View().Hash(). With STRING_CACHED_HASH defined the result is kept in the string
+    //               until it's changed, so hashing the same key again costs nothing.
+    //               Every non-const access to the data drops it, but writes through a pointer
+    //               taken before the call are not seen. Moves carry it over. Caching from several threads
+    //               at once is a race. The cache is a member, so sizeof(String) depends on the macro:
+    //               everything linked together must agree on it, mixing the two layouts is an ODR violation.
+    u64 Hash() const;
 
     String& Insert(u64 where, const String& other);
     String& Insert(u64 where,       char    symbol);
@@ -51,10 +494,47 @@ public:
 
     String& Erase(u64 from, u64 to);
 
-    String& PushBack(const String& other)                     { return Insert(mLength, other);                   }
-    String& PushBack(      char  symbol)                      { return Insert(mLength, symbol);                  }
-    String& PushBack(const char *cstring)                     { return Insert(mLength, cstring);                 }
-    String& PushBack(const char *cstring, u64 cstring_length) { return Insert(mLength, cstring, cstring_length); }
+    // @NOTE(Roman): Replaces [from, to) with the string, the tail is moved once.
+    String& Replace(u64 from, u64 to, StringView with);
+
+    // @NOTE(Roman): Replaces every needle, left to right, matches don't overlap. Matches are found first,
+    //               then the result is assembled in a single pass: in place if replacement is not longer
+    //               than needle or the capacity is enough, into one exactly sized buffer otherwise.
+    //               An empty needle matches nothing, the string is left unchanged.
+    String& ReplaceAll(StringView needle, StringView replacement);
+    String& ReplaceAll(char       symbol, char       replacement);
+
+    String& PushBack(const String& other)  { return PushBack(other.Data(), other.Length()); }
+    String& PushBack(const char   *cstring) { return PushBack(cstring, strlen(cstring));      }
+    String& PushBack(      char    symbol);
+    String& PushBack(const char   *cstring, u64 cstring_length);
+
+    // @NOTE(Roman): Numbers are formatted straight into the spare capacity, no temporary buffer or strlen.
+    //               AppendDouble writes the shortest digits that parse back to the same double, fixed for
+    //               decimal exponents from -6 to 20 and scientific otherwise, like 0.1, 1e+21 and 5e-324.
+    //               AppendHex writes no prefix and pads with zeros up to min_digits, which can exceed 16.
+    String& AppendInt(s64 value);
+    String& AppendUInt(u64 value);
+    String& AppendDouble(double value);
+    String& AppendHex(u64 value, u32 min_digits = 1, bool uppercase = false);
+
+    // @NOTE(Roman): Append UTF-16LE or Latin-1 converted to UTF-8. The exact length is counted first, so capacity
+    //               grows at most once. AppendUtf16 stops at the first unpaired surrogate and puts its index
+    //               into error_index, NotFound if everything was converted.
+    String& AppendUtf16(const u16 *in, u64 in_length, u64 *error_index = 0);
+    String& AppendLatin1(const char *in, u64 in_length);
+
+    static u64 Utf8LengthOfUtf16(const u16 *in, u64 in_length);
+    static u64 Utf8LengthOfLatin1(const char *in, u64 in_length);
+
+    // @NOTE(Roman): Longest text AppendInt, AppendUInt, AppendDouble and AppendHex write.
+    static constexpr u64 MaxNumberLength = 32;
+
+    // @NOTE(Roman): Format string is checked and split at compile time, see STRING_FORMAT.
+    //               The output is sized before the first byte is written, so it's one allocation at most.
+    //               Arguments may view this string itself, like s.AppendFormat(STRING_FORMAT("[{}]"), s).
+    template<typename Literal, typename... Args>        String& AppendFormat(Literal format, const Args&... args);
+    template<typename Literal, typename... Args> static String  Format(Literal format, const Args&... args);
 
     String& PushFront(const String& other)                     { return Insert(0, other);                   }
     String& PushFront(      char  symbol)                      { return Insert(0, symbol);                  }
@@ -89,8 +569,16 @@ public:
     String SubString(u64 from, u64 to) const &;
     String SubString(u64 from, u64 to) &&;
 
+    // @NOTE(Roman): Same as SubString, but from and to count code points of valid UTF-8.
+    String SubStringCodePoints(u64 from, u64 to) const &;
+    String SubStringCodePoints(u64 from, u64 to) &&;
+
     static String SubString(const char *cstring, u64 from, u64 to);
 
+    // @NOTE(Roman): Non-allocating views of the string.
+    StringView View()                 const { return StringView(Data(), Length()); }
+    StringView View(u64 from, u64 to) const { return View().SubString(from, to);   }
+
     String Find(const String& string) const &;
     String Find(const String& string) &&;
     char   Find(      char    symbol) const;
@@ -98,6 +586,51 @@ public:
     String Find(const char   *cstring) &&;
     String Find(const char   *cstring, u64 cstring_length) const &;
     String Find(const char   *cstring, u64 cstring_length) &&;
+    StringView Find(StringView view) const { return View().Find(view); }
+
+    static constexpr u64 NotFound = StringView::NotFound;
+
+    // @NOTE(Roman): Offset of the first match at or after from, NotFound if there is none.
+    u64 FindIndex(StringView     string, u64 from = 0) const { return View().FindIndex(string, from); }
+    u64 FindIndex(char           symbol, u64 from = 0) const { return View().FindIndex(symbol, from); }
+    u64 FindIndex(const CharSet& set,    u64 from = 0) const { return View().FindIndex(set, from);    }
+
+    u64 FindIndexNotIn(const CharSet& set, u64 from = 0) const { return View().FindIndexNotIn(set, from); }
+
+    u64 FindLastIndex(StringView     string, u64 to = NotFound) const { return View().FindLastIndex(string, to); }
+    u64 FindLastIndex(char           symbol, u64 to = NotFound) const { return View().FindLastIndex(symbol, to); }
+    u64 FindLastIndex(const CharSet& set,    u64 to = NotFound) const { return View().FindLastIndex(set, to);    }
+
+    StringView FindLast(StringView string) const { return View().FindLast(string); }
+
+    // @NOTE(Roman): Views into the string, see StringView::AfterLast.
+    StringView AfterLast(char           symbol) const { return View().AfterLast(symbol);  }
+    StringView AfterLast(StringView     string) const { return View().AfterLast(string);  }
+    StringView AfterLast(const CharSet& set)    const { return View().AfterLast(set);     }
+    StringView BeforeLast(char           symbol) const { return View().BeforeLast(symbol); }
+    StringView BeforeLast(StringView     string) const { return View().BeforeLast(string); }
+    StringView BeforeLast(const CharSet& set)    const { return View().BeforeLast(set);    }
+
+    u64 FindAll(StringView string, u64 *offsets, u64 max_offsets) const { return View().FindAll(string, offsets, max_offsets); }
+    u64 Count(StringView string)                                   const { return View().Count(string);                         }
+    u64 Count(char symbol)                                         const { return View().Count(symbol);                         }
+    u64 Count(const CharSet& set)                                  const { return View().Count(set);                            }
+
+    u64 ParseInt(s64 *value)       const { return View().ParseInt(value);    }
+    u64 ParseUInt(u64 *value)      const { return View().ParseUInt(value);   }
+    u64 ParseDouble(double *value) const { return View().ParseDouble(value); }
+
+    bool IsValidUtf8()                            const { return View().IsValidUtf8();               }
+    u64  FindInvalidUtf8Index()                   const { return View().FindInvalidUtf8Index();      }
+    u64  CountCodePoints()                        const { return View().CountCodePoints();           }
+    u64  CodePointOffset(u64 index)               const { return View().CodePointOffset(index);      }
+    u64  CodePointStart(u64 offset)               const { return View().CodePointStart(offset);      }
+    u32  CodePointAt(u64 offset, u32 *length = 0) const { return View().CodePointAt(offset, length); }
+
+    u64 Utf16Length()                             const { return View().Utf16Length();               }
+    u64 Latin1Length()                            const { return View().Latin1Length();              }
+    u64 ToUtf16(u16 *out, u64 *error_index = 0)   const { return View().ToUtf16(out, error_index);   }
+    u64 ToLatin1(char *out, u64 *error_index = 0) const { return View().ToLatin1(out, error_index);  }
 
     static String Find(const char *in_cstring, const String& string);
     static char   Find(const char *in_cstring,       char    symbol);
@@ -144,43 +677,732 @@ public:
     String& operator=(const char    *cstring);
 
 private:
-    char *mData;
-    u64   mLength;
-    u64   mCapacity;
+    // @NOTE(Roman): The last byte of the object holds the length of a small string.
+    //               In heap mode it's the most significant byte of capacity, which has HeapFlag set.
+    static constexpr u64 SmallTag = SmallCapacity;
+    static constexpr u64 HeapFlag = 1ull << 63;
+
+    bool IsSmall() const { return !(static_cast<u8>(mSmall[SmallTag]) & 0x80); }
+
+    void InvalidateHash()
+    {
+#ifdef STRING_CACHED_HASH
+        mHash = 0;
+#endif
+    }
+
+    void TakeHash(String& other)
+    {
+#ifdef STRING_CACHED_HASH
+        mHash       = other.mHash;
+        other.mHash = 0;
+#else
+        (void)other;
+#endif
+    }
+
+    void SetLength(u64 length)
+    {
+        InvalidateHash();
+        if (IsSmall())
+        {
+            mSmall[SmallTag] = static_cast<char>(length);
+            mSmall[length]   = '\0';
+        }
+        else
+        {
+            mHeap.length       = length;
+            mHeap.data[length] = '\0';
+        }
+    }
+
+    char *Resize(u64 length);
+    char *Grow(u64 capacity);
+    char *Expand(u64 capacity);
+
+    static String Concat(Allocator *allocator, const char *left, u64 left_length, const char *right, u64 right_length);
+
+    String& AppendFormatItems(const char *text, const StringFormatItem *items, u32 item_count, u64 literal_length,
+                              const StringFormatArgument *arguments, u32 argument_count);
+
+    template<typename Left, typename Right>
+    friend class StringConcat;
+
+    struct Heap
+    {
+        char *data;
+        u64   length;
+        u64   capacity;
+    };
+
+    union
+    {
+        Heap mHeap;
+        char mSmall[sizeof(Heap)];
+    };
+
+    Allocator *mAllocator;
+#ifdef STRING_CACHED_HASH
+    mutable u64 mHash;
+#endif
 };
 
+// @NOTE(Roman): Appending fast paths. Growth and aliasing are handled out of line by Insert.
+inline String& String::PushBack(char symbol)
+{
+    u64 length = Length();
+    if (length + 1 < Capacity())
+    {
+        Data()[length] = symbol;
+        SetLength(length + 1);
+        return *this;
+    }
+    return Insert(length, symbol);
+}
+
+inline String& String::PushBack(const char *cstring, u64 cstring_length)
+{
+    u64 length = Length();
+    if (length + cstring_length < Capacity())
+    {
+        memcpy(Data() + length, cstring, cstring_length);
+        SetLength(length + cstring_length);
+        return *this;
+    }
+    return Insert(length, cstring, cstring_length);
+}
+
 inline bool operator==(const String& left, const String& right) { return !left.Compare(right); }
 inline bool operator==(const String& left, const char   *right) { return !left.Compare(right); }
 inline bool operator==(const char   *left, const String& right) { return !right.Compare(left); }
+inline bool operator==(StringView    left, StringView    right) { return !left.Compare(right); }
 
 inline bool operator!=(const String& left, const String& right) { return left.Compare(right); }
 inline bool operator!=(const String& left, const char   *right) { return left.Compare(right); }
 inline bool operator!=(const char   *left, const String& right) { return right.Compare(left); }
+inline bool operator!=(StringView    left, StringView    right) { return left.Compare(right); }
 
 inline bool operator<(const String& left, const String& right) { return left.Compare(right) < 0; }
 inline bool operator<(const String& left, const char   *right) { return left.Compare(right) < 0; }
 inline bool operator<(const char   *left, const String& right) { return right.Compare(left) > 0; }
+inline bool operator<(StringView    left, StringView    right) { return left.Compare(right) < 0; }
 
 inline bool operator<=(const String& left, const String& right) { return left.Compare(right) <= 0; }
 inline bool operator<=(const String& left, const char   *right) { return left.Compare(right) <= 0; }
 inline bool operator<=(const char   *left, const String& right) { return right.Compare(left) >= 0; }
+inline bool operator<=(StringView    left, StringView    right) { return left.Compare(right) <= 0; }
 
 inline bool operator>(const String& left, const String& right) { return left.Compare(right) > 0; }
 inline bool operator>(const String& left, const char   *right) { return left.Compare(right) > 0; }
 inline bool operator>(const char   *left, const String& right) { return right.Compare(left) < 0; }
+inline bool operator>(StringView    left, StringView    right) { return left.Compare(right) > 0; }
 
 inline bool operator>=(const String& left, const String& right) { return left.Compare(right) >= 0; }
 inline bool operator>=(const String& left, const char   *right) { return left.Compare(right) >= 0; }
 inline bool operator>=(const char   *left, const String& right) { return right.Compare(left) <= 0; }
+inline bool operator>=(StringView    left, StringView    right) { return left.Compare(right) >= 0; }
+
+namespace std
+{
+    template<>
+    struct hash<StringView>
+    {
+        size_t operator()(StringView view) const { return static_cast<size_t>(view.Hash()); }
+    };
 
-inline String operator+(const String&  left, const String&  right) { return String::Concat(          left,            right ); }
-inline String operator+(const String&  left,       String&& right) { return String::Concat(          left,  std::move(right)); }
-inline String operator+(const String&  left,       char     right) { return String::Concat(          left,            right ); }
-inline String operator+(const String&  left, const char    *right) { return String::Concat(          left,            right ); }
-inline String operator+(      String&& left, const String&  right) { return String::Concat(std::move(left),           right ); }
-inline String operator+(      String&& left,       char     right) { return String::Concat(std::move(left),           right ); }
-inline String operator+(      String&& left, const char    *right) { return String::Concat(std::move(left),           right ); }
-inline String operator+(      char     left, const String&  right) { return String::Concat(          left,            right ); }
-inline String operator+(      char     left,       String&& right) { return String::Concat(          left,  std::move(right)); }
-inline String operator+(const char    *left, const String&  right) { return String::Concat(          left,            right ); }
-inline String operator+(const char    *left,       String&& right) { return String::Concat(          left,  std::move(right)); }
+    template<>
+    struct hash<String>
+    {
+        size_t operator()(const String& string) const { return static_cast<size_t>(string.Hash()); }
+    };
+
+    template<>
+    struct hash<Symbol>
+    {
+        size_t operator()(Symbol symbol) const { return static_cast<size_t>(symbol.Hash()); }
+    };
+}
+
+// @NOTE(Roman): operator+ doesn't concatenate right away, it builds an expression of its operands instead.
+//               Converting the expression to String computes the total length once,
+//               allocates once and copies every operand once, so a + b + c + d has no intermediates.
+//               Operands are referenced, not copied, so the expression must be converted
+//               within the full expression it was created in: don't keep it in auto variables.
+//               The result uses the allocator of the leftmost String operand.
+//               Code written when operator+ returned String keeps working: (a + b).Find(c) and
+//               (a + b).SubString(from, to) convert first, (const char *)(a + b) points into a String
+//               the expression owns until the end of the full expression, like the temporary did.
+//               That String is a member of the expression and is built with the same allocator,
+//               so the cast costs the result's own allocation and nothing more, at most once.
+//               The conversion to const char * is explicit, passing a + b to a const char * parameter
+//               needs the cast, otherwise overloads taking both String and const char * would be ambiguous.
+class StringConcatPiece
+{
+public:
+    StringConcatPiece(const String& string)  : mData(string.Data()), mLength(string.Length()), mAllocator(string.GetAllocator()) {}
+    StringConcatPiece(StringView    view)    : mData(view.Data()),   mLength(view.Length()),   mAllocator(0)                     {}
+    StringConcatPiece(const char   *cstring) : mData(cstring),       mLength(strlen(cstring)), mAllocator(0)                     {}
+
+    u64        Length()       const { return mLength;    }
+    Allocator *GetAllocator() const { return mAllocator; }
+
+    char *CopyTo(char *dest) const
+    {
+        if (mLength) memcpy(dest, mData, mLength);
+        return dest + mLength;
+    }
+
+private:
+    const char *mData;
+    u64         mLength;
+    Allocator  *mAllocator;
+};
+
+class StringConcatSymbol
+{
+public:
+    StringConcatSymbol(char symbol) : mSymbol(symbol) {}
+
+    u64        Length()       const { return 1; }
+    Allocator *GetAllocator() const { return 0; }
+
+    char *CopyTo(char *dest) const
+    {
+        *dest = mSymbol;
+        return dest + 1;
+    }
+
+private:
+    char mSymbol;
+};
+
+template<typename Left, typename Right>
+class StringConcat
+{
+public:
+    StringConcat(const Left& left, const Right& right) : mLeft(left), mRight(right) {}
+    StringConcat(const StringConcat& other) : mLeft(other.mLeft), mRight(other.mRight) {}
+
+    StringConcat& operator=(const StringConcat& other) = delete;
+
+    u64 Length() const { return mLeft.Length() + mRight.Length(); }
+
+    Allocator *GetAllocator() const
+    {
+        Allocator *allocator = mLeft.GetAllocator();
+        return allocator ? allocator : mRight.GetAllocator();
+    }
+
+    char *CopyTo(char *dest) const
+    {
+        return mRight.CopyTo(mLeft.CopyTo(dest));
+    }
+
+    String ToString() const
+    {
+        Allocator *allocator = GetAllocator();
+        String     result    = allocator ? String(*allocator) : String();
+        CopyTo(result.Resize(Length()));
+        return result;
+    }
+
+    operator String() const { return ToString(); }
+
+    explicit operator const char *() const
+    {
+        if (!mString.Length() && Length()) mString = ToString();
+        return mString.Data();
+    }
+
+    template<typename... Args>
+    auto Find(const Args&... args) const { return ToString().Find(args...); }
+
+    String SubString(u64 from, u64 to) const { return ToString().SubString(from, to); }
+
+private:
+    Left           mLeft;
+    Right          mRight;
+    mutable String mString;
+};
+
+// @NOTE(Roman): Maps an operand type to the expression node that holds it.
+template<typename T> struct StringConcatOperand {};
+template<> struct StringConcatOperand<String>       { typedef StringConcatPiece  Type; };
+template<> struct StringConcatOperand<StringView>   { typedef StringConcatPiece  Type; };
+template<> struct StringConcatOperand<const char *> { typedef StringConcatPiece  Type; };
+template<> struct StringConcatOperand<char *>       { typedef StringConcatPiece  Type; };
+template<> struct StringConcatOperand<char>         { typedef StringConcatSymbol Type; };
+
+template<typename T>
+using StringConcatOperandType = typename StringConcatOperand<typename std::decay<T>::type>::Type;
+
+typedef StringConcat<StringConcatPiece,  StringConcatPiece>  StringConcatPieces;
+typedef StringConcat<StringConcatPiece,  StringConcatSymbol> StringConcatPieceSymbol;
+typedef StringConcat<StringConcatSymbol, StringConcatPiece>  StringConcatSymbolPiece;
+
+inline StringConcatPieces      operator+(const String& left, const String& right) { return StringConcatPieces(left, right);      }
+inline StringConcatPieceSymbol operator+(const String& left,       char    right) { return StringConcatPieceSymbol(left, right); }
+inline StringConcatPieces      operator+(const String& left, const char   *right) { return StringConcatPieces(left, right);      }
+inline StringConcatPieces      operator+(const String& left, StringView    right) { return StringConcatPieces(left, right);      }
+inline StringConcatSymbolPiece operator+(      char    left, const String& right) { return StringConcatSymbolPiece(left, right); }
+inline StringConcatPieces      operator+(const char   *left, const String& right) { return StringConcatPieces(left, right);      }
+inline StringConcatPieces      operator+(StringView    left, const String& right) { return StringConcatPieces(left, right);      }
+inline StringConcatPieces      operator+(StringView    left, StringView    right) { return StringConcatPieces(left, right);      }
+inline StringConcatPieceSymbol operator+(StringView    left,       char    right) { return StringConcatPieceSymbol(left, right); }
+inline StringConcatPieces      operator+(StringView    left, const char   *right) { return StringConcatPieces(left, right);      }
+inline StringConcatSymbolPiece operator+(      char    left, StringView    right) { return StringConcatSymbolPiece(left, right); }
+inline StringConcatPieces      operator+(const char   *left, StringView    right) { return StringConcatPieces(left, right);      }
+
+template<typename Left, typename Right, typename T>
+inline StringConcat<StringConcat<Left, Right>, StringConcatOperandType<T>> operator+(const StringConcat<Left, Right>& left, const T& right)
+{
+    return StringConcat<StringConcat<Left, Right>, StringConcatOperandType<T>>(left, right);
+}
+
+template<typename T, typename Left, typename Right>
+inline StringConcat<StringConcatOperandType<T>, StringConcat<Left, Right>> operator+(const T& left, const StringConcat<Left, Right>& right)
+{
+    return StringConcat<StringConcatOperandType<T>, StringConcat<Left, Right>>(left, right);
+}
+
+template<typename LeftLeft, typename LeftRight, typename RightLeft, typename RightRight>
+inline StringConcat<StringConcat<LeftLeft, LeftRight>, StringConcat<RightLeft, RightRight>> operator+(const StringConcat<LeftLeft, LeftRight>&   left,
+                                                                                                       const StringConcat<RightLeft, RightRight>& right)
+{
+    return StringConcat<StringConcat<LeftLeft, LeftRight>, StringConcat<RightLeft, RightRight>>(left, right);
+}
+
+// @NOTE(Roman): Format strings have to be literals wrapped into STRING_FORMAT, which makes a type of them,
+//               so AppendFormat can parse them in a constant expression, C++17 has no other way:
+//                   log.AppendFormat(STRING_FORMAT("{} took {} ms, status {}"), path, elapsed, status);
+//               {} takes the next argument, {{ and }} are literal braces. A stray brace, anything inside braces
+//               or a number of arguments that differs from the number of {} doesn't compile.
+//               Arguments are bool, char, integers, floats, written like AppendDouble does,
+//               and strings, views, symbols or C strings.
+#define STRING_FORMAT(literal)                                                                                 \
+    []()                                                                                                      \
+    {                                                                                                         \
+        struct FormatLiteral : StringFormatLiteral { static constexpr const char *Text() { return literal; } }; \
+        return FormatLiteral();                                                                               \
+    }()
+
+struct StringFormatLiteral {};
+
+// @NOTE(Roman): Literal text [offset, offset + length) of the format string or, with length Argument, the next argument.
+struct StringFormatItem
+{
+    static constexpr u32 Argument = ~0u;
+
+    u32 offset;
+    u32 length;
+};
+
+template<u64 Capacity>
+struct StringFormatProgram
+{
+    StringFormatItem items[Capacity] = {};
+    u32              count           = 0;
+    u32              arguments       = 0;
+    u64              literal_length  = 0;
+    bool             valid           = true;
+};
+
+constexpr u64 StringFormatLength(const char *text)
+{
+    u64 length = 0;
+    while (text[length]) ++length;
+    return length;
+}
+
+template<u64 Capacity>
+constexpr void AddStringFormatItem(StringFormatProgram<Capacity>& program, u32 offset, u32 length)
+{
+    if (!length) return;
+
+    program.items[program.count].offset = offset;
+    program.items[program.count].length = length;
+    ++program.count;
+
+    if (length == StringFormatItem::Argument) ++program.arguments;
+    else                                       program.literal_length += length;
+}
+
+// @NOTE(Roman): Every item takes at least one byte of the text, so Capacity of length + 1 is always enough.
+template<u64 Capacity>
+constexpr StringFormatProgram<Capacity> CompileStringFormat(const char *text)
+{
+    StringFormatProgram<Capacity> program;
+
+    u32 start = 0;
+    u32 i     = 0;
+
+    while (text[i])
+    {
+        if ((text[i] == '{' && text[i + 1] == '{') || (text[i] == '}' && text[i + 1] == '}'))
+        {
+            AddStringFormatItem(program, start, i + 1 - start);
+            i    += 2;
+            start = i;
+        }
+        else if (text[i] == '{' && text[i + 1] == '}')
+        {
+            AddStringFormatItem(program, start, i - start);
+            AddStringFormatItem(program, 0, StringFormatItem::Argument);
+            i    += 2;
+            start = i;
+        }
+        else if (text[i] == '{' || text[i] == '}')
+        {
+            program.valid = false;
+            return program;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    AddStringFormatItem(program, start, i - start);
+    return program;
+}
+
+// @NOTE(Roman): Argument with its type erased, so the formatting loop is not a template.
+class StringFormatArgument
+{
+public:
+    StringFormatArgument(bool          value) : mKind(Kind::Bool), mUInt(value)                                     {}
+    StringFormatArgument(char          value) : mKind(Kind::Char), mUInt(static_cast<u8>(value))                    {}
+    StringFormatArgument(const char   *value) : mKind(Kind::Text), mText(value),        mLength(strlen(value))      {}
+    StringFormatArgument(const String& value) : mKind(Kind::Text), mText(value.Data()), mLength(value.Length())     {}
+    StringFormatArgument(StringView    value) : mKind(Kind::Text), mText(value.Data()), mLength(value.Length())     {}
+
+    template<typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+    StringFormatArgument(T value) : mKind(Kind::Int), mInt(value) {}
+
+    template<typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, int>::type = 0>
+    StringFormatArgument(T value) : mKind(Kind::UInt), mUInt(value) {}
+
+    template<typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    StringFormatArgument(T value) : mKind(Kind::Double), mDouble(static_cast<double>(value)) {}
+
+private:
+    enum class Kind : u8
+    {
+        Bool,
+        Char,
+        Int,
+        UInt,
+        Double,
+        Text,
+    };
+
+    Kind mKind;
+    union
+    {
+        s64         mInt;
+        u64         mUInt;
+        double      mDouble;
+        const char *mText;
+    };
+    u64 mLength;
+
+    friend class String;
+};
+
+template<typename Literal, typename... Args>
+inline String& String::AppendFormat(Literal, const Args&... args)
+{
+    static_assert(std::is_base_of<StringFormatLiteral, Literal>::value, "Format string has to be wrapped into STRING_FORMAT");
+
+    static constexpr StringFormatProgram<StringFormatLength(Literal::Text()) + 1> program
+        = CompileStringFormat<StringFormatLength(Literal::Text()) + 1>(Literal::Text());
+
+    static_assert(program.valid,                          "Braces in a format string are either {}, {{ or }}");
+    static_assert(program.arguments == sizeof...(Args),   "Format string takes a different number of arguments");
+
+    const StringFormatArgument arguments[sizeof...(Args) + 1] = { StringFormatArgument(args)..., StringFormatArgument(false) };
+    return AppendFormatItems(Literal::Text(), program.items, program.count, program.literal_length, arguments, sizeof...(Args));
+}
+
+template<typename Literal, typename... Args>
+inline String String::Format(Literal format, const Args&... args)
+{
+    String result;
+    result.AppendFormat(format, args...);
+    return result;
+}
+
+// @NOTE(Roman): File mapped into memory. Pages are loaded lazily by the OS, so opening
+//               even a huge file is cheap, and scanning it costs no copies.
+//               ReadOnly mapping can't be written to, Private one is copy-on-write
+//               (changes are never written back), Shared one writes changes to the file.
+class MappedString
+{
+public:
+    enum class Mode : u8
+    {
+        ReadOnly,
+        Private,
+        Shared,
+    };
+
+    enum class Access : u8
+    {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed,
+    };
+
+    MappedString();
+    MappedString(const char *filename, Mode mode = Mode::ReadOnly, Access access = Access::Normal);
+    MappedString(MappedString&& other) noexcept;
+
+    ~MappedString();
+
+    // @NOTE(Roman): Returns false if the file couldn't be opened or mapped, previous mapping is unmapped anyway.
+    bool Map(const char *filename, Mode mode = Mode::ReadOnly, Access access = Access::Normal);
+    void Unmap();
+
+    // @NOTE(Roman): Hint to the OS how the pages are going to be accessed.
+    void Advise(Access access);
+
+    bool IsMapped() const { return mMapped; }
+
+    const char *Data()   const { return mData;   }
+          char *Data();
+    u64         Length() const { return mLength; }
+
+    operator StringView() const { return StringView(mData, mLength); }
+
+    StringView View()                 const { return StringView(mData, mLength);  }
+    StringView View(u64 from, u64 to) const { return View().SubString(from, to); }
+
+    s8   Compare(StringView other, CompareMode mode = CompareMode::LengthFirst) const { return View().Compare(other, mode); }
+    bool Equals(StringView other) const { return View().Equals(other); }
+
+    bool StartsWith(StringView prefix) const { return View().StartsWith(prefix); }
+    bool EndsWith(StringView suffix)   const { return View().EndsWith(suffix);   }
+
+    StringView Find(StringView string)                        const { return View().Find(string);            }
+    u64        FindIndex(StringView     string, u64 from = 0) const { return View().FindIndex(string, from); }
+    u64        FindIndex(char           symbol, u64 from = 0) const { return View().FindIndex(symbol, from); }
+    u64        FindIndex(const CharSet& set,    u64 from = 0) const { return View().FindIndex(set, from);    }
+
+    u64 FindIndexNotIn(const CharSet& set, u64 from = 0) const { return View().FindIndexNotIn(set, from); }
+
+    u64 FindLastIndex(StringView     string, u64 to = StringView::NotFound) const { return View().FindLastIndex(string, to); }
+    u64 FindLastIndex(char           symbol, u64 to = StringView::NotFound) const { return View().FindLastIndex(symbol, to); }
+    u64 FindLastIndex(const CharSet& set,    u64 to = StringView::NotFound) const { return View().FindLastIndex(set, to);    }
+
+    u64 FindAll(StringView string, u64 *offsets, u64 max_offsets) const { return View().FindAll(string, offsets, max_offsets); }
+    u64 Count(StringView string)                                   const { return View().Count(string);                         }
+    u64 Count(char symbol)                                         const { return View().Count(symbol);                         }
+    u64 Count(const CharSet& set)                                  const { return View().Count(set);                            }
+
+    u64 ParseInt(s64 *value)       const { return View().ParseInt(value);    }
+    u64 ParseUInt(u64 *value)      const { return View().ParseUInt(value);   }
+    u64 ParseDouble(double *value) const { return View().ParseDouble(value); }
+
+    bool IsValidUtf8()                            const { return View().IsValidUtf8();               }
+    u64  FindInvalidUtf8Index()                   const { return View().FindInvalidUtf8Index();      }
+    u64  CountCodePoints()                        const { return View().CountCodePoints();           }
+    u64  CodePointOffset(u64 index)               const { return View().CodePointOffset(index);      }
+    u64  CodePointStart(u64 offset)               const { return View().CodePointStart(offset);      }
+    u32  CodePointAt(u64 offset, u32 *length = 0) const { return View().CodePointAt(offset, length); }
+
+    u64 Utf16Length()                             const { return View().Utf16Length();               }
+    u64 Latin1Length()                            const { return View().Latin1Length();              }
+    u64 ToUtf16(u16 *out, u64 *error_index = 0)   const { return View().ToUtf16(out, error_index);   }
+    u64 ToLatin1(char *out, u64 *error_index = 0) const { return View().ToLatin1(out, error_index);  }
+
+    StringView SubString(u64 from, u64 to)           const { return View().SubString(from, to);           }
+    StringView SubStringCodePoints(u64 from, u64 to) const { return View().SubStringCodePoints(from, to); }
+
+    MappedString& operator=(MappedString&& other) noexcept;
+
+    MappedString(const MappedString&)            = delete;
+    MappedString& operator=(const MappedString&) = delete;
+
+private:
+    char *mData;
+    u64   mLength;
+    Mode  mMode;
+    bool  mMapped;
+#ifdef _WIN32
+    void *mFile;
+    void *mMapping;
+#endif
+};
+
+// @NOTE(Roman): Collects appended pieces into a list of chunks and never moves what's already written,
+//               so building a huge string costs one copy per byte instead of one per reallocation.
+//               Chunks grow geometrically from chunk_size up to MaxChunkSize.
+//               ToString materializes the result in a single exact allocation,
+//               WriteToFile streams chunks straight to the file without it.
+class StringBuilder
+{
+public:
+    static constexpr u64 DefaultChunkSize = 4 * 1024;
+    static constexpr u64 MaxChunkSize     = 16 * 1024 * 1024;
+
+    StringBuilder(u64 chunk_size = DefaultChunkSize);
+    explicit StringBuilder(Allocator& allocator, u64 chunk_size = DefaultChunkSize);
+    StringBuilder(StringBuilder&& other) noexcept;
+
+    ~StringBuilder();
+
+    // @NOTE(Roman): Keeps the first chunk for reuse.
+    StringBuilder& Clear();
+
+    u64 Length() const { return mLength; }
+
+    Allocator *GetAllocator() const { return mAllocator; }
+
+    StringBuilder& PushBack(const String& string)  { return PushBack(string.Data(), string.Length()); }
+    StringBuilder& PushBack(StringView    view)    { return PushBack(view.Data(),   view.Length());   }
+    StringBuilder& PushBack(const char   *cstring) { return PushBack(cstring, strlen(cstring));       }
+    StringBuilder& PushBack(      char    symbol);
+    StringBuilder& PushBack(const char   *cstring, u64 cstring_length);
+
+    String ToString() const;
+
+    const StringBuilder& WriteToFile(      int     unix_file, bool binary = false) const;
+    const StringBuilder& WriteToFile(      void   *win_file,  bool binary = false) const;
+    const StringBuilder& WriteToFile(      FILE   *crt_file,  bool binary = false) const;
+    const StringBuilder& WriteToFile(const char   *filename,  bool binary = false) const;
+    const StringBuilder& WriteToFile(const String& filename,  bool binary = false) const;
+
+    StringBuilder& operator+=(const String& right) { return PushBack(right); }
+    StringBuilder& operator+=(StringView    right) { return PushBack(right); }
+    StringBuilder& operator+=(      char    right) { return PushBack(right); }
+    StringBuilder& operator+=(const char   *right) { return PushBack(right); }
+
+    StringBuilder& operator=(StringBuilder&& other) noexcept;
+
+    StringBuilder(const StringBuilder&)            = delete;
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+private:
+    struct Chunk
+    {
+        Chunk *next;
+        u64    size;
+        u64    used;
+
+        char *Data() { return reinterpret_cast<char *>(this + 1); }
+    };
+
+    char *Append(u64 length);
+    void  FreeChunks(Chunk *chunk);
+
+    Chunk     *mHead;
+    Chunk     *mTail;
+    u64        mLength;
+    u64        mChunkSize;
+    Allocator *mAllocator;
+};
+
+// @NOTE(Roman): Compiled set of patterns that are searched for all at once, in a single pass over the text.
+//               Up to TeddyMaxPatterns patterns are found with a SIMD filter on their first bytes
+//               (Teddy: nibble lookups into 8 buckets of patterns) and verified with memcmp,
+//               larger sets go through an Aho-Corasick automaton over byte classes.
+//               Every occurrence is reported, overlapping ones too, with the id Add returned.
+//               Patterns must not be empty. Add after Compile requires another Compile.
+//               Searching is const and can run from many threads at once.
+class PatternSet
+{
+public:
+    static constexpr u32 TeddyMaxPatterns = 32;
+
+    enum class Engine : u8
+    {
+        Auto,
+        Teddy,
+        AhoCorasick,
+    };
+
+    struct Match
+    {
+        u64 offset;
+        u32 length;
+        u32 pattern;
+    };
+
+    // @NOTE(Roman): Return false to stop the search.
+    typedef bool (*Callback)(const Match& match, void *user_data);
+
+    PatternSet();
+    PatternSet(PatternSet&& other) noexcept;
+
+    ~PatternSet();
+
+    u32  Add(StringView pattern);
+    void Compile(Engine engine = Engine::Auto);
+    void Clear();
+
+    u32        Count()          const { return mCount;  }
+    // @NOTE(Roman): Auto until compiled.
+    Engine     CompiledEngine() const { return mEngine; }
+    StringView Pattern(u32 id)  const;
+
+    // @NOTE(Roman): Matches are reported in no particular order. Returns the number of reported matches.
+    u64 FindAll(StringView text, Callback callback, void *user_data) const;
+
+    // @NOTE(Roman): Writes first max_matches matches found, returns the number of all matches.
+    u64 FindAll(StringView text, Match *matches, u64 max_matches) const;
+
+    // @NOTE(Roman): Whether any pattern occurs in text. first gets the leftmost match,
+    //               of those starting at the same offset - the one with the lowest id.
+    bool FindAny(StringView text, Match *first = 0) const;
+
+    PatternSet& operator=(PatternSet&& other) noexcept;
+
+    PatternSet(const PatternSet&)            = delete;
+    PatternSet& operator=(const PatternSet&) = delete;
+
+private:
+    struct Entry
+    {
+        u64 offset;
+        u32 length;
+    };
+
+    struct Output
+    {
+        u32 pattern;
+        u32 next;
+    };
+
+    u64  Find(const char *text, u64 length, Callback callback, void *user_data, bool leftmost) const;
+    u64  FindTeddy(const char *text, u64 length, Callback callback, void *user_data, bool leftmost) const;
+    u64  FindAhoCorasick(const char *text, u64 length, Callback callback, void *user_data, bool leftmost) const;
+    bool ReportOutputs(u32 state, u64 end, Callback callback, void *user_data, u64 *reported, u64 *limit) const;
+
+    void CompileTeddy();
+    void CompileAhoCorasick();
+    void FreeCompiled();
+
+    String  mBytes;
+    Entry  *mPatterns;
+    u32     mCount;
+    u32     mCapacity;
+    u32     mMaxLength;
+    Engine  mEngine;
+
+    // @NOTE(Roman): Teddy. Tables are low and high nibble masks for each of 3 first bytes,
+    //               bucket b holds mBucketPatterns[mBucketStart[b]..mBucketStart[b + 1]).
+    u8   mTeddyTables[96];
+    u32  mBucketStart[9];
+    u32 *mBucketPatterns;
+
+    // @NOTE(Roman): Aho-Corasick. States are premultiplied by mClassCount, states below mMatchLimit have outputs.
+    u8      mClasses[256];
+    u32     mClassCount;
+    u32     mStateCount;
+    u32     mStart;
+    u32     mMatchLimit;
+    u32    *mTransitions;
+    u32    *mOutputHeads;
+    Output *mOutputs;
+};
@@ -0,0 +1,1534 @@
+//
+// Copyright 2020 Roman Skabin
+//
+
+// @NOTE(Roman): Standalone cross-checks against the C runtime and straightforward reference code,
+//               built like bench.cpp from this directory:
+//                   cl /O2 /std:c++17 /I.. test.cpp string.cpp
+//                   clang++ -O2 -std=c++17 -I.. test.cpp string.cpp -lpthread
+//
+//               Usage: test [scale]
+//               Inputs are random with fixed seeds, so every run checks the same cases, scale multiplies their count.
+//               Each check prints its first mismatches and a summary line, exit code is 1 if any of them failed.
+//               Kernels are picked by CPUID, run with STRING_ISA=scalar|sse|avx2|avx512 to check the other paths.
+
+#include "string/string.h"
+#include <algorithm>
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static constexpr u64 MaxPrinted = 10;
+
+static std::mt19937_64 gRandom;
+static u64             gScale = 1;
+static u64             gFailedChecks;
+
+static void Report(const char *check, u64 failures, u64 cases)
+{
+    printf("%-16s %-4s %llu of %llu cases failed\n", check, failures ? "FAIL" : "ok", failures, cases);
+    gFailedChecks += failures != 0;
+}
+
+static u64 Random(u64 bound)
+{
+    return gRandom() % bound;
+}
+
+static double RandomDouble()
+{
+    u64    bits  = gRandom();
+    double value = 0;
+    memcpy(&value, &bits, sizeof(double));
+    return value;
+}
+
+// @NOTE(Roman): Random bytes from the alphabet, small alphabets make matches and repeats likely.
+static std::string RandomText(u64 length, const char *alphabet)
+{
+    u64         alphabet_length = strlen(alphabet);
+    std::string text;
+
+    for (u64 i = 0; i < length; ++i) text += alphabet[Random(alphabet_length)];
+
+    return text;
+}
+
+static bool Same(StringView view, const std::string& reference)
+{
+    return view.Length() == reference.size() && (reference.empty() || !memcmp(view.Data(), reference.data(), reference.size()));
+}
+
+static void EncodeUtf8(std::string& out, u32 code_point)
+{
+    if (code_point < 0x80)
+    {
+        out += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        out += static_cast<char>(0xC0 | code_point >> 6);
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | code_point >> 12);
+        out += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | code_point >> 18);
+        out += static_cast<char>(0x80 | (code_point >> 12 & 0x3F));
+        out += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+// @NOTE(Roman): Mostly ASCII with every other encoded length mixed in, surrogates excluded.
+static u32 RandomCodePoint(bool ascii_only)
+{
+    u64 kind = Random(10);
+
+    if (ascii_only || kind < 5) return static_cast<u32>(Random(0x80));
+    if (kind < 7)               return static_cast<u32>(0x80 + Random(0x780));
+    if (kind == 9)              return static_cast<u32>(0x10000 + Random(0x100000));
+
+    u32 code_point = 0;
+    do code_point = static_cast<u32>(0x800 + Random(0xF800));
+    while (code_point >= 0xD800 && code_point <= 0xDFFF);
+
+    return code_point;
+}
+
+// @NOTE(Roman): Byte by byte validator straight from the Unicode well-formed UTF-8 table.
+static u64 ReferenceInvalidUtf8Index(const std::string& text)
+{
+    const unsigned char *bytes  = reinterpret_cast<const unsigned char *>(text.data());
+    u64                  length = text.size();
+
+    for (u64 i = 0; i < length;)
+    {
+        u32 lead = bytes[i];
+
+        if (lead < 0x80)
+        {
+            ++i;
+            continue;
+        }
+
+        u64 sequence_length = 0;
+        u32 low             = 0x80;
+        u32 high            = 0xBF;
+
+        if      (lead >= 0xC2 && lead <= 0xDF) { sequence_length = 2;              }
+        else if (lead == 0xE0)                 { sequence_length = 3; low  = 0xA0; }
+        else if (lead >= 0xE1 && lead <= 0xEC) { sequence_length = 3;              }
+        else if (lead == 0xED)                 { sequence_length = 3; high = 0x9F; }
+        else if (lead >= 0xEE && lead <= 0xEF) { sequence_length = 3;              }
+        else if (lead == 0xF0)                 { sequence_length = 4; low  = 0x90; }
+        else if (lead >= 0xF1 && lead <= 0xF3) { sequence_length = 4;              }
+        else if (lead == 0xF4)                 { sequence_length = 4; high = 0x8F; }
+        else                                   { return i;                         }
+
+        if (i + sequence_length > length)            return i;
+        if (bytes[i + 1] < low || bytes[i + 1] > high) return i;
+
+        for (u64 k = 2; k < sequence_length; ++k)
+        {
+            if ((bytes[i + k] & 0xC0) != 0x80) return i;
+        }
+
+        i += sequence_length;
+    }
+
+    return StringView::NotFound;
+}
+
+static bool SameTerminated(const String& string, const std::string& reference)
+{
+    return Same(string.View(), reference) && string.Data()[string.Length()] == '\0';
+}
+
+// @NOTE(Roman): Lengths hover around SmallCapacity, so edits keep crossing between the inline buffer and the heap.
+//               Contents must match std::string and stay null terminated, moved-from strings must be empty
+//               and new strings must be inline exactly when they fit.
+static void TestSmallStrings()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(1);
+
+    for (u64 i = 0; i < 100000 * gScale; ++i)
+    {
+        std::string reference = RandomText(Random(2 * String::SmallCapacity + 2), "xyz");
+        String      text(reference.data(), reference.size());
+
+        ++cases;
+        if ((text.Capacity() == String::SmallCapacity) != (reference.size() < String::SmallCapacity))
+        {
+            if (failures++ < MaxPrinted) printf("    string of %llu bytes has capacity %llu\n", static_cast<u64>(reference.size()), text.Capacity());
+        }
+
+        for (u64 step = 0; step < 8; ++step)
+        {
+            switch (Random(5))
+            {
+                case 0:
+                {
+                    std::string inserted = RandomText(Random(5), "xyz");
+                    u64         where    = Random(reference.size() + 1);
+                    text.Insert(where, inserted.data(), inserted.size());
+                    reference.insert(where, inserted);
+                } break;
+
+                case 1:
+                {
+                    u64 from = Random(reference.size() + 1);
+                    u64 to   = std::min<u64>(from + Random(5), reference.size());
+                    text.Erase(from, to);
+                    reference.erase(from, to - from);
+                } break;
+
+                case 2:
+                {
+                    char symbol = "xyz"[Random(3)];
+                    text.PushBack(symbol);
+                    reference += symbol;
+                } break;
+
+                case 3:
+                {
+                    String moved(std::move(text));
+
+                    ++cases;
+                    if (!SameTerminated(text, "") || !SameTerminated(moved, reference))
+                    {
+                        if (failures++ < MaxPrinted) printf("    move construction of %llu bytes left \"%s\" behind\n", static_cast<u64>(reference.size()), text.Data());
+                    }
+
+                    text = std::move(moved);
+                } break;
+
+                case 4:
+                {
+                    // @NOTE(Roman): Move assignment over a string that's inline or on the heap has to free the right one.
+                    String other(RandomText(Random(2 * String::SmallCapacity), "xyz").c_str());
+                    other = std::move(text);
+
+                    ++cases;
+                    if (!SameTerminated(text, ""))
+                    {
+                        if (failures++ < MaxPrinted) printf("    move assignment left \"%s\" behind\n", text.Data());
+                    }
+
+                    text = String(other);
+                } break;
+            }
+
+            ++cases;
+            if (!SameTerminated(text, reference))
+            {
+                if (failures++ < MaxPrinted) printf("    string is \"%s\", expected \"%s\"\n", text.Data(), reference.c_str());
+            }
+        }
+    }
+
+    Report("SmallStrings", failures, cases);
+}
+
+// @NOTE(Roman): FindIndex against std::string::find. Two-letter alphabets make periodic needles and near misses
+//               that stress the long-needle search, needles are often cut out of the haystack so they're found.
+static void TestFindIndex()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(4);
+
+    const char *alphabets[] = { "ab", "abc", "abcdefghijklmnopqrstuvwxyz" };
+
+    for (u64 i = 0; i < 100000 * gScale; ++i)
+    {
+        const char *alphabet = alphabets[Random(3)];
+        std::string haystack = RandomText(Random(i % 10 ? 100 : 2000), alphabet);
+        std::string needle   = RandomText(1 + Random(i % 3 ? 8 : 80), alphabet);
+
+        if (Random(2) && haystack.size() >= needle.size())
+        {
+            needle = haystack.substr(Random(haystack.size() - needle.size() + 1), needle.size());
+        }
+
+        StringView view(haystack.data(), haystack.size());
+        u64        from = Random(haystack.size() + 1);
+
+        u64 found[]    = { view.FindIndex(StringView(needle.data(), needle.size()), from),
+                           view.FindIndex(needle[0], from),
+                           view.FindIndex(CharSet(StringView(needle.data(), needle.size() < 4 ? needle.size() : 4)), from),
+                           view.FindIndexNotIn(CharSet(StringView(needle.data(), needle.size() < 4 ? needle.size() : 4)), from) };
+        u64 expected[] = { haystack.find(needle, from),
+                           haystack.find(needle[0], from),
+                           haystack.find_first_of(needle.substr(0, 4), from),
+                           haystack.find_first_not_of(needle.substr(0, 4), from) };
+
+        const char *names[] = { "FindIndex(string)", "FindIndex(char)", "FindIndex(set)", "FindIndexNotIn(set)" };
+
+        for (u64 k = 0; k < 4; ++k)
+        {
+            if (expected[k] == std::string::npos) expected[k] = StringView::NotFound;
+
+            ++cases;
+            if (found[k] != expected[k])
+            {
+                if (failures++ < MaxPrinted)
+                {
+                    printf("    %s of \"%s\" from %llu in %llu bytes gives %llu, expected %llu\n",
+                           names[k], needle.c_str(), from, static_cast<u64>(haystack.size()), found[k], expected[k]);
+                }
+            }
+        }
+
+        // @NOTE(Roman): No match is an empty view with null data.
+        u64         first         = haystack.find(needle);
+        StringView  match         = view.Find(StringView(needle.data(), needle.size()));
+        const char *expected_data = first == std::string::npos ? 0 : haystack.data() + first;
+
+        ++cases;
+        if (match.Data() != expected_data || match.Length() != (expected_data ? needle.size() : 0))
+        {
+            if (failures++ < MaxPrinted) printf("    Find of \"%s\" points at %p, expected %p\n", needle.c_str(), match.Data(), expected_data);
+        }
+    }
+
+    Report("FindIndex", failures, cases);
+}
+
+// @NOTE(Roman): Checks every Reallocate and Free against the blocks it handed out, with the same size,
+//               and forwards to the allocator under test.
+class TrackingAllocator : public Allocator
+{
+public:
+    TrackingAllocator(Allocator& allocator) : mAllocator(allocator), mErrors(0) {}
+
+    void *Allocate(u64 bytes) override
+    {
+        void *memory = mAllocator.Allocate(bytes);
+        mBlocks[memory] = bytes;
+        return memory;
+    }
+
+    void *Reallocate(void *memory, u64 old_bytes, u64 new_bytes) override
+    {
+        Forget(memory, old_bytes);
+        memory = mAllocator.Reallocate(memory, old_bytes, new_bytes);
+        mBlocks[memory] = new_bytes;
+        return memory;
+    }
+
+    void Free(void *memory, u64 bytes) override
+    {
+        Forget(memory, bytes);
+        mAllocator.Free(memory, bytes);
+    }
+
+    u64 Live()   const { return mBlocks.size(); }
+    u64 Errors() const { return mErrors;        }
+
+private:
+    void Forget(void *memory, u64 bytes)
+    {
+        auto it = mBlocks.find(memory);
+        if (it == mBlocks.end() || it->second != bytes) ++mErrors;
+        if (it != mBlocks.end()) mBlocks.erase(it);
+    }
+
+    Allocator&           mAllocator;
+    std::map<void *, u64> mBlocks;
+    u64                  mErrors;
+};
+
+// @NOTE(Roman): Strings on malloc, an arena and a pool are edited and mixed at random, contents are compared
+//               with std::string. Results must use the allocators the header promises, every block must go
+//               back to the allocator it came from with its size, and nothing may be left once the strings are gone.
+static void TestAllocators()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(7);
+
+    for (u64 i = 0; i < 2000 * gScale; ++i)
+    {
+        ArenaAllocator    arena(64 + Random(512));
+        PoolAllocator     pool(16 + Random(64), 1 + Random(8));
+        TrackingAllocator tracked_arena(arena);
+        TrackingAllocator tracked_pool(pool);
+        Allocator        *allocators[] = { 0, &tracked_arena, &tracked_pool };
+
+        {
+            static constexpr u64 Count = 4;
+
+            std::vector<String>      strings;
+            std::vector<std::string> references;
+
+            for (u64 k = 0; k < Count; ++k)
+            {
+                Allocator  *allocator = allocators[Random(3)];
+                std::string text      = RandomText(Random(40), "abc");
+
+                strings.push_back(allocator ? String(text.data(), text.size(), *allocator) : String(text.data(), text.size()));
+                references.push_back(text);
+            }
+
+            for (u64 step = 0; step < 40; ++step)
+            {
+                u64         a         = Random(Count);
+                u64         b         = Random(Count);
+                std::string text      = RandomText(Random(i % 10 ? 20 : 200), "abc");
+                Allocator  *expected  = strings[a].GetAllocator();
+                String      result;
+                std::string reference;
+                bool        has_result = true;
+
+                switch (Random(8))
+                {
+                    case 0:
+                    {
+                        strings[a].PushBack(text.data(), text.size());
+                        references[a] += text;
+                        has_result     = false;
+                    } break;
+
+                    case 1:
+                    {
+                        u64 where = Random(references[a].size() + 1);
+                        strings[a].Insert(where, text.data(), text.size());
+                        references[a].insert(where, text);
+                        has_result = false;
+                    } break;
+
+                    case 2:
+                    {
+                        u64 from = Random(references[a].size() + 1);
+                        u64 to   = from + Random(references[a].size() - from + 1);
+                        strings[a].Erase(from, to);
+                        references[a].erase(from, to - from);
+                        has_result = false;
+                    } break;
+
+                    case 3:
+                    {
+                        u64 from  = Random(references[a].size() + 1);
+                        u64 to    = from + Random(references[a].size() - from + 1);
+                        result    = strings[a].SubString(from, to);
+                        reference = references[a].substr(from, to - from);
+                    } break;
+
+                    case 4:
+                    {
+                        result    = String::Concat(strings[a], strings[b]);
+                        reference = references[a] + references[b];
+                    } break;
+
+                    case 5:
+                    {
+                        // @NOTE(Roman): Right is an rvalue with a buffer of its own, still the left allocator wins.
+                        result    = String::Concat(strings[a], String(strings[b]));
+                        reference = references[a] + references[b];
+                    } break;
+
+                    case 6:
+                    {
+                        result    = String::Concat(String(strings[a]), strings[b]);
+                        reference = references[a] + references[b];
+                    } break;
+
+                    case 7:
+                    {
+                        // @NOTE(Roman): Copy assignment keeps the target's allocator.
+                        Allocator *target_allocator = strings[b].GetAllocator();
+
+                        strings[b]    = strings[a];
+                        references[b] = references[a];
+                        has_result    = false;
+
+                        ++cases;
+                        if (strings[b].GetAllocator() != target_allocator)
+                        {
+                            if (failures++ < MaxPrinted) printf("    copy assignment moved the string to allocator %p from %p\n", strings[b].GetAllocator(), target_allocator);
+                        }
+                    } break;
+                }
+
+                ++cases;
+                if (has_result && (!Same(result.View(), reference) || result.GetAllocator() != expected))
+                {
+                    if (failures++ < MaxPrinted) printf("    result \"%s\" on allocator %p, expected \"%s\" on %p\n", result.Data(), result.GetAllocator(), reference.c_str(), expected);
+                }
+
+                // @NOTE(Roman): Results replace a random string, move assignment takes their allocator along.
+                if (has_result && Random(2))
+                {
+                    strings[b]    = std::move(result);
+                    references[b] = reference;
+                }
+
+                for (u64 k = 0; k < Count; ++k)
+                {
+                    ++cases;
+                    if (!Same(strings[k].View(), references[k]))
+                    {
+                        if (failures++ < MaxPrinted) printf("    string %llu is \"%s\", expected \"%s\"\n", k, strings[k].Data(), references[k].c_str());
+                    }
+                }
+            }
+        }
+
+        cases += 2;
+        for (TrackingAllocator *tracked : { &tracked_arena, &tracked_pool })
+        {
+            if (tracked->Errors() || tracked->Live())
+            {
+                if (failures++ < MaxPrinted) printf("    %llu blocks freed with a wrong size or by another allocator, %llu leaked\n", tracked->Errors(), tracked->Live());
+            }
+        }
+
+        arena.Reset();
+    }
+
+    Report("Allocators", failures, cases);
+}
+
+static std::string ReadWholeFile(const char *filename)
+{
+    std::string content;
+    FILE       *file = fopen(filename, "rb");
+
+    if (file)
+    {
+        char buffer[4096];
+        for (u64 read = 0; (read = fread(buffer, 1, sizeof(buffer), file)) > 0;) content.append(buffer, read);
+        fclose(file);
+    }
+
+    return content;
+}
+
+// @NOTE(Roman): Files of random sizes around page boundaries are mapped in every mode and compared with
+//               what was written. Writes through Private mappings must never reach the file, through Shared ones
+//               they must be there after Unmap. The file is only read back once it's unmapped.
+static void TestMappedString()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(8);
+
+    const char *filename = "string_test.tmp";
+    u64         sizes[]  = { 0, 1, 4095, 4096, 4097, 65536 };
+
+    for (u64 i = 0; i < 300 * gScale; ++i)
+    {
+        u64         size    = i < sizeof(sizes) / sizeof(*sizes) ? sizes[i] : Random(i % 10 ? 20000 : 300000);
+        std::string content = RandomText(size, "abc\n");
+
+        FILE *file = fopen(filename, "wb");
+        if (!file) break;
+        fwrite(content.data(), 1, content.size(), file);
+        fclose(file);
+
+        MappedString::Mode   mode   = static_cast<MappedString::Mode>(Random(3));
+        MappedString::Access access = static_cast<MappedString::Access>(Random(4));
+        MappedString         mapped(filename, mode, access);
+
+        ++cases;
+        if (!mapped.IsMapped() || !Same(mapped.View(), content) || mapped.Count('\n') != static_cast<u64>(std::count(content.begin(), content.end(), '\n')))
+        {
+            if (failures++ < MaxPrinted) printf("    mapping %llu bytes in mode %d doesn't match the file\n", size, static_cast<int>(mode));
+            continue;
+        }
+
+        std::string edited = content;
+
+        if (mode != MappedString::Mode::ReadOnly)
+        {
+            for (u64 k = size ? 1 + Random(8) : 0; k; --k)
+            {
+                u64 at = Random(size);
+                edited[at] = mapped.Data()[at] = 'x';
+            }
+        }
+
+        MappedString moved(std::move(mapped));
+
+        ++cases;
+        if (mapped.IsMapped() || mapped.Length() || !moved.IsMapped() || !Same(moved.View(), edited))
+        {
+            if (failures++ < MaxPrinted) printf("    moving a mapping of %llu bytes lost it\n", size);
+        }
+
+        moved.Unmap();
+
+        ++cases;
+        if (ReadWholeFile(filename) != (mode == MappedString::Mode::Shared ? edited : content))
+        {
+            if (failures++ < MaxPrinted) printf("    file of %llu bytes has the wrong content after unmapping mode %d\n", size, static_cast<int>(mode));
+        }
+    }
+
+    remove(filename);
+
+    MappedString missing;
+
+    ++cases;
+    if (missing.Map("string_test_missing.tmp") || missing.IsMapped())
+    {
+        if (failures++ < MaxPrinted) printf("    mapping a missing file succeeded\n");
+    }
+
+    Report("MappedString", failures, cases);
+}
+
+// @NOTE(Roman): Pieces as offsets into the text, matches are taken left to right and don't overlap,
+//               an empty delimiter never matches, so the whole text is the only piece.
+static std::vector<std::pair<u64, u64>> ReferenceSplit(const std::string& text, u64 delimiter_length, bool skip_empty,
+                                                       const std::function<bool(u64)>& matches_at)
+{
+    std::vector<std::pair<u64, u64>> pieces;
+    u64                              start = 0;
+
+    for (u64 i = 0; delimiter_length && i + delimiter_length <= text.size();)
+    {
+        if (!matches_at(i))
+        {
+            ++i;
+            continue;
+        }
+
+        if (!skip_empty || i > start) pieces.emplace_back(start, i);
+        i     += delimiter_length;
+        start  = i;
+    }
+
+    if (!skip_empty || text.size() > start) pieces.emplace_back(start, text.size());
+    return pieces;
+}
+
+// @NOTE(Roman): Split by a byte, a byte sequence and a set against ReferenceSplit. Texts cross several
+//               64-byte blocks and delimiters are dense, so pieces start and end everywhere inside a block.
+static void TestSplit()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(15);
+
+    for (u64 i = 0; i < 50000 * gScale; ++i)
+    {
+        std::string text       = RandomText(Random(i % 10 ? 80 : 400), Random(2) ? "ab," : "abcdefgh,;");
+        std::string delimiter  = RandomText(Random(4), "ab,;");
+        bool        skip_empty = Random(2);
+        StringView  view(text.data(), text.size());
+
+        for (u64 kind = 0; kind < 3; ++kind)
+        {
+            std::vector<std::pair<u64, u64>> expected;
+            std::vector<std::pair<u64, u64>> pieces;
+
+            auto collect = [&](const StringSplit& split)
+            {
+                for (StringView piece : split) pieces.emplace_back(piece.Data() - text.data(), piece.Data() - text.data() + piece.Length());
+            };
+
+            if (kind == 0)
+            {
+                char symbol = delimiter.empty() ? ',' : delimiter[0];
+                expected = ReferenceSplit(text, 1, skip_empty, [&](u64 at) { return text[at] == symbol; });
+                collect(view.Split(symbol, skip_empty));
+            }
+            else if (kind == 1)
+            {
+                expected = ReferenceSplit(text, delimiter.size(), skip_empty, [&](u64 at) { return !text.compare(at, delimiter.size(), delimiter); });
+                collect(view.Split(StringView(delimiter.data(), delimiter.size()), skip_empty));
+            }
+            else
+            {
+                CharSet set(StringView(delimiter.data(), delimiter.size()));
+                expected = ReferenceSplit(text, 1, skip_empty, [&](u64 at) { return delimiter.find(text[at]) != std::string::npos; });
+                collect(view.Split(set, skip_empty));
+            }
+
+            ++cases;
+            if (pieces != expected)
+            {
+                if (failures++ < MaxPrinted)
+                {
+                    printf("    split %llu of \"%s\" by \"%s\"%s gives %llu pieces, expected %llu\n", kind, text.c_str(), delimiter.c_str(),
+                           skip_empty ? " skipping empty" : "", static_cast<u64>(pieces.size()), static_cast<u64>(expected.size()));
+                }
+            }
+        }
+    }
+
+    Report("Split", failures, cases);
+}
+
+// @NOTE(Roman): Teddy and Aho-Corasick over the same patterns against a naive scan for every pattern at every offset.
+//               Patterns are short and drawn from a small alphabet, so they overlap, nest and repeat.
+static void TestPatternSet()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(16);
+
+    for (u64 i = 0; i < 5000 * gScale; ++i)
+    {
+        const char              *alphabet = Random(2) ? "abc" : "abcdefgh";
+        std::vector<std::string> patterns(1 + Random(40));
+        std::string              text     = RandomText(Random(i % 10 ? 100 : 500), alphabet);
+
+        for (std::string& pattern : patterns) pattern = RandomText(1 + Random(6), alphabet);
+
+        std::vector<std::tuple<u64, u32, u32>> expected;
+        for (u64 offset = 0; offset < text.size(); ++offset)
+        {
+            for (u32 id = 0; id < patterns.size(); ++id)
+            {
+                if (!text.compare(offset, patterns[id].size(), patterns[id])) expected.emplace_back(offset, id, static_cast<u32>(patterns[id].size()));
+            }
+        }
+
+        PatternSet set;
+        for (const std::string& pattern : patterns) set.Add(StringView(pattern.data(), pattern.size()));
+
+        for (PatternSet::Engine engine : { PatternSet::Engine::Teddy, PatternSet::Engine::AhoCorasick })
+        {
+            set.Compile(engine);
+
+            std::vector<PatternSet::Match> matches(expected.size() + 1);
+            u64                            count = set.FindAll(StringView(text.data(), text.size()), matches.data(), matches.size());
+
+            std::vector<std::tuple<u64, u32, u32>> found;
+            for (u64 j = 0; j < count && j < matches.size(); ++j) found.emplace_back(matches[j].offset, matches[j].pattern, matches[j].length);
+            std::sort(found.begin(), found.end());
+
+            PatternSet::Match first = {};
+            bool              any   = set.FindAny(StringView(text.data(), text.size()), &first);
+
+            ++cases;
+            if (count != expected.size() || found != expected
+            ||  any != !expected.empty()
+            ||  (any && (first.offset != std::get<0>(expected[0]) || first.pattern != std::get<1>(expected[0]))))
+            {
+                if (failures++ < MaxPrinted)
+                {
+                    printf("    %s over %llu patterns in \"%s\" finds %llu matches, expected %llu\n",
+                           engine == PatternSet::Engine::Teddy ? "Teddy" : "Aho-Corasick", static_cast<u64>(patterns.size()),
+                           text.c_str(), count, static_cast<u64>(expected.size()));
+                }
+            }
+        }
+    }
+
+    Report("PatternSet", failures, cases);
+}
+
+// @NOTE(Roman): ReplaceAll against std::string, replacements shorter than, as long as and longer than the needle,
+//               with and without spare capacity, so every way of assembling the result is taken. Needles and
+//               replacements sometimes view the string itself.
+static void TestReplaceAll()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(17);
+
+    for (u64 i = 0; i < 50000 * gScale; ++i)
+    {
+        const char *alphabet    = Random(2) ? "ab" : "abcd";
+        std::string text        = RandomText(Random(i % 10 ? 60 : 300), alphabet);
+        std::string needle      = RandomText(Random(4), alphabet);
+        std::string replacement = RandomText(Random(8), "xyab");
+
+        String string(text.data(), text.size());
+        if (Random(2)) string.Reserve(text.size() * (1 + Random(8)));
+
+        StringView needle_view(needle.data(), needle.size());
+        StringView replacement_view(replacement.data(), replacement.size());
+
+        if (Random(4) == 0 && text.size() >= needle.size())
+        {
+            u64 at      = Random(text.size() - needle.size() + 1);
+            needle      = text.substr(at, needle.size());
+            needle_view = StringView(string.Data() + at, needle.size());
+        }
+        if (Random(4) == 0 && text.size() >= replacement.size())
+        {
+            u64 at           = Random(text.size() - replacement.size() + 1);
+            replacement      = text.substr(at, replacement.size());
+            replacement_view = StringView(string.Data() + at, replacement.size());
+        }
+
+        std::string expected = text;
+        for (u64 at = needle.empty() ? std::string::npos : expected.find(needle); at != std::string::npos; at = expected.find(needle, at + replacement.size()))
+        {
+            expected.replace(at, needle.size(), replacement);
+        }
+
+        string.ReplaceAll(needle_view, replacement_view);
+
+        ++cases;
+        if (!SameTerminated(string, expected))
+        {
+            if (failures++ < MaxPrinted)
+            {
+                printf("    \"%s\" with \"%s\" replaced by \"%s\" gives \"%.*s\", expected \"%s\"\n", text.c_str(), needle.c_str(),
+                       replacement.c_str(), static_cast<int>(string.Length()), string.Data(), expected.c_str());
+            }
+        }
+
+        char   symbol = alphabet[Random(2)];
+        String chars(text.data(), text.size());
+
+        expected = text;
+        std::replace(expected.begin(), expected.end(), symbol, 'z');
+        chars.ReplaceAll(symbol, 'z');
+
+        ++cases;
+        if (!SameTerminated(chars, expected))
+        {
+            if (failures++ < MaxPrinted)
+            {
+                printf("    \"%s\" with '%c' replaced gives \"%.*s\", expected \"%s\"\n", text.c_str(), symbol,
+                       static_cast<int>(chars.Length()), chars.Data(), expected.c_str());
+            }
+        }
+    }
+
+    Report("ReplaceAll", failures, cases);
+}
+
+// @NOTE(Roman): FindAll and Count on haystacks around the default STRING_PARALLEL_THRESHOLD of 16 MiB, so the larger
+//               ones are split between the worker threads. Dense matches straddle every part boundary, the offsets
+//               must still come out in order, each once, and truncated to max_offsets.
+static void TestParallelFindAll()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(18);
+
+    const u64 threshold = 16ull << 20;
+
+    for (u64 i = 0; i < 8 * gScale; ++i)
+    {
+        u64         length = threshold - 2 + Random(i % 2 ? 3 : (3ull << 20));
+        bool        dense  = i % 4 < 2;
+        std::string chunk  = dense ? std::string("ab") : RandomText(4099 + Random(100), "abcdefghijklmnop");
+        std::string needle = dense ? std::string(i % 2 ? "aba" : "a") : RandomText(1 + Random(6), "abcdefghijklmnop");
+        std::string text;
+
+        text.reserve(length);
+        while (text.size() + chunk.size() <= length) text += chunk;
+        text += chunk.substr(0, length - text.size());
+
+        for (u64 k = 0; !dense && k < 1000; ++k) text.replace(Random(length - needle.size() + 1), needle.size(), needle);
+
+        std::vector<u64> expected;
+        for (u64 at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) expected.push_back(at);
+
+        StringView       view(text.data(), text.size());
+        u64              max_offsets = Random(2) ? expected.size() : Random(expected.size() + 1);
+        std::vector<u64> offsets(max_offsets);
+
+        u64 found = view.FindAll(StringView(needle.data(), needle.size()), offsets.data(), max_offsets);
+        u64 count = view.Count(StringView(needle.data(), needle.size()));
+
+        ++cases;
+        if (found != expected.size() || count != expected.size() || !std::equal(offsets.begin(), offsets.end(), expected.begin()))
+        {
+            if (failures++ < MaxPrinted)
+            {
+                printf("    \"%s\" in %llu bytes found %llu times, counted %llu, expected %llu\n", needle.c_str(), length, found,
+                       count, static_cast<u64>(expected.size()));
+            }
+        }
+
+        u64 symbols = std::count(text.begin(), text.end(), needle[0]);
+        u64 in_set  = 0;
+        for (char c : text) in_set += needle.find(c) != std::string::npos;
+
+        ++cases;
+        if (view.Count(needle[0]) != symbols || view.Count(CharSet(StringView(needle.data(), needle.size()))) != in_set)
+        {
+            if (failures++ < MaxPrinted) printf("    bytes of \"%s\" in %llu bytes miscounted\n", needle.c_str(), length);
+        }
+    }
+
+    Report("ParallelFindAll", failures, cases);
+}
+
+// @NOTE(Roman): AppendDouble has to round-trip through strtod and have as many significant digits as
+//               the shortest %.*e precision that round-trips too, integers and hex are compared with printf.
+static void TestFormatNumbers()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(21);
+
+    for (u64 i = 0; i < 200000 * gScale; ++i)
+    {
+        double value = 0;
+
+        switch (i % 4)
+        {
+            case 0: value = RandomDouble();                                                        break;
+            case 1: value = (static_cast<double>(Random(2000001)) - 1000000) / (1 + Random(1000)); break;
+            case 2: value = static_cast<double>(gRandom() >> Random(64));                          break;
+            case 3: value = ldexp(static_cast<double>(gRandom() >> 11), -1074 + static_cast<int>(Random(64))); break;
+        }
+
+        if (!std::isfinite(value) || value == 0) continue;
+
+        ++cases;
+
+        String formatted;
+        formatted.AppendDouble(value);
+
+        if (strtod(formatted, 0) != value)
+        {
+            if (failures++ < MaxPrinted) printf("    AppendDouble(%.17g) gives %s, doesn't round-trip\n", value, formatted.Data());
+            continue;
+        }
+
+        char reference[32];
+        for (int precision = 0; precision < 17; ++precision)
+        {
+            snprintf(reference, sizeof(reference), "%.*e", precision, fabs(value));
+            if (strtod(reference, 0) == fabs(value)) break;
+        }
+
+        u64 reference_digits = 0;
+        for (const char *it = reference; *it != 'e'; ++it) reference_digits += *it >= '0' && *it <= '9';
+
+        std::string digits;
+        for (const char *it = formatted; *it && *it != 'e'; ++it)
+        {
+            if (*it >= '0' && *it <= '9' && (!digits.empty() || *it != '0')) digits += *it;
+        }
+        while (digits.size() > 1 && digits.back() == '0') digits.pop_back();
+
+        if (digits.size() > reference_digits)
+        {
+            if (failures++ < MaxPrinted) printf("    AppendDouble(%.17g) gives %s, %s is shorter\n", value, formatted.Data(), reference);
+        }
+    }
+
+    const char *expected[][2] =
+    {
+        { "0.1",                    "0.1"                     },
+        { "2.5",                    "2.5"                     },
+        { "100",                    "100"                     },
+        { "123.25",                 "123.25"                  },
+        { "-0",                     "-0"                      },
+        { "0.000001",               "0.000001"                },
+        { "1e-7",                   "1e-7"                    },
+        { "1e20",                   "100000000000000000000"   },
+        { "1e21",                   "1e+21"                   },
+        { "5e-324",                 "5e-324"                  },
+        { "1.7976931348623157e308", "1.7976931348623157e+308" },
+        { "inf",                    "inf"                     },
+        { "-inf",                   "-inf"                    },
+        { "nan",                    "nan"                     },
+    };
+
+    for (auto& [input, output] : expected)
+    {
+        ++cases;
+
+        String formatted;
+        formatted.AppendDouble(strtod(input, 0));
+
+        if (formatted != output)
+        {
+            if (failures++ < MaxPrinted) printf("    AppendDouble(%s) gives %s, expected %s\n", input, formatted.Data(), output);
+        }
+    }
+
+    Report("AppendDouble", failures, cases);
+
+    failures = 0;
+    cases    = 0;
+
+    for (u64 i = 0; i < 100000 * gScale; ++i)
+    {
+        s64 value = static_cast<s64>(gRandom() >> Random(64));
+        if (Random(2)) value = -value;
+
+        if (i == 0) value = INT64_MIN;
+        if (i == 1) value = INT64_MAX;
+        if (i == 2) value = 0;
+
+        u64  unsigned_value = gRandom() >> Random(64);
+        u32  min_digits     = static_cast<u32>(Random(24));
+        bool uppercase      = i % 2;
+
+        char reference[3][48];
+        snprintf(reference[0], sizeof(reference[0]), "%lld", value);
+        snprintf(reference[1], sizeof(reference[1]), "%llu", unsigned_value);
+        snprintf(reference[2], sizeof(reference[2]), uppercase ? "%0*llX" : "%0*llx", static_cast<int>(min_digits), unsigned_value);
+
+        String formatted[3];
+        formatted[0].AppendInt(value);
+        formatted[1].AppendUInt(unsigned_value);
+        formatted[2].AppendHex(unsigned_value, min_digits, uppercase);
+
+        for (u64 k = 0; k < 3; ++k)
+        {
+            ++cases;
+
+            if (formatted[k] != static_cast<const char *>(reference[k]))
+            {
+                if (failures++ < MaxPrinted) printf("    gives %s, printf gives %s\n", formatted[k].Data(), reference[k]);
+            }
+        }
+    }
+
+    Report("AppendInt/Hex", failures, cases);
+}
+
+static void CheckParseDouble(const std::string& input, u64 *failures)
+{
+    double value    = 12345;
+    u64    consumed = StringView(input.data(), input.size()).ParseDouble(&value);
+
+    char  *end       = 0;
+    double reference = strtod(input.c_str(), &end);
+    u64    expected  = end - input.c_str();
+
+    bool same_value = !expected || !memcmp(&value, &reference, sizeof(double)) || (std::isnan(value) && std::isnan(reference));
+
+    if (consumed != expected || !same_value)
+    {
+        if ((*failures)++ < MaxPrinted)
+        {
+            printf("    ParseDouble(\"%s\") gives %llu %.17g, strtod gives %llu %.17g\n", input.c_str(), consumed, value, expected, reference);
+        }
+    }
+}
+
+// @NOTE(Roman): strtod is the reference for both the value and the number of bytes taken. Inputs never have
+//               leading spaces, hex floats or NaN payloads, those are the strtod extensions ParseDouble skips.
+static void TestParseNumbers()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(22);
+
+    const char *fixed[] =
+    {
+        "0", "-0", "1", "+1", "007", "1.5", "-12.5e3,x", ".5", "5.", "5.e3", "1e", "1e+", "e5", ".", "+.", "-", "",
+        "inf", "-Infinity", "nan", "infx", "infin",
+        "0.1", "1e23", "8.589973e9", "3.0000000000000004e-1", "1.0e-5",
+        "1e308", "1.7976931348623157e308", "1.7976931348623159e308", "2e308",
+        "4.9e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400",
+        "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "9007199254740993", "9007199254740992.5", "4503599627370496.5", "4503599627370497.5",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "123456789012345678901234567890", "00000000000000000000000000001.5",
+        "0.000000000000000000000000000000000000001",
+        "0.00000000000000000000000000000000000000000000000000000001e60",
+    };
+
+    for (const char *input : fixed)
+    {
+        ++cases;
+        CheckParseDouble(input, &failures);
+    }
+
+    for (u64 i = 0; i < 200000 * gScale; ++i)
+    {
+        std::string input;
+        char        buffer[80];
+        double      value = RandomDouble();
+
+        switch (i % 5)
+        {
+            case 0:
+            {
+                if (!std::isfinite(value)) continue;
+                snprintf(buffer, sizeof(buffer), "%.*g", static_cast<int>(1 + Random(17)), value);
+                input = buffer;
+            } break;
+
+            case 1:
+            {
+                // @NOTE(Roman): Digits past 17 still decide rounding near halfway points.
+                if (!std::isfinite(value)) continue;
+                snprintf(buffer, sizeof(buffer), "%.17e", value);
+                input = buffer;
+                for (u64 k = Random(30); k; --k) input.insert(input.find('e'), 1, static_cast<char>('0' + Random(10)));
+            } break;
+
+            case 2:
+            {
+                for (u64 k = 1 + Random(25); k; --k) input += static_cast<char>('0' + Random(10));
+                if (Random(2)) input.insert(Random(input.size()), 1, '.');
+                if (Random(2))
+                {
+                    input += 'e';
+                    if (Random(2)) input += Random(2) ? '-' : '+';
+                    for (u64 k = Random(4); k; --k) input += static_cast<char>('0' + Random(10));
+                }
+            } break;
+
+            case 3:
+            {
+                const char alphabet[] = "0123456789.eE+-";
+                for (u64 k = Random(12); k; --k) input += alphabet[Random(sizeof(alphabet) - 1)];
+            } break;
+
+            case 4:
+            {
+                // @NOTE(Roman): Halfway between two neighbouring doubles, with enough digits to be exact.
+                value = fabs(value);
+                if (!std::isfinite(value) || value == DBL_MAX) continue;
+                snprintf(buffer, sizeof(buffer), "%.40e", value + (nextafter(value, INFINITY) - value) / 2);
+                input = buffer;
+            } break;
+        }
+
+        if (!Random(4)) input.insert(0, 1, '-');
+
+        ++cases;
+        CheckParseDouble(input, &failures);
+    }
+
+    Report("ParseDouble", failures, cases);
+
+    failures = 0;
+    cases    = 0;
+
+    const char *fixed_integers[] =
+    {
+        "-9223372036854775808", "9223372036854775807", "9223372036854775808",
+        "18446744073709551615", "18446744073709551616", "00000000000000000000000018446744073709551615",
+    };
+
+    for (u64 i = 0; i < 200000 * gScale; ++i)
+    {
+        std::string input;
+
+        if (i < sizeof(fixed_integers) / sizeof(*fixed_integers))
+        {
+            input = fixed_integers[i];
+        }
+        else
+        {
+            if (!Random(3)) input += Random(2) ? '-' : '+';
+            for (u64 k = Random(24); k; --k) input += static_cast<char>('0' + Random(10));
+            if (!Random(3)) input += "922337203685477580" + std::to_string(7 + Random(3));
+            if (!Random(5)) input += "x1";
+        }
+
+        StringView view(input.data(), input.size());
+        char      *end = 0;
+
+        // @NOTE(Roman): Out of range is 0 bytes for ParseInt and ParseUInt, ERANGE for the C runtime.
+        s64 value     = 7;
+        u64 consumed  = view.ParseInt(&value);
+        errno         = 0;
+        s64 reference = strtoll(input.c_str(), &end, 10);
+        u64 expected  = errno == ERANGE ? 0 : end - input.c_str();
+
+        ++cases;
+        if (consumed != expected || (consumed && value != reference))
+        {
+            if (failures++ < MaxPrinted) printf("    ParseInt(\"%s\") gives %llu %lld, strtoll gives %llu %lld\n", input.c_str(), consumed, value, expected, reference);
+        }
+
+        // @NOTE(Roman): strtoull negates "-1" into 18446744073709551615, ParseUInt takes no minus at all.
+        if (input[0] == '-') continue;
+
+        u64 unsigned_value     = 7;
+        consumed               = view.ParseUInt(&unsigned_value);
+        errno                  = 0;
+        u64 unsigned_reference = strtoull(input.c_str(), &end, 10);
+        expected               = errno == ERANGE ? 0 : end - input.c_str();
+
+        ++cases;
+        if (consumed != expected || (consumed && unsigned_value != unsigned_reference))
+        {
+            if (failures++ < MaxPrinted) printf("    ParseUInt(\"%s\") gives %llu %llu, strtoull gives %llu %llu\n", input.c_str(), consumed, unsigned_value, expected, unsigned_reference);
+        }
+    }
+
+    Report("ParseInt/UInt", failures, cases);
+}
+
+// @NOTE(Roman): Arguments are often the string being appended to or views into it,
+//               AppendFormat has to read them before growing moves the buffer.
+static void TestFormat()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(23);
+
+    for (u64 i = 0; i < 50000 * gScale; ++i)
+    {
+        std::string reference = RandomText(Random(i % 10 ? 40 : 400), "abcdefghijklmnopqrstuvwxyz");
+        String      text(reference.data(), reference.size());
+
+        u64         from           = Random(reference.size() + 1);
+        u64         to             = from + Random(reference.size() - from + 1);
+        s64         number         = static_cast<s64>(gRandom()) >> Random(64);
+        StringView  part           = text.View(from, to);
+        std::string reference_part = reference.substr(from, to - from);
+
+        switch (i % 3)
+        {
+            case 0:
+            {
+                text.AppendFormat(STRING_FORMAT("[{}|{}]"), text, part);
+                reference += "[" + reference + "|" + reference_part + "]";
+            } break;
+
+            case 1:
+            {
+                text.AppendFormat(STRING_FORMAT("{} {} {}"), part, number, text.Data());
+                reference += reference_part + " " + std::to_string(number) + " " + reference;
+            } break;
+
+            case 2:
+            {
+                text.AppendFormat(STRING_FORMAT("{}{}{}{}"), text.View(), part, 'x', true);
+                reference += reference + reference_part + "xtrue";
+            } break;
+        }
+
+        ++cases;
+        if (!Same(text.View(), reference))
+        {
+            if (failures++ < MaxPrinted) printf("    AppendFormat gives \"%s\", expected \"%s\"\n", text.Data(), reference.c_str());
+        }
+    }
+
+    Report("AppendFormat", failures, cases);
+}
+
+// @NOTE(Roman): Random text, sometimes with a few bytes broken, checked against ReferenceInvalidUtf8Index.
+//               Offsets and counts of valid text are checked against the code points it was encoded from.
+static void TestUtf8()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(24);
+
+    for (u64 i = 0; i < 50000 * gScale; ++i)
+    {
+        std::string      text;
+        std::vector<u32> code_points;
+        std::vector<u64> offsets;
+
+        bool ascii_only = !Random(4);
+
+        for (u64 k = Random(i % 10 ? 80 : 400); k; --k)
+        {
+            code_points.push_back(RandomCodePoint(ascii_only));
+            offsets.push_back(text.size());
+            EncodeUtf8(text, code_points.back());
+        }
+
+        bool broken = Random(2) && !text.empty();
+
+        for (u64 k = broken ? 1 + Random(3) : 0; k && !text.empty(); --k)
+        {
+            u64 at = Random(text.size());
+
+            switch (Random(4))
+            {
+                case 0: text[at] = static_cast<char>(gRandom());               break;
+                case 1: text[at] = static_cast<char>(0x80 | Random(0x40));     break;
+                case 2: text.erase(at, 1);                                     break;
+                case 3: text.insert(at, 1, static_cast<char>(0xC0 + Random(0x40))); break;
+            }
+        }
+
+        StringView view(text.data(), text.size());
+        u64        expected = ReferenceInvalidUtf8Index(text);
+        u64        index    = view.FindInvalidUtf8Index();
+
+        ++cases;
+        if (index != expected || view.IsValidUtf8() != (expected == StringView::NotFound))
+        {
+            if (failures++ < MaxPrinted) printf("    FindInvalidUtf8Index of %llu bytes gives %llu, expected %llu\n", view.Length(), index, expected);
+        }
+
+        if (broken)
+        {
+            // @NOTE(Roman): Invalid text still counts every byte that isn't a continuation byte.
+            u64 lead_bytes = 0;
+            for (char symbol : text) lead_bytes += (symbol & 0xC0) != 0x80;
+
+            ++cases;
+            if (view.CountCodePoints() != lead_bytes)
+            {
+                if (failures++ < MaxPrinted) printf("    CountCodePoints of broken text gives %llu, expected %llu\n", view.CountCodePoints(), lead_bytes);
+            }
+            continue;
+        }
+
+        ++cases;
+        if (view.CountCodePoints() != code_points.size())
+        {
+            if (failures++ < MaxPrinted) printf("    CountCodePoints gives %llu, expected %llu\n", view.CountCodePoints(), static_cast<u64>(code_points.size()));
+        }
+
+        for (u64 k = 0; k <= code_points.size(); k += 1 + Random(7))
+        {
+            u64 offset          = view.CodePointOffset(k);
+            u64 expected_offset = k < code_points.size() ? offsets[k] : text.size();
+            u32 length          = 0;
+
+            ++cases;
+            if (offset != expected_offset)
+            {
+                if (failures++ < MaxPrinted) printf("    CodePointOffset(%llu) gives %llu, expected %llu\n", k, offset, expected_offset);
+            }
+            else if (k < code_points.size() && (view.CodePointAt(offset, &length) != code_points[k] || view.CodePointStart(offset + length - 1) != offset))
+            {
+                if (failures++ < MaxPrinted) printf("    CodePointAt/CodePointStart at %llu don't decode U+%04X\n", offset, code_points[k]);
+            }
+        }
+
+        ++cases;
+        if (view.CodePointOffset(code_points.size() + 1) != StringView::NotFound)
+        {
+            if (failures++ < MaxPrinted) printf("    CodePointOffset past the end isn't NotFound\n");
+        }
+    }
+
+    // @NOTE(Roman): Long enough for the wide kernels to run many blocks, broken in the middle of one.
+    std::string text;
+    for (u32 k = 0; k < 1000000; ++k)
+    {
+        u32 code_point = k * 7919 % 0x110000;
+        EncodeUtf8(text, code_point >= 0xD800 && code_point <= 0xDFFF ? 'A' : code_point);
+    }
+
+    StringView view(text.data(), text.size());
+
+    cases += 2;
+    if (!view.IsValidUtf8() || view.CountCodePoints() != 1000000)
+    {
+        if (failures++ < MaxPrinted) printf("    %llu bytes of valid text aren't valid or have %llu code points\n", view.Length(), view.CountCodePoints());
+    }
+
+    text[text.size() / 2 + 1] = static_cast<char>(0xFF);
+    if (view.FindInvalidUtf8Index() != ReferenceInvalidUtf8Index(text))
+    {
+        if (failures++ < MaxPrinted) printf("    FindInvalidUtf8Index of %llu bytes gives %llu, expected %llu\n", view.Length(), view.FindInvalidUtf8Index(), ReferenceInvalidUtf8Index(text));
+    }
+
+    Report("Utf8", failures, cases);
+}
+
+// @NOTE(Roman): Conversions are checked against code points decoded one at a time, error indices against
+//               the first code point that doesn't fit the target or the first invalid sequence.
+static void TestTranscode()
+{
+    u64 failures = 0;
+    u64 cases    = 0;
+
+    gRandom.seed(25);
+
+    for (u64 i = 0; i < 30000 * gScale; ++i)
+    {
+        std::string text;
+        u64         mode = Random(3);
+
+        for (u64 k = Random(i % 10 ? 90 : 600); k; --k)
+        {
+            EncodeUtf8(text, mode == 1 ? static_cast<u32>(Random(0x100)) : RandomCodePoint(mode == 0));
+        }
+
+        if (!Random(3) && !text.empty()) text[Random(text.size())] = static_cast<char>(gRandom());
+
+        StringView view(text.data(), text.size());
+        u64        invalid_index = ReferenceInvalidUtf8Index(text);
+        u64        valid_length  = invalid_index == StringView::NotFound ? text.size() : invalid_index;
+
+        std::vector<u32> code_points;
+        std::vector<u64> offsets;
+
+        for (u64 offset = 0; offset < valid_length;)
+        {
+            u32 length = 0;
+            offsets.push_back(offset);
+            code_points.push_back(view.CodePointAt(offset, &length));
+            offset += length;
+        }
+
+        std::vector<u16> utf16;
+        for (u32 code_point : code_points)
+        {
+            if (code_point < 0x10000)
+            {
+                utf16.push_back(static_cast<u16>(code_point));
+            }
+            else
+            {
+                utf16.push_back(static_cast<u16>(0xD800 | (code_point - 0x10000) >> 10));
+                utf16.push_back(static_cast<u16>(0xDC00 | ((code_point - 0x10000) & 0x3FF)));
+            }
+        }
+
+        {
+            std::vector<u16> out(view.Utf16Length() + 8);
+            u64              error_index = 0;
+            u64              written     = view.ToUtf16(out.data(), &error_index);
+
+            ++cases;
+            if (error_index != invalid_index || written != utf16.size() || !std::equal(utf16.begin(), utf16.end(), out.begin()))
+            {
+                if (failures++ < MaxPrinted) printf("    ToUtf16 wrote %llu stopping at %llu, expected %llu at %llu\n", written, error_index, static_cast<u64>(utf16.size()), invalid_index);
+            }
+
+            ++cases;
+            if (invalid_index == StringView::NotFound && view.Utf16Length() != utf16.size())
+            {
+                if (failures++ < MaxPrinted) printf("    Utf16Length gives %llu, expected %llu\n", view.Utf16Length(), static_cast<u64>(utf16.size()));
+            }
+        }
+
+        {
+            std::string latin1;
+            u64         latin1_error = invalid_index;
+
+            for (u64 k = 0; k < code_points.size(); ++k)
+            {
+                if (code_points[k] > 0xFF)
+                {
+                    latin1_error = offsets[k];
+                    break;
+                }
+                latin1 += static_cast<char>(code_points[k]);
+            }
+
+            std::vector<char> out(view.Latin1Length() + 1);
+            u64               error_index = 0;
+            u64               written     = view.ToLatin1(out.data(), &error_index);
+
+            ++cases;
+            if (error_index != latin1_error || written != latin1.size() || memcmp(out.data(), latin1.data(), written))
+            {
+                if (failures++ < MaxPrinted) printf("    ToLatin1 wrote %llu stopping at %llu, expected %llu at %llu\n", written, error_index, static_cast<u64>(latin1.size()), latin1_error);
+            }
+        }
+
+        {
+            std::string latin1;
+            for (u64 k = Random(i % 10 ? 100 : 700); k; --k) latin1 += static_cast<char>(Random(3) ? Random(0x80) : Random(0x100));
+
+            std::string utf8;
+            for (char symbol : latin1) EncodeUtf8(utf8, static_cast<unsigned char>(symbol));
+
+            String converted("x");
+            converted.AppendLatin1(latin1.data(), latin1.size());
+
+            ++cases;
+            if (String::Utf8LengthOfLatin1(latin1.data(), latin1.size()) != utf8.size() ||
+                converted.Length() != utf8.size() + 1 || memcmp(converted.Data() + 1, utf8.data(), utf8.size()))
+            {
+                if (failures++ < MaxPrinted) printf("    AppendLatin1 of %llu bytes gives %llu, expected %llu\n", static_cast<u64>(latin1.size()), converted.Length() - 1, static_cast<u64>(utf8.size()));
+            }
+        }
+
+        {
+            // @NOTE(Roman): A random surrogate somewhere is unpaired most of the time.
+            if (!Random(3) && !utf16.empty()) utf16[Random(utf16.size())] = static_cast<u16>(0xD800 + Random(0x800));
+
+            std::string utf8;
+            u64         unpaired_index = StringView::NotFound;
+
+            for (u64 k = 0; k < utf16.size(); ++k)
+            {
+                u32 unit = utf16[k];
+
+                if (unit < 0xD800 || unit > 0xDFFF)
+                {
+                    EncodeUtf8(utf8, unit);
+                }
+                else if (unit <= 0xDBFF && k + 1 < utf16.size() && utf16[k + 1] >= 0xDC00 && utf16[k + 1] <= 0xDFFF)
+                {
+                    EncodeUtf8(utf8, 0x10000 + ((unit - 0xD800) << 10) + (utf16[k + 1] - 0xDC00));
+                    ++k;
+                }
+                else
+                {
+                    unpaired_index = k;
+                    break;
+                }
+            }
+
+            String converted;
+            u64    error_index = 0;
+            converted.AppendUtf16(utf16.data(), utf16.size(), &error_index);
+
+            ++cases;
+            if (error_index != unpaired_index || converted.Length() != utf8.size() || memcmp(converted.Data(), utf8.data(), utf8.size()))
+            {
+                if (failures++ < MaxPrinted) printf("    AppendUtf16 gave %llu bytes stopping at %llu, expected %llu at %llu\n", converted.Length(), error_index, static_cast<u64>(utf8.size()), unpaired_index);
+            }
+
+            ++cases;
+            if (unpaired_index == StringView::NotFound && String::Utf8LengthOfUtf16(utf16.data(), utf16.size()) != utf8.size())
+            {
+                if (failures++ < MaxPrinted) printf("    Utf8LengthOfUtf16 gives %llu, expected %llu\n", String::Utf8LengthOfUtf16(utf16.data(), utf16.size()), static_cast<u64>(utf8.size()));
+            }
+        }
+    }
+
+    Report("Transcode", failures, cases);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+    {
+        gScale = strtoull(argv[1], 0, 10);
+        if (!gScale) gScale = 1;
+    }
+
+    printf("isa: %s\n", String::KernelISA());
+
+    TestSmallStrings();
+    TestFindIndex();
+    TestAllocators();
+    TestMappedString();
+    TestSplit();
+    TestPatternSet();
+    TestReplaceAll();
+    TestParallelFindAll();
+    TestFormatNumbers();
+    TestParseNumbers();
+    TestFormat();
+    TestUtf8();
+    TestTranscode();
+
+    return gFailedChecks != 0;
+}